@@ -0,0 +1,263 @@
+#include "AutoFormatSearch.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+#include "TextureQualityMetrics.h"
+#include "TileCompressionEngine.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr size_t BlockDimension { 4 };
+    constexpr size_t ProbeTileDimension { 64 };
+    constexpr size_t ProbeGridDimension { 4 };
+    constexpr float OpaqueAlphaThreshold { 1.0f - 1.0f / 512.0f };
+    constexpr float BinaryAlphaTolerance { 1.0f / 512.0f };
+    constexpr float RangeTolerance { 1.0f / 512.0f };
+
+    struct ProbeTraits {
+        bool HasAlpha;
+        bool HasBinaryAlpha;
+        bool HasNegative;
+        bool HasHighDynamicRange;
+    };
+
+    struct ProbeSpan {
+        size_t Extent;
+        size_t TileExtent;
+        size_t TileCount;
+    };
+
+    double ElapsedMilliseconds(std::chrono::steady_clock::time_point Start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    ProbeSpan SelectProbeSpan(size_t ImageExtent) {
+        if (ImageExtent <= ProbeTileDimension * ProbeGridDimension) {
+            return ProbeSpan { ImageExtent, ImageExtent, 1 };
+        }
+        return ProbeSpan { ImageExtent, ProbeTileDimension, ProbeGridDimension };
+    }
+
+    size_t GetProbeTileOffset(const ProbeSpan& Span, size_t TileIndex) {
+        if (Span.TileCount <= 1) {
+            return 0;
+        }
+        const size_t Offset { (Span.Extent - Span.TileExtent) * TileIndex / (Span.TileCount - 1) };
+        return Offset / BlockDimension * BlockDimension;
+    }
+
+    bool DecodeProbeSource(const TextureDocument& Document, ScratchImage& Storage, const Image*& SourceOut) {
+        if (Document.IsLazy()) {
+            const std::shared_ptr<const ScratchImage> Decoded { Document.AcquireSubresource(0, 0, 0) };
+            if (Decoded == nullptr || Decoded->GetImage(0, 0, 0) == nullptr || FAILED(Storage.InitializeFromImage(*Decoded->GetImage(0, 0, 0)))) {
+                return false;
+            }
+            SourceOut = Storage.GetImage(0, 0, 0);
+            return SourceOut != nullptr;
+        }
+        const TextureImageView Source { Document.GetSourceImage() };
+        if (Source.Images == nullptr || Source.ImageCount == 0) {
+            return false;
+        }
+        SourceOut = &Source.Images[Source.Metadata.ComputeIndex(0, 0, 0)];
+        if (!IsCompressed(SourceOut->format)) {
+            return true;
+        }
+        if (FAILED(Decompress(*SourceOut, DXGI_FORMAT_UNKNOWN, Storage))) {
+            return false;
+        }
+        SourceOut = Storage.GetImage(0, 0, 0);
+        return SourceOut != nullptr;
+    }
+
+    bool BuildProbeImage(const Image& Source, ScratchImage& ProbeOut) {
+        const ProbeSpan Columns { SelectProbeSpan(Source.width) };
+        const ProbeSpan Rows { SelectProbeSpan(Source.height) };
+        if (Columns.Extent == 0 || Rows.Extent == 0) {
+            return false;
+        }
+        if (FAILED(ProbeOut.Initialize2D(Source.format, Columns.TileExtent * Columns.TileCount, Rows.TileExtent * Rows.TileCount, 1, 1))) {
+            return false;
+        }
+        const Image& Probe { *ProbeOut.GetImage(0, 0, 0) };
+        for (size_t Row { 0 }; Row < Rows.TileCount; ++Row) {
+            for (size_t Column { 0 }; Column < Columns.TileCount; ++Column) {
+                const Rect SourceRect { GetProbeTileOffset(Columns, Column), GetProbeTileOffset(Rows, Row), Columns.TileExtent, Rows.TileExtent };
+                if (FAILED(CopyRectangle(Source, SourceRect, Probe, TEX_FILTER_DEFAULT, Column * Columns.TileExtent, Row * Rows.TileExtent))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool AnalyzeProbe(const Image& Probe, ProbeTraits& TraitsOut) {
+        ScratchImage Converted {};
+        const Image* Pixels { &Probe };
+        if (Probe.format != DXGI_FORMAT_R32G32B32A32_FLOAT) {
+            if (FAILED(Convert(Probe, DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Converted))) {
+                return false;
+            }
+            Pixels = Converted.GetImage(0, 0, 0);
+            if (Pixels == nullptr) {
+                return false;
+            }
+        }
+        TraitsOut = ProbeTraits { false, true, false, false };
+        for (size_t Y { 0 }; Y < Pixels->height; ++Y) {
+            const float* Row { reinterpret_cast<const float*>(Pixels->pixels + Y * Pixels->rowPitch) };
+            for (size_t X { 0 }; X < Pixels->width; ++X) {
+                const float* Texel { Row + X * 4 };
+                for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                    TraitsOut.HasNegative = TraitsOut.HasNegative || Texel[Channel] < -RangeTolerance;
+                    TraitsOut.HasHighDynamicRange = TraitsOut.HasHighDynamicRange || Texel[Channel] > 1.0f + RangeTolerance;
+                }
+                TraitsOut.HasAlpha = TraitsOut.HasAlpha || Texel[3] < OpaqueAlphaThreshold;
+                TraitsOut.HasBinaryAlpha = TraitsOut.HasBinaryAlpha && (Texel[3] <= BinaryAlphaTolerance || Texel[3] >= 1.0f - BinaryAlphaTolerance);
+            }
+        }
+        return true;
+    }
+
+    bool CanStoreNegative(DXGI_FORMAT Format) {
+        const FORMAT_TYPE Type { FormatDataType(Format) };
+        if (Type == FORMAT_TYPE_SNORM) {
+            return true;
+        }
+        return Type == FORMAT_TYPE_FLOAT && Format != DXGI_FORMAT_BC6H_UF16 && Format != DXGI_FORMAT_R11G11B10_FLOAT;
+    }
+
+    bool IsCandidateEligible(DXGI_FORMAT Format, const ProbeTraits& Traits) {
+        if (IsSRGB(Format)) {
+            return false;
+        }
+        const FORMAT_TYPE Type { FormatDataType(Format) };
+        if (Traits.HasNegative && !CanStoreNegative(Format)) {
+            return false;
+        }
+        if (!Traits.HasNegative && (Type == FORMAT_TYPE_SNORM || Format == DXGI_FORMAT_BC6H_SF16)) {
+            return false;
+        }
+        if (Traits.HasHighDynamicRange && Type != FORMAT_TYPE_FLOAT) {
+            return false;
+        }
+        if (Traits.HasAlpha && !HasAlpha(Format)) {
+            return false;
+        }
+        return !(Traits.HasAlpha && !Traits.HasBinaryAlpha && Format == DXGI_FORMAT_BC1_UNORM);
+    }
+
+    std::array<bool, 4> SelectEvaluatedChannels(const AnalyzerSettings& Settings, const ProbeTraits& Traits) {
+        return { true, true, !(Settings.IsNormalMap && Settings.ReconstructZ), Traits.HasAlpha };
+    }
+
+    bool EncodeProbeCandidate(const Image& Probe, const AnalyzerSettings& Settings, ScratchImage& EncodedOut) {
+        const DXGI_FORMAT TargetFormat { ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) };
+        if (Probe.format == TargetFormat) {
+            return SUCCEEDED(EncodedOut.InitializeFromImage(Probe));
+        }
+        if (!IsCompressed(TargetFormat)) {
+            return SUCCEEDED(Convert(Probe, TargetFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, EncodedOut));
+        }
+        const BlockEncoder& Encoder { ResolveBlockEncoder(Settings) };
+        const CompressOptions Options { BuildCompressFlags(Settings) & ~TEX_COMPRESS_PARALLEL, TEX_THRESHOLD_DEFAULT, Settings.AlphaWeight };
+        if (FAILED(EncodedOut.Initialize2D(TargetFormat, Probe.width, Probe.height, 1, 1))) {
+            return false;
+        }
+        return Encoder.EncodeImage(Probe, *EncodedOut.GetImage(0, 0, 0), Options, ResolveEncoderRefinementPasses(Settings), ResolveRdoLambda(Settings));
+    }
+
+    void EvaluateCandidate(const Image& Probe, const AnalyzerSettings& Settings, const std::array<bool, 4>& Channels, AutoFormatCandidate& Candidate) {
+        const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+        AnalyzerSettings CandidateSettings { Settings };
+        CandidateSettings.Format = Candidate.Format;
+        ScratchImage Encoded {};
+        MipQualityMetrics Metrics {};
+        Candidate.IsEncoded = EncodeProbeCandidate(Probe, CandidateSettings, Encoded) && ComputeMipQualityMetrics(Probe, *Encoded.GetImage(0, 0, 0), Metrics);
+        Candidate.EncodeMilliseconds = ElapsedMilliseconds(Start);
+        if (!Candidate.IsEncoded) {
+            return;
+        }
+        Candidate.Psnr = Metrics.Psnr[0];
+        Candidate.Ssim = Metrics.Ssim[0];
+        for (size_t Channel { 1 }; Channel < Channels.size(); ++Channel) {
+            if (Channels[Channel]) {
+                Candidate.Psnr = std::min(Candidate.Psnr, Metrics.Psnr[Channel]);
+                Candidate.Ssim = std::min(Candidate.Ssim, Metrics.Ssim[Channel]);
+            }
+        }
+        Candidate.MeetsTarget = Candidate.Psnr >= Settings.AutoFormatMinimumPsnr && Candidate.Ssim >= Settings.AutoFormatMinimumSsim;
+    }
+
+    const AutoFormatCandidate* SelectWinner(const std::vector<AutoFormatCandidate>& Candidates) {
+        const AutoFormatCandidate* Smallest { nullptr };
+        const AutoFormatCandidate* Sharpest { nullptr };
+        for (const AutoFormatCandidate& Candidate : Candidates) {
+            if (!Candidate.IsEncoded) {
+                continue;
+            }
+            if (Candidate.MeetsTarget && (Smallest == nullptr || Candidate.BitsPerPixel < Smallest->BitsPerPixel || (Candidate.BitsPerPixel == Smallest->BitsPerPixel && Candidate.Psnr > Smallest->Psnr))) {
+                Smallest = &Candidate;
+            }
+            if (Sharpest == nullptr || Candidate.Psnr > Sharpest->Psnr || (Candidate.Psnr == Sharpest->Psnr && Candidate.BitsPerPixel < Sharpest->BitsPerPixel)) {
+                Sharpest = &Candidate;
+            }
+        }
+        return Smallest != nullptr ? Smallest : Sharpest;
+    }
+}
+
+bool SearchAutoFormat(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job, AutoFormatSearchResult& ResultOut) {
+    const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+    ResultOut = AutoFormatSearchResult { Settings.Format, {}, false, 0, 0, 0.0, {} };
+    ScratchImage DecodedSource {};
+    const Image* Source { nullptr };
+    ScratchImage ProbeImage {};
+    ProbeTraits Traits {};
+    if (!DecodeProbeSource(Document, DecodedSource, Source) || !BuildProbeImage(*Source, ProbeImage) || !AnalyzeProbe(*ProbeImage.GetImage(0, 0, 0), Traits)) {
+        return false;
+    }
+    const Image& Probe { *ProbeImage.GetImage(0, 0, 0) };
+    ResultOut.ProbeWidth = Probe.width;
+    ResultOut.ProbeHeight = Probe.height;
+
+    for (const FormatOption& Option : BuildCompressionCandidateFormats()) {
+        if (IsCandidateEligible(Option.Format, Traits)) {
+            ResultOut.Candidates.push_back(AutoFormatCandidate { Option.Format, Option.Name, DirectX::BitsPerPixel(Option.Format), 0.0, 0.0, 0.0, false, false });
+        }
+    }
+    const std::array<bool, 4> Channels { SelectEvaluatedChannels(Settings, Traits) };
+    WorkStealingThreadPool Pool {};
+    Pool.Resize(static_cast<uint32_t>(std::min<size_t>(ResolveCompressionThreadCount(Settings), std::max<size_t>(ResultOut.Candidates.size(), 1))));
+    size_t StolenCount { 0 };
+    const bool Evaluated { Pool.Run(ResultOut.Candidates.size(), [&](size_t CandidateIndex, uint32_t) {
+        if (Job.IsCancelled()) {
+            return false;
+        }
+        EvaluateCandidate(Probe, Settings, Channels, ResultOut.Candidates[CandidateIndex]);
+        return true;
+    }, StolenCount) };
+    if (!Evaluated || Job.IsCancelled()) {
+        return false;
+    }
+
+    const AutoFormatCandidate* Winner { SelectWinner(ResultOut.Candidates) };
+    if (Winner == nullptr) {
+        return false;
+    }
+    ResultOut.Format = Winner->Format;
+    ResultOut.FormatName = Winner->Name;
+    ResultOut.MeetsTarget = Winner->MeetsTarget;
+    ResultOut.SearchMilliseconds = ElapsedMilliseconds(Start);
+    return true;
+}
+
+AnalyzerSettings ResolveAutoFormatSettings(const AnalyzerSettings& Settings, const AutoFormatSearchResult& Result) {
+    AnalyzerSettings Resolved { Settings };
+    Resolved.Format = Result.Format;
+    Resolved.AutoFormat = false;
+    return Resolved;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <DirectXTex.h>
+
+#include "TextureCompressionCore.h"
+
+struct AutoFormatCandidate {
+    DXGI_FORMAT Format;
+    std::string Name;
+    size_t BitsPerPixel;
+    double Psnr;
+    double Ssim;
+    double EncodeMilliseconds;
+    bool IsEncoded;
+    bool MeetsTarget;
+};
+
+struct AutoFormatSearchResult {
+    DXGI_FORMAT Format;
+    std::string FormatName;
+    bool MeetsTarget;
+    size_t ProbeWidth;
+    size_t ProbeHeight;
+    double SearchMilliseconds;
+    std::vector<AutoFormatCandidate> Candidates;
+};
+
+bool SearchAutoFormat(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job, AutoFormatSearchResult& ResultOut);
+AnalyzerSettings ResolveAutoFormatSettings(const AnalyzerSettings& Settings, const AutoFormatSearchResult& Result);
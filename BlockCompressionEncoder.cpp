@@ -0,0 +1,76 @@
+#include "BlockCompressionEncoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+    constexpr size_t BlockDimension { 4 };
+
+    bool SupportsDirectXTexFormat(DXGI_FORMAT Format) {
+        return IsCompressed(Format);
+    }
+
+    bool EncodeDirectXTexImage(const Image& Source, const Image& Destination, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda) {
+        (void)RefinementPasses;
+        (void)RdoLambda;
+        ScratchImage Encoded {};
+        const HRESULT CompressHr { CompressEx(Source, Destination.format, Options, Encoded) };
+        if (FAILED(CompressHr)) {
+            return false;
+        }
+
+        const Image* EncodedImage { Encoded.GetImage(0, 0, 0) };
+        if (EncodedImage == nullptr) {
+            return false;
+        }
+        const size_t CopyBytes { std::min(EncodedImage->rowPitch, Destination.rowPitch) };
+        const size_t BlockRows { (Source.height + BlockDimension - 1) / BlockDimension };
+        for (size_t Row { 0 }; Row < BlockRows; ++Row) {
+            memcpy(Destination.pixels + Row * Destination.rowPitch, EncodedImage->pixels + Row * EncodedImage->rowPitch, CopyBytes);
+        }
+        return true;
+    }
+}
+
+const BlockEncoder& GetDirectXTexBlockEncoder() {
+    static const BlockEncoder Encoder { BlockEncoderBackend::DirectXTex, "DirectXTex", SupportsDirectXTexFormat, EncodeDirectXTexImage };
+    return Encoder;
+}
+
+const BlockEncoder& SelectBlockEncoder(BlockEncoderBackend Preferred, DXGI_FORMAT Format) {
+    if (Preferred == BlockEncoderBackend::Native) {
+        for (const BlockEncoder* Encoder : { &GetNativeBlockEncoder(), &GetNativeBc7BlockEncoder(), &GetNativeBc6hBlockEncoder() }) {
+            if (Encoder->SupportsFormat(Format)) {
+                return *Encoder;
+            }
+        }
+    }
+    return GetDirectXTexBlockEncoder();
+}
+
+const char* GetBlockEncoderBackendName(BlockEncoderBackend Backend) {
+    switch (Backend) {
+    case BlockEncoderBackend::DirectXTex:
+        return "directxtex";
+    case BlockEncoderBackend::Native:
+        return "native";
+    default:
+        return "unknown";
+    }
+}
+
+bool ParseBlockEncoderBackend(const char* Name, BlockEncoderBackend& BackendOut) {
+    if (Name == nullptr) {
+        return false;
+    }
+    for (const BlockEncoderBackend Backend : { BlockEncoderBackend::DirectXTex, BlockEncoderBackend::Native }) {
+        if (strcmp(Name, GetBlockEncoderBackendName(Backend)) == 0) {
+            BackendOut = Backend;
+            return true;
+        }
+    }
+    return false;
+}
+
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXTex.h>
+
+enum class BlockEncoderBackend {
+    DirectXTex,
+    Native
+};
+
+struct BlockEncoder {
+    BlockEncoderBackend Backend;
+    const char* Name;
+    bool (*SupportsFormat)(DXGI_FORMAT Format);
+    bool (*EncodeImage)(const DirectX::Image& Source, const DirectX::Image& Destination, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda);
+};
+
+const BlockEncoder& GetDirectXTexBlockEncoder();
+const BlockEncoder& GetNativeBlockEncoder();
+const BlockEncoder& GetNativeBc7BlockEncoder();
+const BlockEncoder& GetNativeBc6hBlockEncoder();
+const BlockEncoder& SelectBlockEncoder(BlockEncoderBackend Preferred, DXGI_FORMAT Format);
+const char* GetBlockEncoderBackendName(BlockEncoderBackend Backend);
+bool ParseBlockEncoderBackend(const char* Name, BlockEncoderBackend& BackendOut);
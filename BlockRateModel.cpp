@@ -0,0 +1,84 @@
+#include "BlockRateModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr float LiteralBits { 8.0f };
+    constexpr float MatchBaseBits { 12.0f };
+    constexpr size_t MinimumMatchBytes { 3 };
+    constexpr size_t NoMatch { RdoHistoryCapacity };
+
+    bool ChunkMatches(const uint8_t* Block, const uint8_t* Previous, const RdoChunk& Chunk) {
+        for (size_t Byte { Chunk.Offset }; Byte < Chunk.Offset + Chunk.Size; ++Byte) {
+            if (Block[Byte] != Previous[Byte]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    float MatchBits(const RdoBlockHistory& History, size_t Age, size_t Bytes) {
+        const float Literal { static_cast<float>(Bytes) * LiteralBits };
+        if (Bytes < MinimumMatchBytes) {
+            return Literal;
+        }
+        const float Distance { static_cast<float>((Age + 1) * History.BlockBytes) };
+        return std::min(MatchBaseBits + std::log2(Distance), Literal);
+    }
+
+    size_t FindYoungestMatch(const RdoBlockHistory& History, const uint8_t* Block, const RdoChunk& Chunk) {
+        for (size_t Age { 0 }; Age < History.Count; ++Age) {
+            if (ChunkMatches(Block, GetRdoHistoryBlock(History, Age), Chunk)) {
+                return Age;
+            }
+        }
+        return NoMatch;
+    }
+}
+
+void ResetRdoHistory(RdoBlockHistory& History, size_t BlockBytes) {
+    History.BlockBytes = std::min(BlockBytes, RdoMaximumBlockBytes);
+    History.Count = 0;
+    History.Newest = RdoHistoryCapacity - 1;
+}
+
+void PushRdoHistory(RdoBlockHistory& History, const uint8_t* Block) {
+    History.Newest = (History.Newest + 1) % RdoHistoryCapacity;
+    memcpy(History.Blocks[History.Newest], Block, History.BlockBytes);
+    History.Count = std::min(History.Count + 1, RdoHistoryCapacity);
+}
+
+const uint8_t* GetRdoHistoryBlock(const RdoBlockHistory& History, size_t Age) {
+    return History.Blocks[(History.Newest + RdoHistoryCapacity - Age % RdoHistoryCapacity) % RdoHistoryCapacity];
+}
+
+float EstimateRdoMinimumRateBits(const RdoBlockHistory& History) {
+    return MatchBaseBits + std::log2(static_cast<float>(std::max<size_t>(History.BlockBytes, 1)));
+}
+
+float EstimateRdoRateBits(const RdoBlockHistory& History, const uint8_t* Block, const RdoChunk* Chunks, size_t ChunkCount) {
+    float Bits { 0.0f };
+    size_t RunAge { NoMatch };
+    size_t RunBytes { 0 };
+    for (size_t ChunkIndex { 0 }; ChunkIndex < ChunkCount; ++ChunkIndex) {
+        const RdoChunk& Chunk { Chunks[ChunkIndex] };
+        if (RunAge != NoMatch && ChunkMatches(Block, GetRdoHistoryBlock(History, RunAge), Chunk)) {
+            RunBytes += Chunk.Size;
+            continue;
+        }
+        if (RunAge != NoMatch) {
+            Bits += MatchBits(History, RunAge, RunBytes);
+        }
+        RunAge = FindYoungestMatch(History, Block, Chunk);
+        RunBytes = RunAge == NoMatch ? 0 : Chunk.Size;
+        if (RunAge == NoMatch) {
+            Bits += static_cast<float>(Chunk.Size) * LiteralBits;
+        }
+    }
+    if (RunAge != NoMatch) {
+        Bits += MatchBits(History, RunAge, RunBytes);
+    }
+    return Bits;
+}
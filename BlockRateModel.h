@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t RdoHistoryCapacity { 32 };
+constexpr size_t RdoMaximumBlockBytes { 16 };
+
+struct RdoChunk {
+    size_t Offset;
+    size_t Size;
+};
+
+struct RdoBlockHistory {
+    uint8_t Blocks[RdoHistoryCapacity][RdoMaximumBlockBytes];
+    size_t BlockBytes;
+    size_t Count;
+    size_t Newest;
+};
+
+void ResetRdoHistory(RdoBlockHistory& History, size_t BlockBytes);
+void PushRdoHistory(RdoBlockHistory& History, const uint8_t* Block);
+const uint8_t* GetRdoHistoryBlock(const RdoBlockHistory& History, size_t Age);
+float EstimateRdoMinimumRateBits(const RdoBlockHistory& History);
+float EstimateRdoRateBits(const RdoBlockHistory& History, const uint8_t* Block, const RdoChunk* Chunks, size_t ChunkCount);
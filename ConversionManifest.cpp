@@ -0,0 +1,148 @@
+#include "ConversionManifest.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+    constexpr const char* ManifestHeader { "# TextureBatchConverter manifest v1" };
+    constexpr char FieldSeparator { '\t' };
+}
+
+ConversionManifest::ConversionManifest() :
+    mMutex {},
+    mEntries {} {
+}
+
+ConversionManifest::~ConversionManifest() {
+}
+
+ConversionManifest::ConversionManifest(const ConversionManifest& Other) :
+    mMutex {},
+    mEntries {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mEntries = Other.mEntries;
+}
+
+ConversionManifest& ConversionManifest::operator=(const ConversionManifest& Other) {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mEntries = Other.mEntries;
+    }
+    return *this;
+}
+
+ConversionManifest::ConversionManifest(ConversionManifest&& Other) noexcept :
+    mMutex {},
+    mEntries {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mEntries = std::move(Other.mEntries);
+}
+
+ConversionManifest& ConversionManifest::operator=(ConversionManifest&& Other) noexcept {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mEntries = std::move(Other.mEntries);
+    }
+    return *this;
+}
+
+bool ConversionManifest::Load(const std::filesystem::path& ManifestPath) {
+    std::ifstream Stream { ManifestPath };
+    if (!Stream) {
+        return false;
+    }
+    std::unordered_map<std::string, ManifestEntry> Entries {};
+    std::string Line {};
+    while (std::getline(Stream, Line)) {
+        if (Line.empty() || Line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> Fields {};
+        std::istringstream LineStream { Line };
+        std::string Field {};
+        while (std::getline(LineStream, Field, FieldSeparator)) {
+            Fields.push_back(Field);
+        }
+        if (Fields.size() != 7) {
+            continue;
+        }
+        ManifestEntry Entry {};
+        Entry.SourcePath = Fields[0];
+        if (std::sscanf(Fields[1].c_str(), "%ju", &Entry.SourceSize) != 1 ||
+            std::sscanf(Fields[2].c_str(), "%" SCNd64, &Entry.SourceWriteTime) != 1 ||
+            std::sscanf(Fields[3].c_str(), "%" SCNx64, &Entry.ContentHash) != 1 ||
+            std::sscanf(Fields[4].c_str(), "%" SCNx64, &Entry.SettingsHash) != 1 ||
+            std::sscanf(Fields[5].c_str(), "%" SCNu32, &Entry.ToolVersion) != 1) {
+            continue;
+        }
+        Entry.OutputPath = Fields[6];
+        Entries[MakeKey(Entry.SourcePath)] = std::move(Entry);
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mEntries = std::move(Entries);
+    return true;
+}
+
+bool ConversionManifest::Save(const std::filesystem::path& ManifestPath) const {
+    std::vector<ManifestEntry> Entries {};
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        Entries.reserve(mEntries.size());
+        for (const auto& [Key, Entry] : mEntries) {
+            Entries.push_back(Entry);
+        }
+    }
+    std::sort(Entries.begin(), Entries.end(), [](const ManifestEntry& Left, const ManifestEntry& Right) { return Left.SourcePath < Right.SourcePath; });
+
+    std::error_code Error {};
+    if (ManifestPath.has_parent_path()) {
+        std::filesystem::create_directories(ManifestPath.parent_path(), Error);
+    }
+    std::filesystem::path TemporaryPath { ManifestPath };
+    TemporaryPath += ".tmp";
+    {
+        std::ofstream Stream { TemporaryPath, std::ios::trunc };
+        if (!Stream) {
+            return false;
+        }
+        Stream << ManifestHeader << '\n';
+        char Buffer[128] {};
+        for (const ManifestEntry& Entry : Entries) {
+            std::snprintf(Buffer, sizeof(Buffer), "%ju\t%" PRId64 "\t%016" PRIx64 "\t%016" PRIx64 "\t%" PRIu32, Entry.SourceSize, Entry.SourceWriteTime, Entry.ContentHash, Entry.SettingsHash, Entry.ToolVersion);
+            Stream << Entry.SourcePath.generic_string() << FieldSeparator << Buffer << FieldSeparator << Entry.OutputPath.generic_string() << '\n';
+        }
+        if (!Stream) {
+            return false;
+        }
+    }
+    std::filesystem::rename(TemporaryPath, ManifestPath, Error);
+    return !Error;
+}
+
+bool ConversionManifest::TryGet(const std::filesystem::path& SourcePath, ManifestEntry& EntryOut) const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    const auto Found { mEntries.find(MakeKey(SourcePath)) };
+    if (Found == mEntries.end()) {
+        return false;
+    }
+    EntryOut = Found->second;
+    return true;
+}
+
+void ConversionManifest::Update(const ManifestEntry& Entry) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mEntries[MakeKey(Entry.SourcePath)] = Entry;
+}
+
+size_t ConversionManifest::GetEntryCount() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mEntries.size();
+}
+
+std::string ConversionManifest::MakeKey(const std::filesystem::path& SourcePath) {
+    return SourcePath.lexically_normal().generic_string();
+}
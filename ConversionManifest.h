@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct ManifestEntry {
+    std::filesystem::path SourcePath;
+    uintmax_t SourceSize;
+    int64_t SourceWriteTime;
+    uint64_t ContentHash;
+    uint64_t SettingsHash;
+    uint32_t ToolVersion;
+    std::filesystem::path OutputPath;
+};
+
+class ConversionManifest {
+public:
+    ConversionManifest();
+    ~ConversionManifest();
+    ConversionManifest(const ConversionManifest& Other);
+    ConversionManifest& operator=(const ConversionManifest& Other);
+    ConversionManifest(ConversionManifest&& Other) noexcept;
+    ConversionManifest& operator=(ConversionManifest&& Other) noexcept;
+
+public:
+    bool Load(const std::filesystem::path& ManifestPath);
+    bool Save(const std::filesystem::path& ManifestPath) const;
+    bool TryGet(const std::filesystem::path& SourcePath, ManifestEntry& EntryOut) const;
+    void Update(const ManifestEntry& Entry);
+    size_t GetEntryCount() const;
+
+private:
+    static std::string MakeKey(const std::filesystem::path& SourcePath);
+
+private:
+    mutable std::mutex mMutex;
+    std::unordered_map<std::string, ManifestEntry> mEntries;
+};
@@ -41,23 +41,32 @@ ViewerApplication::ViewerApplication() :
     mFenceEvent {},
     mAnalyzer {},
     mUploader {},
-    mSettings { DXGI_FORMAT_BC7_UNORM, TEX_FILTER_FANT, true, false, false, false, CompressionQualityLevel::Normal, ChannelViewMode::Rgba, 1.0f },
+    mSettings { DXGI_FORMAT_BC7_UNORM, TEX_FILTER_FANT, true, false, false, false, CompressionQualityLevel::Normal, BlockEncoderBackend::DirectXTex, ChannelViewMode::Rgba, 1.0f, CompressionThreadingMode::Auto, 0, true, true, true, 0.0f, false, DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim },
     mFormatOptions {},
     mSelectedFormatIndex { 0 },
+    mDifferenceGain { DefaultDifferenceGain },
     mSourceTexture {},
     mSourceUpload {},
     mCompressedTexture {},
     mCompressedUpload {},
+    mDifferenceTexture {},
+    mDifferenceUpload {},
     mImGuiCpuHandle {},
     mImGuiGpuHandle {},
     mSourceCpuHandle {},
     mSourceGpuHandle {},
     mCompressedCpuHandle {},
     mCompressedGpuHandle {},
+    mDifferenceCpuHandle {},
+    mDifferenceGpuHandle {},
     mHasSourceTexture { false },
     mHasCompressedTexture { false },
+    mHasDifferenceTexture { false },
     mHasPendingDrop { false },
-    mPendingDropPath {} {
+    mPendingDropPath {},
+    mSourceMip { 0 },
+    mSourceItem { 0 },
+    mHasPendingSubresourceSelection { false } {
 }
 
 ViewerApplication::~ViewerApplication() {
@@ -87,20 +96,29 @@ ViewerApplication::ViewerApplication(const ViewerApplication& Other) :
     mSettings { Other.mSettings },
     mFormatOptions { Other.mFormatOptions },
     mSelectedFormatIndex { Other.mSelectedFormatIndex },
+    mDifferenceGain { Other.mDifferenceGain },
     mSourceTexture {},
     mSourceUpload {},
     mCompressedTexture {},
     mCompressedUpload {},
+    mDifferenceTexture {},
+    mDifferenceUpload {},
     mImGuiCpuHandle { Other.mImGuiCpuHandle },
     mImGuiGpuHandle { Other.mImGuiGpuHandle },
     mSourceCpuHandle { Other.mSourceCpuHandle },
     mSourceGpuHandle { Other.mSourceGpuHandle },
     mCompressedCpuHandle { Other.mCompressedCpuHandle },
     mCompressedGpuHandle { Other.mCompressedGpuHandle },
+    mDifferenceCpuHandle { Other.mDifferenceCpuHandle },
+    mDifferenceGpuHandle { Other.mDifferenceGpuHandle },
     mHasSourceTexture { Other.mHasSourceTexture },
     mHasCompressedTexture { Other.mHasCompressedTexture },
+    mHasDifferenceTexture { Other.mHasDifferenceTexture },
     mHasPendingDrop { Other.mHasPendingDrop },
-    mPendingDropPath { std::move(Other.mPendingDropPath) } {
+    mPendingDropPath { std::move(Other.mPendingDropPath) },
+    mSourceMip { Other.mSourceMip },
+    mSourceItem { Other.mSourceItem },
+    mHasPendingSubresourceSelection { Other.mHasPendingSubresourceSelection } {
     memcpy(mWindowClassName, Other.mWindowClassName, sizeof(mWindowClassName));
 }
 
@@ -117,16 +135,23 @@ ViewerApplication& ViewerApplication::operator=(const ViewerApplication& Other)
         mSettings = Other.mSettings;
         mFormatOptions = Other.mFormatOptions;
         mSelectedFormatIndex = Other.mSelectedFormatIndex;
+        mDifferenceGain = Other.mDifferenceGain;
         mImGuiCpuHandle = Other.mImGuiCpuHandle;
         mImGuiGpuHandle = Other.mImGuiGpuHandle;
         mSourceCpuHandle = Other.mSourceCpuHandle;
         mSourceGpuHandle = Other.mSourceGpuHandle;
         mCompressedCpuHandle = Other.mCompressedCpuHandle;
         mCompressedGpuHandle = Other.mCompressedGpuHandle;
+        mDifferenceCpuHandle = Other.mDifferenceCpuHandle;
+        mDifferenceGpuHandle = Other.mDifferenceGpuHandle;
         mHasSourceTexture = Other.mHasSourceTexture;
         mHasCompressedTexture = Other.mHasCompressedTexture;
+        mHasDifferenceTexture = Other.mHasDifferenceTexture;
         mHasPendingDrop = Other.mHasPendingDrop;
         mPendingDropPath = Other.mPendingDropPath;
+        mSourceMip = Other.mSourceMip;
+        mSourceItem = Other.mSourceItem;
+        mHasPendingSubresourceSelection = Other.mHasPendingSubresourceSelection;
     }
     return *this;
 }
@@ -153,24 +178,36 @@ ViewerApplication::ViewerApplication(ViewerApplication&& Other) noexcept :
     mSettings { Other.mSettings },
     mFormatOptions { std::move(Other.mFormatOptions) },
     mSelectedFormatIndex { Other.mSelectedFormatIndex },
+    mDifferenceGain { Other.mDifferenceGain },
     mSourceTexture { std::move(Other.mSourceTexture) },
     mSourceUpload { std::move(Other.mSourceUpload) },
     mCompressedTexture { std::move(Other.mCompressedTexture) },
     mCompressedUpload { std::move(Other.mCompressedUpload) },
+    mDifferenceTexture { std::move(Other.mDifferenceTexture) },
+    mDifferenceUpload { std::move(Other.mDifferenceUpload) },
     mImGuiCpuHandle { Other.mImGuiCpuHandle },
     mImGuiGpuHandle { Other.mImGuiGpuHandle },
     mSourceCpuHandle { Other.mSourceCpuHandle },
     mSourceGpuHandle { Other.mSourceGpuHandle },
     mCompressedCpuHandle { Other.mCompressedCpuHandle },
     mCompressedGpuHandle { Other.mCompressedGpuHandle },
+    mDifferenceCpuHandle { Other.mDifferenceCpuHandle },
+    mDifferenceGpuHandle { Other.mDifferenceGpuHandle },
     mHasSourceTexture { Other.mHasSourceTexture },
     mHasCompressedTexture { Other.mHasCompressedTexture },
+    mHasDifferenceTexture { Other.mHasDifferenceTexture },
     mHasPendingDrop { Other.mHasPendingDrop },
-    mPendingDropPath { std::move(Other.mPendingDropPath) } {
+    mPendingDropPath { std::move(Other.mPendingDropPath) },
+    mSourceMip { Other.mSourceMip },
+    mSourceItem { Other.mSourceItem },
+    mHasPendingSubresourceSelection { Other.mHasPendingSubresourceSelection } {
     memcpy(mWindowClassName, Other.mWindowClassName, sizeof(mWindowClassName));
     Other.mWindowHandle = nullptr;
     Other.mFenceEvent = nullptr;
     Other.mHasPendingDrop = false;
+    Other.mSourceMip = 0;
+    Other.mSourceItem = 0;
+    Other.mHasPendingSubresourceSelection = false;
 }
 
 ViewerApplication& ViewerApplication::operator=(ViewerApplication&& Other) noexcept {
@@ -196,23 +233,35 @@ ViewerApplication& ViewerApplication::operator=(ViewerApplication&& Other) noexc
         mSettings = Other.mSettings;
         mFormatOptions = std::move(Other.mFormatOptions);
         mSelectedFormatIndex = Other.mSelectedFormatIndex;
+        mDifferenceGain = Other.mDifferenceGain;
         mSourceTexture = std::move(Other.mSourceTexture);
         mSourceUpload = std::move(Other.mSourceUpload);
         mCompressedTexture = std::move(Other.mCompressedTexture);
         mCompressedUpload = std::move(Other.mCompressedUpload);
+        mDifferenceTexture = std::move(Other.mDifferenceTexture);
+        mDifferenceUpload = std::move(Other.mDifferenceUpload);
         mImGuiCpuHandle = Other.mImGuiCpuHandle;
         mImGuiGpuHandle = Other.mImGuiGpuHandle;
         mSourceCpuHandle = Other.mSourceCpuHandle;
         mSourceGpuHandle = Other.mSourceGpuHandle;
         mCompressedCpuHandle = Other.mCompressedCpuHandle;
         mCompressedGpuHandle = Other.mCompressedGpuHandle;
+        mDifferenceCpuHandle = Other.mDifferenceCpuHandle;
+        mDifferenceGpuHandle = Other.mDifferenceGpuHandle;
         mHasSourceTexture = Other.mHasSourceTexture;
         mHasCompressedTexture = Other.mHasCompressedTexture;
+        mHasDifferenceTexture = Other.mHasDifferenceTexture;
         mHasPendingDrop = Other.mHasPendingDrop;
         mPendingDropPath = std::move(Other.mPendingDropPath);
+        mSourceMip = Other.mSourceMip;
+        mSourceItem = Other.mSourceItem;
+        mHasPendingSubresourceSelection = Other.mHasPendingSubresourceSelection;
         Other.mWindowHandle = nullptr;
         Other.mFenceEvent = nullptr;
         Other.mHasPendingDrop = false;
+        Other.mSourceMip = 0;
+        Other.mSourceItem = 0;
+        Other.mHasPendingSubresourceSelection = false;
     }
     return *this;
 }
@@ -246,6 +295,8 @@ int ViewerApplication::Run() {
             break;
         }
         ProcessPendingDrop();
+        ProcessPendingSubresourceSelection();
+        ProcessCompletedPreview();
         if (!BeginFrame()) {
             continue;
         }
@@ -391,6 +442,10 @@ bool ViewerApplication::InitializeD3D12() {
     mCompressedCpuHandle.ptr += static_cast<SIZE_T>(SrvStep);
     mCompressedGpuHandle = mSourceGpuHandle;
     mCompressedGpuHandle.ptr += static_cast<UINT64>(SrvStep);
+    mDifferenceCpuHandle = mCompressedCpuHandle;
+    mDifferenceCpuHandle.ptr += static_cast<SIZE_T>(SrvStep);
+    mDifferenceGpuHandle = mCompressedGpuHandle;
+    mDifferenceGpuHandle.ptr += static_cast<UINT64>(SrvStep);
     return true;
 }
 
@@ -445,11 +500,49 @@ void ViewerApplication::RenderUi() {
         for (size_t Index { 0 }; Index < mFormatOptions.size(); ++Index) {
             FormatNames.push_back(mFormatOptions[Index].Name.c_str());
         }
+        FormatNames.push_back("Auto (smallest meeting target)");
         if (ImGui::Combo("Format", &mSelectedFormatIndex, FormatNames.data(), static_cast<int>(FormatNames.size()))) {
-            mSettings.Format = mFormatOptions[static_cast<size_t>(mSelectedFormatIndex)].Format;
+            mSettings.AutoFormat = static_cast<size_t>(mSelectedFormatIndex) == mFormatOptions.size();
+            if (!mSettings.AutoFormat) {
+                mSettings.Format = mFormatOptions[static_cast<size_t>(mSelectedFormatIndex)].Format;
+            }
             ApplySettingsAndRefreshPreview();
         }
     }
+    if (mSettings.AutoFormat) {
+        if (ImGui::SliderFloat("Auto PSNR Target (dB)", &mSettings.AutoFormatMinimumPsnr, 20.0f, 60.0f)) {
+            ApplySettingsAndRefreshPreview();
+        }
+        if (ImGui::SliderFloat("Auto SSIM Target", &mSettings.AutoFormatMinimumSsim, 0.5f, 1.0f)) {
+            ApplySettingsAndRefreshPreview();
+        }
+        const AutoFormatSearchResult AutoResult { mAnalyzer.GetAutoFormatResult() };
+        if (!AutoResult.Candidates.empty() && ImGui::BeginTable("AutoFormat", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            ImGui::TableSetupColumn("Candidate");
+            ImGui::TableSetupColumn("Bits/pixel");
+            ImGui::TableSetupColumn("Min PSNR (dB)");
+            ImGui::TableSetupColumn("Min SSIM");
+            ImGui::TableHeadersRow();
+            for (const AutoFormatCandidate& Candidate : AutoResult.Candidates) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s%s", Candidate.Name.c_str(), Candidate.Format == AutoResult.Format ? " *" : "");
+                ImGui::TableNextColumn();
+                ImGui::Text("%zu", Candidate.BitsPerPixel);
+                ImGui::TableNextColumn();
+                if (Candidate.IsEncoded) {
+                    ImGui::Text("%.2f", Candidate.Psnr);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.4f", Candidate.Ssim);
+                } else {
+                    ImGui::TextDisabled("encode failed");
+                    ImGui::TableNextColumn();
+                }
+            }
+            ImGui::EndTable();
+            ImGui::Text("Auto: %s%s from %zux%zu probe in %.1f ms", AutoResult.FormatName.c_str(), AutoResult.MeetsTarget ? "" : " (target not met)", AutoResult.ProbeWidth, AutoResult.ProbeHeight, AutoResult.SearchMilliseconds);
+        }
+    }
 
     const char* QualityItems[] { "Fast", "Normal", "Best" };
     int QualityIndex { static_cast<int>(mSettings.CompressionQuality) };
@@ -458,6 +551,19 @@ void ViewerApplication::RenderUi() {
         ApplySettingsAndRefreshPreview();
     }
 
+    const char* EncoderItems[] { "DirectXTex", "Native SIMD" };
+    int EncoderIndex { static_cast<int>(mSettings.EncoderBackend) };
+    if (ImGui::Combo("Encoder", &EncoderIndex, EncoderItems, 2)) {
+        mSettings.EncoderBackend = static_cast<BlockEncoderBackend>(EncoderIndex);
+        ApplySettingsAndRefreshPreview();
+    }
+    if (mSettings.EncoderBackend == BlockEncoderBackend::Native && ResolveBlockEncoder(mSettings).Backend != BlockEncoderBackend::Native) {
+        ImGui::TextDisabled("Native encoder does not support this format; using DirectXTex");
+    }
+    if (ResolveBlockEncoder(mSettings).Backend == BlockEncoderBackend::Native && ImGui::SliderFloat("RDO Lambda", &mSettings.RdoLambda, 0.0f, 20.0f)) {
+        ApplySettingsAndRefreshPreview();
+    }
+
     const char* MipItems[] { "Point", "Box", "Linear", "Fant", "Kaiser" };
     int MipIndex { 3 };
     if (mSettings.MipFilter == TEX_FILTER_POINT) {
@@ -510,11 +616,49 @@ void ViewerApplication::RenderUi() {
         ApplySettingsAndRefreshPreview();
     }
 
+    const char* ThreadingItems[] { "Off", "Auto", "Explicit" };
+    int ThreadingIndex { static_cast<int>(mSettings.Threading) };
+    if (ImGui::Combo("Threading", &ThreadingIndex, ThreadingItems, 3)) {
+        mSettings.Threading = static_cast<CompressionThreadingMode>(ThreadingIndex);
+        ApplySettingsAndRefreshPreview();
+    }
+    if (mSettings.Threading == CompressionThreadingMode::Explicit) {
+        int ThreadCount { static_cast<int>(std::max(1u, mSettings.ThreadCount)) };
+        if (ImGui::SliderInt("Thread Count", &ThreadCount, 1, 64)) {
+            mSettings.ThreadCount = static_cast<uint32_t>(ThreadCount);
+            ApplySettingsAndRefreshPreview();
+        }
+    }
+    if (ImGui::Checkbox("Tile Scheduler", &mSettings.UseTileScheduler)) {
+        ApplySettingsAndRefreshPreview();
+    }
+    if (ImGui::Checkbox("Progressive Preview", &mSettings.ProgressivePreview)) {
+        ApplySettingsAndRefreshPreview();
+    }
+    if (ImGui::Checkbox("Visible Region First", &mSettings.RegionOfInterestPreview)) {
+        ApplySettingsAndRefreshPreview();
+    }
+
     const char* ChannelItems[] { "RGBA", "R", "G", "B", "A", "Diff" };
     int ChannelIndex { static_cast<int>(mSettings.ChannelView) };
     if (ImGui::Combo("Channel", &ChannelIndex, ChannelItems, 6)) {
         mSettings.ChannelView = static_cast<ChannelViewMode>(ChannelIndex);
     }
+    if (mSettings.ChannelView == ChannelViewMode::Diff && ImGui::SliderFloat("Diff Gain", &mDifferenceGain, 1.0f, 64.0f, "%.0fx", ImGuiSliderFlags_Logarithmic)) {
+        mAnalyzer.SetDifferenceGain(mDifferenceGain);
+    }
+
+    if (mAnalyzer.IsSourceLazy()) {
+        const TexMetadata& FileMetadata { mAnalyzer.GetSourceFileMetadata() };
+        if (ImGui::SliderInt("Source Mip", &mSourceMip, 0, static_cast<int>(FileMetadata.mipLevels) - 1)) {
+            mHasPendingSubresourceSelection = true;
+        }
+        if (ImGui::SliderInt("Source Item", &mSourceItem, 0, static_cast<int>(FileMetadata.arraySize) - 1)) {
+            mHasPendingSubresourceSelection = true;
+        }
+        const ResultCacheStatistics PageStatistics { mAnalyzer.GetSourcePageStatistics() };
+        ImGui::Text("Source pages: %zu resident, %zu / %zu bytes", PageStatistics.EntryCount, PageStatistics.ResidentBytes, PageStatistics.BudgetBytes);
+    }
 
     if (ImGui::Button("Save as DDS")) {
         mAnalyzer.SaveCurrentAsDds();
@@ -523,44 +667,164 @@ void ViewerApplication::RenderUi() {
     const TextureMemoryMetrics Metrics { mAnalyzer.GetMetrics() };
     ImGui::Text("Source: %zu bytes", Metrics.SourceBytes);
     ImGui::Text("Compressed: %zu bytes", Metrics.CompressedBytes);
+    if (Metrics.PackagedBytes != 0) {
+        ImGui::Text("Packaged (deflate): %zu bytes", Metrics.PackagedBytes);
+    }
     ImGui::Text("Ratio: %.3f", Metrics.CompressionRatio);
+    const TextureQualityReport& QualityReport { mAnalyzer.GetQualityReport() };
+    if (!QualityReport.Mips.empty() && ImGui::BeginTable("Quality", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Mip");
+        ImGui::TableSetupColumn("PSNR R/G/B/A (dB)");
+        ImGui::TableSetupColumn("SSIM R/G/B/A");
+        ImGui::TableSetupColumn("MSE R/G/B/A");
+        ImGui::TableHeadersRow();
+        for (const MipQualityMetrics& Mip : QualityReport.Mips) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu (%zux%zu)", Mip.MipLevel, Mip.Width, Mip.Height);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f / %.2f / %.2f / %.2f", Mip.Psnr[0], Mip.Psnr[1], Mip.Psnr[2], Mip.Psnr[3]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.4f / %.4f / %.4f / %.4f", Mip.Ssim[0], Mip.Ssim[1], Mip.Ssim[2], Mip.Ssim[3]);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2e / %.2e / %.2e / %.2e", Mip.Mse[0], Mip.Mse[1], Mip.Mse[2], Mip.Mse[3]);
+        }
+        ImGui::EndTable();
+        ImGui::Text("Quality metrics: %.1f ms (%s)", QualityReport.ComputeMilliseconds, GetSimdInstructionSetName(QualityReport.InstructionSet));
+        const MipQualityMetrics& BaseMip { QualityReport.Mips.front() };
+        std::array<float, 64> ErrorBins {};
+        for (size_t Bin { 0 }; Bin < ErrorBins.size(); ++Bin) {
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                ErrorBins[Bin] += static_cast<float>(BaseMip.ErrorHistogram[Channel * ErrorHistogramBinCount + Bin]);
+            }
+        }
+        ImGui::PlotHistogram("RGB error (mip 0)", ErrorBins.data(), static_cast<int>(ErrorBins.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2 { 0.0f, 60.0f });
+    }
+    if (mAnalyzer.IsQualityPending()) {
+        ImGui::Text("Evaluating quality...");
+    }
+    const CompressionTimings Timings { mAnalyzer.GetLastCompressionTimings() };
+    if (Timings.ResultCacheHit) {
+        ImGui::Text("Timing: result cache hit");
+    } else if (Timings.DiskCacheHit) {
+        ImGui::Text("Timing: disk cache hit");
+    } else {
+        ImGui::Text("Timing: decode %.1f ms, mips %.1f ms, compress %.1f ms (%u threads)", Timings.DecodeMilliseconds, Timings.MipMilliseconds, Timings.CompressMilliseconds, Timings.ThreadCount);
+    }
+    if (Timings.TileCount > 0) {
+        ImGui::Text("Tiles: %zu (%zu stolen), slowest %.2f ms", Timings.TileCount, Timings.StolenTileCount, Timings.SlowestTileMilliseconds);
+    }
+    ImGui::Text("Skipped rebuilds: %llu", static_cast<unsigned long long>(mAnalyzer.GetSkippedRebuildCount()));
+    const ResultCacheStatistics CacheStatistics { mAnalyzer.GetResultCacheStatistics() };
+    ImGui::Text("Result cache: %llu hits / %llu misses / %llu evictions", static_cast<unsigned long long>(CacheStatistics.Hits), static_cast<unsigned long long>(CacheStatistics.Misses), static_cast<unsigned long long>(CacheStatistics.Evictions));
+    ImGui::Text("Result cache: %zu entries, %zu / %zu bytes", CacheStatistics.EntryCount, CacheStatistics.ResidentBytes, CacheStatistics.BudgetBytes);
+    const ResultCacheStatistics DiskStatistics { mAnalyzer.GetDiskCacheStatistics() };
+    ImGui::Text("Disk cache: %llu hits / %llu misses, %zu entries, %zu / %zu bytes", static_cast<unsigned long long>(DiskStatistics.Hits), static_cast<unsigned long long>(DiskStatistics.Misses), DiskStatistics.EntryCount, DiskStatistics.ResidentBytes, DiskStatistics.BudgetBytes);
+    if (mAnalyzer.IsPreviewRefining()) {
+        ImGui::Text("Refining quick preview...");
+    } else if (mAnalyzer.IsCompressionPending()) {
+        ImGui::Text("Compressing...");
+    }
     ImGui::End();
 
     ImGui::Begin("Comparison");
     const ImVec2 Region { ImGui::GetContentRegionAvail() };
     const float HalfWidth { std::max(10.0f, Region.x * 0.5f - 6.0f) };
+    const float ImageHeight { std::max(10.0f, Region.y - ImGui::GetTextLineHeightWithSpacing()) };
+    const ImVec2 PanelOrigin { ImGui::GetCursorScreenPos() };
     const SyncViewportState& Viewport { mAnalyzer.GetViewportState() };
+    mAnalyzer.SetViewportPanelSize(XMFLOAT2 { HalfWidth, ImageHeight });
 
+    const ImVec2 MousePos { ImGui::GetMousePos() };
+    float PanelMouseX { MousePos.x - PanelOrigin.x };
+    if (PanelMouseX > HalfWidth) {
+        PanelMouseX -= HalfWidth + ImGui::GetStyle().ItemSpacing.x;
+    }
+    const XMFLOAT2 PanelMouse { PanelMouseX, MousePos.y - PanelOrigin.y - ImGui::GetTextLineHeightWithSpacing() };
     if (ImGui::IsWindowHovered() && ImGui::GetIO().MouseWheel != 0.0f) {
-        const ImVec2 MousePos { ImGui::GetMousePos() };
-        mAnalyzer.HandleZoom(ImGui::GetIO().MouseWheel, XMFLOAT2 { MousePos.x, MousePos.y });
+        mAnalyzer.HandleZoom(ImGui::GetIO().MouseWheel, PanelMouse);
     }
 
     if (ImGui::IsWindowHovered() && ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
-        const ImVec2 MousePos { ImGui::GetMousePos() };
         if (!Viewport.IsPanning) {
-            mAnalyzer.BeginPan(XMFLOAT2 { MousePos.x, MousePos.y });
+            mAnalyzer.BeginPan(PanelMouse);
         }
-        mAnalyzer.UpdatePan(XMFLOAT2 { MousePos.x, MousePos.y });
+        mAnalyzer.UpdatePan(PanelMouse);
     }
     if (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
         mAnalyzer.EndPan();
     }
 
-    const ImVec2 DrawSize { HalfWidth * Viewport.Zoom, Region.y * Viewport.Zoom };
+    const ImVec2 DrawSize { HalfWidth, ImageHeight };
+    const ViewportUvRect UvRect { ComputeViewportUvRect(Viewport) };
+    const ImVec2 UvMin { UvRect.Min.x, UvRect.Min.y };
+    const ImVec2 UvMax { UvRect.Max.x, UvRect.Max.y };
+    ImGui::BeginGroup();
     ImGui::Text("Original");
     if (mHasSourceTexture) {
-        ImGui::Image(reinterpret_cast<ImTextureID>(mSourceGpuHandle.ptr), DrawSize);
+        ImGui::Image(reinterpret_cast<ImTextureID>(mSourceGpuHandle.ptr), DrawSize, UvMin, UvMax);
     } else {
         ImGui::Dummy(DrawSize);
     }
+    ImGui::EndGroup();
     ImGui::SameLine();
-    ImGui::Text("Compressed");
-    if (mHasCompressedTexture) {
-        ImGui::Image(reinterpret_cast<ImTextureID>(mCompressedGpuHandle.ptr), DrawSize);
+    ImGui::BeginGroup();
+    const bool ShowDifference { mSettings.ChannelView == ChannelViewMode::Diff };
+    if (ShowDifference) {
+        ImGui::Text("Difference (%.0fx)", mDifferenceGain);
+    } else {
+        ImGui::Text("Compressed");
+    }
+    if (ShowDifference && mHasDifferenceTexture) {
+        ImGui::Image(reinterpret_cast<ImTextureID>(mDifferenceGpuHandle.ptr), DrawSize, UvMin, UvMax);
+    } else if (!ShowDifference && mHasCompressedTexture) {
+        ImGui::Image(reinterpret_cast<ImTextureID>(mCompressedGpuHandle.ptr), DrawSize, UvMin, UvMax);
     } else {
         ImGui::Dummy(DrawSize);
     }
+    ImGui::EndGroup();
+    ImGui::End();
+
+    RenderProfilerPanel();
+}
+
+void ViewerApplication::RenderProfilerPanel() {
+    ImGui::Begin("Pipeline Profiler");
+    PipelineProfiler& Profiler { PipelineProfiler::GetInstance() };
+    if (ImGui::Button("Reset")) {
+        Profiler.Reset();
+    }
+    if (ImGui::BeginTable("Stages", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Stage");
+        ImGui::TableSetupColumn("Samples");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("Peak ms");
+        ImGui::TableSetupColumn("Last MPix/s");
+        ImGui::TableSetupColumn("Total MB");
+        ImGui::TableHeadersRow();
+        for (size_t StageIndex { 0 }; StageIndex < static_cast<size_t>(PipelineStage::Count); ++StageIndex) {
+            const PipelineStage Stage { static_cast<PipelineStage>(StageIndex) };
+            const PipelineStageStatistics Statistics { Profiler.GetStatistics(Stage) };
+            const double AverageMilliseconds { Statistics.SampleCount > 0 ? Statistics.TotalMilliseconds / static_cast<double>(Statistics.SampleCount) : 0.0 };
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(GetPipelineStageName(Stage));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(Statistics.SampleCount));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", Statistics.LastMilliseconds);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", AverageMilliseconds);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", Statistics.PeakMilliseconds);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", ComputeMegapixelsPerSecond(Statistics.LastPixels, Statistics.LastMilliseconds));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(Statistics.TotalBytes) / (1024.0 * 1024.0));
+        }
+        ImGui::EndTable();
+    }
     ImGui::End();
 }
 
@@ -631,15 +895,36 @@ void ViewerApplication::ProcessPendingDrop() {
     }
     mHasPendingDrop = false;
     if (mAnalyzer.LoadTexture(mPendingDropPath)) {
+        mSourceMip = 0;
+        mSourceItem = 0;
+        mHasPendingSubresourceSelection = false;
         RefreshSourceTexture();
         RefreshCompressedTexture();
     }
 }
 
-void ViewerApplication::ApplySettingsAndRefreshPreview() {
-    if (mAnalyzer.ApplySettings(mSettings)) {
+void ViewerApplication::ProcessPendingSubresourceSelection() {
+    if (!mHasPendingSubresourceSelection) {
+        return;
+    }
+    mHasPendingSubresourceSelection = false;
+    if (mAnalyzer.SelectSourceSubresource(static_cast<size_t>(mSourceMip), static_cast<size_t>(mSourceItem))) {
+        RefreshSourceTexture();
+        RefreshCompressedTexture();
+    }
+}
+
+void ViewerApplication::ProcessCompletedPreview() {
+    if (mAnalyzer.PollCompressedPreview()) {
         RefreshCompressedTexture();
     }
+    if (mSettings.ChannelView == ChannelViewMode::Diff && mAnalyzer.PollDifferenceHeatmap()) {
+        RefreshDifferenceTexture();
+    }
+}
+
+void ViewerApplication::ApplySettingsAndRefreshPreview() {
+    mAnalyzer.ApplySettings(mSettings);
 }
 
 void ViewerApplication::RefreshSourceTexture() {
@@ -656,6 +941,15 @@ void ViewerApplication::RefreshSourceTexture() {
             SrvDesc.Texture2D.MipLevels = static_cast<UINT>(-1);
             SrvDesc.Texture2D.PlaneSlice = 0;
             SrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+            if (mSourceTexture->GetDesc().DepthOrArraySize > 1) {
+                SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                SrvDesc.Texture2DArray.MostDetailedMip = 0;
+                SrvDesc.Texture2DArray.MipLevels = static_cast<UINT>(-1);
+                SrvDesc.Texture2DArray.FirstArraySlice = 0;
+                SrvDesc.Texture2DArray.ArraySize = 1;
+                SrvDesc.Texture2DArray.PlaneSlice = 0;
+                SrvDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+            }
             mDevice->CreateShaderResourceView(mSourceTexture.Get(), &SrvDesc, mSourceCpuHandle);
             mHasSourceTexture = true;
         }
@@ -680,6 +974,15 @@ void ViewerApplication::RefreshCompressedTexture() {
             SrvDesc.Texture2D.MipLevels = static_cast<UINT>(-1);
             SrvDesc.Texture2D.PlaneSlice = 0;
             SrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+            if (mCompressedTexture->GetDesc().DepthOrArraySize > 1) {
+                SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+                SrvDesc.Texture2DArray.MostDetailedMip = 0;
+                SrvDesc.Texture2DArray.MipLevels = static_cast<UINT>(-1);
+                SrvDesc.Texture2DArray.FirstArraySlice = 0;
+                SrvDesc.Texture2DArray.ArraySize = 1;
+                SrvDesc.Texture2DArray.PlaneSlice = 0;
+                SrvDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+            }
             mDevice->CreateShaderResourceView(mCompressedTexture.Get(), &SrvDesc, mCompressedCpuHandle);
             mHasCompressedTexture = true;
         }
@@ -690,6 +993,30 @@ void ViewerApplication::RefreshCompressedTexture() {
     WaitForGpu();
 }
 
+void ViewerApplication::RefreshDifferenceTexture() {
+    mCommandAllocators[mFrameIndex]->Reset();
+    mCommandList->Reset(mCommandAllocators[mFrameIndex].Get(), nullptr);
+    mHasDifferenceTexture = false;
+    if (mAnalyzer.UpdateDifferenceGpuResources(mDevice.Get(), mCommandList.Get(), mUploader, mDifferenceTexture, mDifferenceUpload)) {
+        if (mDifferenceTexture.Get() != nullptr) {
+            D3D12_SHADER_RESOURCE_VIEW_DESC SrvDesc {};
+            SrvDesc.Format = mDifferenceTexture->GetDesc().Format;
+            SrvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            SrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            SrvDesc.Texture2D.MostDetailedMip = 0;
+            SrvDesc.Texture2D.MipLevels = 1;
+            SrvDesc.Texture2D.PlaneSlice = 0;
+            SrvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+            mDevice->CreateShaderResourceView(mDifferenceTexture.Get(), &SrvDesc, mDifferenceCpuHandle);
+            mHasDifferenceTexture = true;
+        }
+    }
+    mCommandList->Close();
+    ID3D12CommandList* Lists[] { mCommandList.Get() };
+    mCommandQueue->ExecuteCommandLists(1, Lists);
+    WaitForGpu();
+}
+
 int APIENTRY wWinMain(_In_ HINSTANCE InstanceHandle, _In_opt_ HINSTANCE PreviousHandle, _In_ LPWSTR CommandLine, _In_ int ShowCommand) {
     (void)PreviousHandle;
     (void)CommandLine;
@@ -57,6 +57,7 @@ private:
 
     bool BeginFrame();
     void RenderUi();
+    void RenderProfilerPanel();
     void RenderFrame();
     void EndFrame();
 
@@ -65,9 +66,12 @@ private:
 
     void HandleDroppedFile(HDROP DropHandle);
     void ProcessPendingDrop();
+    void ProcessPendingSubresourceSelection();
+    void ProcessCompletedPreview();
     void ApplySettingsAndRefreshPreview();
     void RefreshSourceTexture();
     void RefreshCompressedTexture();
+    void RefreshDifferenceTexture();
 
 private:
     static constexpr UINT FrameCount { 2 };
@@ -96,11 +100,14 @@ private:
     AnalyzerSettings mSettings;
     std::vector<FormatOption> mFormatOptions;
     int mSelectedFormatIndex;
+    float mDifferenceGain;
 
     ComPtrResource mSourceTexture;
     ComPtrResource mSourceUpload;
     ComPtrResource mCompressedTexture;
     ComPtrResource mCompressedUpload;
+    ComPtrResource mDifferenceTexture;
+    ComPtrResource mDifferenceUpload;
 
     D3D12_CPU_DESCRIPTOR_HANDLE mImGuiCpuHandle;
     D3D12_GPU_DESCRIPTOR_HANDLE mImGuiGpuHandle;
@@ -108,9 +115,15 @@ private:
     D3D12_GPU_DESCRIPTOR_HANDLE mSourceGpuHandle;
     D3D12_CPU_DESCRIPTOR_HANDLE mCompressedCpuHandle;
     D3D12_GPU_DESCRIPTOR_HANDLE mCompressedGpuHandle;
+    D3D12_CPU_DESCRIPTOR_HANDLE mDifferenceCpuHandle;
+    D3D12_GPU_DESCRIPTOR_HANDLE mDifferenceGpuHandle;
 
     bool mHasSourceTexture;
     bool mHasCompressedTexture;
+    bool mHasDifferenceTexture;
     bool mHasPendingDrop;
     std::filesystem::path mPendingDropPath;
+    int mSourceMip;
+    int mSourceItem;
+    bool mHasPendingSubresourceSelection;
 };
@@ -0,0 +1,405 @@
+#include "ErrorMetricKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if ERROR_METRIC_KERNELS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+    constexpr float ByteToUnit { 1.0f / 255.0f };
+    constexpr double MaxPsnrDecibels { 100.0 };
+    constexpr double SsimC1 { 0.01 * 0.01 };
+    constexpr double SsimC2 { 0.03 * 0.03 };
+    constexpr size_t SsimWindowSize { 8 };
+    constexpr size_t SsimWindowStride { 4 };
+
+    struct CpuFeatures {
+        bool Sse41;
+        bool Avx2;
+        bool Avx512;
+    };
+
+    float HalfToFloat(uint16_t Half) {
+        const uint32_t Sign { static_cast<uint32_t>(Half & 0x8000u) << 16 };
+        uint32_t Exponent { (Half >> 10) & 0x1Fu };
+        uint32_t Mantissa { Half & 0x3FFu };
+        uint32_t Bits { 0 };
+        if (Exponent == 0x1Fu) {
+            Bits = Sign | 0x7F800000u | (Mantissa << 13);
+        }
+        else if (Exponent != 0) {
+            Bits = Sign | ((Exponent + 112u) << 23) | (Mantissa << 13);
+        }
+        else if (Mantissa != 0) {
+            Exponent = 113;
+            while ((Mantissa & 0x400u) == 0) {
+                Mantissa <<= 1;
+                --Exponent;
+            }
+            Bits = Sign | (Exponent << 23) | ((Mantissa & 0x3FFu) << 13);
+        }
+        else {
+            Bits = Sign;
+        }
+        float Value { 0.0f };
+        std::memcpy(&Value, &Bits, sizeof(Value));
+        return Value;
+    }
+
+    uint32_t ComputeHistogramBin(float Difference) {
+        const float Scaled { std::fabs(Difference) * 255.0f + 0.5f };
+        return static_cast<uint32_t>(Scaled < 255.0f ? Scaled : 255.0f);
+    }
+
+    void ConvertRgba8RowScalar(const uint8_t* Source, size_t Width, float* Destination) {
+        for (size_t Index { 0 }; Index < Width * 4; ++Index) {
+            Destination[Index] = static_cast<float>(Source[Index]) * ByteToUnit;
+        }
+    }
+
+    void ConvertRgba16FRowScalar(const uint8_t* Source, size_t Width, float* Destination) {
+        for (size_t Index { 0 }; Index < Width * 4; ++Index) {
+            uint16_t Half { 0 };
+            std::memcpy(&Half, Source + Index * sizeof(uint16_t), sizeof(Half));
+            Destination[Index] = HalfToFloat(Half);
+        }
+    }
+
+    void AccumulateRowScalar(const float* Reference, const float* Candidate, size_t Width, float* BlockMoments, double* SquaredErrorSums, uint32_t* Histograms) {
+        const size_t BlockCount { Width / ErrorMetricBlockSize };
+        std::array<double, 4> SquaredError {};
+        for (size_t X { 0 }; X < Width; ++X) {
+            float* Moments { X < BlockCount * ErrorMetricBlockSize ? BlockMoments + (X / ErrorMetricBlockSize) * ErrorMetricMomentCount : nullptr };
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                const float ValueX { Reference[X * 4 + Channel] };
+                const float ValueY { Candidate[X * 4 + Channel] };
+                const float Difference { ValueX - ValueY };
+                SquaredError[Channel] += static_cast<double>(Difference) * static_cast<double>(Difference);
+                ++Histograms[Channel * ErrorHistogramBinCount + ComputeHistogramBin(Difference)];
+                if (Moments != nullptr) {
+                    Moments[Channel] += ValueX;
+                    Moments[4 + Channel] += ValueY;
+                    Moments[8 + Channel] += ValueX * ValueX;
+                    Moments[12 + Channel] += ValueY * ValueY;
+                    Moments[16 + Channel] += ValueX * ValueY;
+                }
+            }
+        }
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            SquaredErrorSums[Channel] += SquaredError[Channel];
+        }
+    }
+
+    void WriteDifferenceRowScalar(const float* Reference, const float* Candidate, size_t Width, float Gain, uint8_t* Destination) {
+        for (size_t X { 0 }; X < Width; ++X) {
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                const float Scaled { std::fabs(Reference[X * 4 + Channel] - Candidate[X * 4 + Channel]) * Gain * 255.0f + 0.5f };
+                Destination[X * 4 + Channel] = static_cast<uint8_t>(Scaled < 255.0f ? Scaled : 255.0f);
+            }
+            Destination[X * 4 + 3] = 255;
+        }
+    }
+
+#if ERROR_METRIC_KERNELS_X86
+    void QueryCpuId(uint32_t Leaf, uint32_t SubLeaf, uint32_t (&Registers)[4]) {
+#ifdef _MSC_VER
+        int Info[4] {};
+        __cpuidex(Info, static_cast<int>(Leaf), static_cast<int>(SubLeaf));
+        for (size_t Index { 0 }; Index < 4; ++Index) {
+            Registers[Index] = static_cast<uint32_t>(Info[Index]);
+        }
+#else
+        __cpuid_count(Leaf, SubLeaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+#endif
+    }
+
+    uint64_t ReadExtendedControlRegister() {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        uint32_t Low { 0 };
+        uint32_t High { 0 };
+        __asm__ volatile("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+        return (static_cast<uint64_t>(High) << 32) | Low;
+#endif
+    }
+#endif
+
+    CpuFeatures DetectCpuFeatures() {
+        CpuFeatures Features { false, false, false };
+#if ERROR_METRIC_KERNELS_X86
+        uint32_t Registers[4] {};
+        QueryCpuId(0, 0, Registers);
+        const uint32_t MaxLeaf { Registers[0] };
+        if (MaxLeaf < 1) {
+            return Features;
+        }
+        QueryCpuId(1, 0, Registers);
+        const bool HasSse41 { (Registers[2] & (1u << 19)) != 0 };
+        const bool HasOsXsave { (Registers[2] & (1u << 27)) != 0 };
+        const bool HasAvx { (Registers[2] & (1u << 28)) != 0 };
+        const bool HasF16c { (Registers[2] & (1u << 29)) != 0 };
+        const uint64_t EnabledState { HasOsXsave ? ReadExtendedControlRegister() : 0 };
+        const bool HasYmmState { (EnabledState & 0x6u) == 0x6u };
+        const bool HasZmmState { (EnabledState & 0xE6u) == 0xE6u };
+        bool HasAvx2 { false };
+        bool HasAvx512F { false };
+        if (MaxLeaf >= 7) {
+            QueryCpuId(7, 0, Registers);
+            HasAvx2 = (Registers[1] & (1u << 5)) != 0;
+            HasAvx512F = (Registers[1] & (1u << 16)) != 0;
+        }
+        Features.Sse41 = HasSse41;
+        Features.Avx2 = HasSse41 && HasAvx && HasAvx2 && HasF16c && HasYmmState;
+        Features.Avx512 = Features.Avx2 && HasAvx512F && HasZmmState;
+#endif
+        return Features;
+    }
+
+    const CpuFeatures& GetCpuFeatures() {
+        static const CpuFeatures Features { DetectCpuFeatures() };
+        return Features;
+    }
+
+    const ErrorMetricRowKernels* FindRowKernels(SimdInstructionSet InstructionSet) {
+        if (!IsInstructionSetSupported(InstructionSet)) {
+            return nullptr;
+        }
+        switch (InstructionSet) {
+#if ERROR_METRIC_KERNELS_X86
+        case SimdInstructionSet::Sse41:
+            return &GetSse41ErrorMetricRowKernels();
+        case SimdInstructionSet::Avx2:
+            return &GetAvx2ErrorMetricRowKernels();
+        case SimdInstructionSet::Avx512:
+            return &GetAvx512ErrorMetricRowKernels();
+#endif
+        default:
+            return &GetScalarErrorMetricRowKernels();
+        }
+    }
+
+    bool AreCompatible(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate) {
+        return Reference.Pixels != nullptr && Candidate.Pixels != nullptr && Reference.Width > 0 && Reference.Height > 0 &&
+            Reference.Width == Candidate.Width && Reference.Height == Candidate.Height;
+    }
+
+    const float* LoadFloatRow(const ErrorMetricImage& Image, size_t Y, const ErrorMetricRowKernels& Kernels, std::vector<float>& Buffer) {
+        const uint8_t* Row { Image.Pixels + Y * Image.RowPitch };
+        switch (Image.Format) {
+        case ErrorMetricPixelFormat::Rgba8:
+            Kernels.ConvertRgba8Row(Row, Image.Width, Buffer.data());
+            return Buffer.data();
+        case ErrorMetricPixelFormat::Rgba16F:
+            Kernels.ConvertRgba16FRow(Row, Image.Width, Buffer.data());
+            return Buffer.data();
+        default:
+            return reinterpret_cast<const float*>(Row);
+        }
+    }
+
+    double ComputeSsimFromMoments(double SumX, double SumY, double SumXX, double SumYY, double SumXY, double Count) {
+        const double MeanX { SumX / Count };
+        const double MeanY { SumY / Count };
+        const double VarianceX { std::max(0.0, SumXX / Count - MeanX * MeanX) };
+        const double VarianceY { std::max(0.0, SumYY / Count - MeanY * MeanY) };
+        const double Covariance { SumXY / Count - MeanX * MeanY };
+        return ((2.0 * MeanX * MeanY + SsimC1) * (2.0 * Covariance + SsimC2)) / ((MeanX * MeanX + MeanY * MeanY + SsimC1) * (VarianceX + VarianceY + SsimC2));
+    }
+
+    void AccumulateWindowRow(const std::vector<float>& Upper, const std::vector<float>& Lower, size_t BlockCount, std::array<double, 4>& SsimSums, size_t& WindowCount) {
+        const double WindowPixels { static_cast<double>(SsimWindowSize * SsimWindowSize) };
+        for (size_t Block { 0 }; Block + 1 < BlockCount; ++Block) {
+            std::array<double, ErrorMetricMomentCount> Moments {};
+            for (const float* Source : { &Upper[Block * ErrorMetricMomentCount], &Upper[(Block + 1) * ErrorMetricMomentCount], &Lower[Block * ErrorMetricMomentCount], &Lower[(Block + 1) * ErrorMetricMomentCount] }) {
+                for (size_t Index { 0 }; Index < ErrorMetricMomentCount; ++Index) {
+                    Moments[Index] += Source[Index];
+                }
+            }
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                SsimSums[Channel] += ComputeSsimFromMoments(Moments[Channel], Moments[4 + Channel], Moments[8 + Channel], Moments[12 + Channel], Moments[16 + Channel], WindowPixels);
+            }
+            ++WindowCount;
+        }
+    }
+
+    void FinalizeResult(const std::array<double, 4>& SquaredErrorSums, const std::array<double, 4>& SsimSums, size_t WindowCount, uint64_t PixelCount, ErrorMetricResult& ResultOut) {
+        ResultOut.PixelCount = PixelCount;
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            ResultOut.Mse[Channel] = SquaredErrorSums[Channel] / static_cast<double>(PixelCount);
+            ResultOut.Psnr[Channel] = ResultOut.Mse[Channel] <= 0.0 ? MaxPsnrDecibels : std::min(MaxPsnrDecibels, 10.0 * std::log10(1.0 / ResultOut.Mse[Channel]));
+            ResultOut.Ssim[Channel] = WindowCount > 0 ? SsimSums[Channel] / static_cast<double>(WindowCount) : 1.0;
+        }
+    }
+}
+
+bool ComputeErrorMetrics(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, SimdInstructionSet InstructionSet, ErrorMetricResult& ResultOut) {
+    ResultOut = ErrorMetricResult {};
+    const ErrorMetricRowKernels* Kernels { FindRowKernels(InstructionSet) };
+    if (Kernels == nullptr || !AreCompatible(Reference, Candidate)) {
+        return false;
+    }
+    if (Reference.Width < SsimWindowSize || Reference.Height < SsimWindowSize) {
+        return ComputeErrorMetricsReference(Reference, Candidate, ResultOut);
+    }
+
+    const size_t Width { Reference.Width };
+    const size_t BlockCount { Width / ErrorMetricBlockSize };
+    const size_t BlockRowCount { Reference.Height / ErrorMetricBlockSize };
+    std::vector<float> ReferenceBuffer(Width * 4);
+    std::vector<float> CandidateBuffer(Width * 4);
+    std::vector<float> PreviousMoments(BlockCount * ErrorMetricMomentCount);
+    std::vector<float> CurrentMoments(BlockCount * ErrorMetricMomentCount);
+    std::array<double, 4> SquaredErrorSums {};
+    std::array<double, 4> SsimSums {};
+    size_t WindowCount { 0 };
+    for (size_t Y { 0 }; Y < Reference.Height; ++Y) {
+        const float* ReferenceRow { LoadFloatRow(Reference, Y, *Kernels, ReferenceBuffer) };
+        const float* CandidateRow { LoadFloatRow(Candidate, Y, *Kernels, CandidateBuffer) };
+        Kernels->AccumulateRow(ReferenceRow, CandidateRow, Width, CurrentMoments.data(), SquaredErrorSums.data(), ResultOut.Histograms.data());
+        if ((Y + 1) % ErrorMetricBlockSize != 0 || Y / ErrorMetricBlockSize >= BlockRowCount) {
+            continue;
+        }
+        if (Y / ErrorMetricBlockSize > 0) {
+            AccumulateWindowRow(PreviousMoments, CurrentMoments, BlockCount, SsimSums, WindowCount);
+        }
+        std::swap(PreviousMoments, CurrentMoments);
+        std::fill(CurrentMoments.begin(), CurrentMoments.end(), 0.0f);
+    }
+    FinalizeResult(SquaredErrorSums, SsimSums, WindowCount, static_cast<uint64_t>(Width) * Reference.Height, ResultOut);
+    return true;
+}
+
+bool ComputeErrorMetricsReference(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, ErrorMetricResult& ResultOut) {
+    ResultOut = ErrorMetricResult {};
+    if (!AreCompatible(Reference, Candidate)) {
+        return false;
+    }
+    const size_t Width { Reference.Width };
+    const size_t Height { Reference.Height };
+    const ErrorMetricRowKernels& Kernels { GetScalarErrorMetricRowKernels() };
+    std::vector<float> ReferencePixels(Width * Height * 4);
+    std::vector<float> CandidatePixels(Width * Height * 4);
+    std::vector<float> RowBuffer(Width * 4);
+    for (size_t Y { 0 }; Y < Height; ++Y) {
+        const float* ReferenceRow { LoadFloatRow(Reference, Y, Kernels, RowBuffer) };
+        std::copy(ReferenceRow, ReferenceRow + Width * 4, ReferencePixels.begin() + Y * Width * 4);
+        const float* CandidateRow { LoadFloatRow(Candidate, Y, Kernels, RowBuffer) };
+        std::copy(CandidateRow, CandidateRow + Width * 4, CandidatePixels.begin() + Y * Width * 4);
+    }
+
+    std::array<double, 4> SquaredErrorSums {};
+    for (size_t Index { 0 }; Index < Width * Height * 4; ++Index) {
+        const float Difference { ReferencePixels[Index] - CandidatePixels[Index] };
+        SquaredErrorSums[Index % 4] += static_cast<double>(Difference) * static_cast<double>(Difference);
+        ++ResultOut.Histograms[(Index % 4) * ErrorHistogramBinCount + ComputeHistogramBin(Difference)];
+    }
+
+    const size_t WindowWidth { std::min(SsimWindowSize, Width) };
+    const size_t WindowHeight { std::min(SsimWindowSize, Height) };
+    const double WindowPixels { static_cast<double>(WindowWidth * WindowHeight) };
+    std::array<double, 4> SsimSums {};
+    size_t WindowCount { 0 };
+    for (size_t Top { 0 }; Top + WindowHeight <= Height; Top += SsimWindowStride) {
+        for (size_t Left { 0 }; Left + WindowWidth <= Width; Left += SsimWindowStride) {
+            std::array<double, ErrorMetricMomentCount> Moments {};
+            for (size_t Y { Top }; Y < Top + WindowHeight; ++Y) {
+                for (size_t X { Left }; X < Left + WindowWidth; ++X) {
+                    for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                        const double ValueX { ReferencePixels[(Y * Width + X) * 4 + Channel] };
+                        const double ValueY { CandidatePixels[(Y * Width + X) * 4 + Channel] };
+                        Moments[Channel] += ValueX;
+                        Moments[4 + Channel] += ValueY;
+                        Moments[8 + Channel] += ValueX * ValueX;
+                        Moments[12 + Channel] += ValueY * ValueY;
+                        Moments[16 + Channel] += ValueX * ValueY;
+                    }
+                }
+            }
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                SsimSums[Channel] += ComputeSsimFromMoments(Moments[Channel], Moments[4 + Channel], Moments[8 + Channel], Moments[12 + Channel], Moments[16 + Channel], WindowPixels);
+            }
+            ++WindowCount;
+        }
+    }
+    FinalizeResult(SquaredErrorSums, SsimSums, WindowCount, static_cast<uint64_t>(Width) * Height, ResultOut);
+    return true;
+}
+
+bool ComputeDifferenceImage(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, float Gain, SimdInstructionSet InstructionSet, uint8_t* Destination, size_t DestinationRowPitch) {
+    const ErrorMetricRowKernels* Kernels { FindRowKernels(InstructionSet) };
+    if (Kernels == nullptr || Destination == nullptr || !AreCompatible(Reference, Candidate)) {
+        return false;
+    }
+    std::vector<float> ReferenceBuffer(Reference.Width * 4);
+    std::vector<float> CandidateBuffer(Reference.Width * 4);
+    for (size_t Y { 0 }; Y < Reference.Height; ++Y) {
+        const float* ReferenceRow { LoadFloatRow(Reference, Y, *Kernels, ReferenceBuffer) };
+        const float* CandidateRow { LoadFloatRow(Candidate, Y, *Kernels, CandidateBuffer) };
+        Kernels->WriteDifferenceRow(ReferenceRow, CandidateRow, Reference.Width, Gain, Destination + Y * DestinationRowPitch);
+    }
+    return true;
+}
+
+bool IsInstructionSetSupported(SimdInstructionSet InstructionSet) {
+    const CpuFeatures& Features { GetCpuFeatures() };
+    switch (InstructionSet) {
+    case SimdInstructionSet::Scalar:
+        return true;
+    case SimdInstructionSet::Sse41:
+        return Features.Sse41;
+    case SimdInstructionSet::Avx2:
+        return Features.Avx2;
+    case SimdInstructionSet::Avx512:
+        return Features.Avx512;
+    default:
+        return false;
+    }
+}
+
+SimdInstructionSet ResolveErrorMetricInstructionSet() {
+    for (const SimdInstructionSet InstructionSet : { SimdInstructionSet::Avx512, SimdInstructionSet::Avx2, SimdInstructionSet::Sse41 }) {
+        if (IsInstructionSetSupported(InstructionSet)) {
+            return InstructionSet;
+        }
+    }
+    return SimdInstructionSet::Scalar;
+}
+
+const char* GetSimdInstructionSetName(SimdInstructionSet InstructionSet) {
+    switch (InstructionSet) {
+    case SimdInstructionSet::Sse41:
+        return "sse4.1";
+    case SimdInstructionSet::Avx2:
+        return "avx2";
+    case SimdInstructionSet::Avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+size_t GetErrorMetricBytesPerPixel(ErrorMetricPixelFormat Format) {
+    switch (Format) {
+    case ErrorMetricPixelFormat::Rgba8:
+        return 4;
+    case ErrorMetricPixelFormat::Rgba16F:
+        return 8;
+    default:
+        return 16;
+    }
+}
+
+const ErrorMetricRowKernels& GetScalarErrorMetricRowKernels() {
+    static const ErrorMetricRowKernels Kernels { ConvertRgba8RowScalar, ConvertRgba16FRowScalar, AccumulateRowScalar, WriteDifferenceRowScalar };
+    return Kernels;
+}
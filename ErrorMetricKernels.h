@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ERROR_METRIC_KERNELS_X86 1
+#else
+#define ERROR_METRIC_KERNELS_X86 0
+#endif
+
+enum class ErrorMetricPixelFormat {
+    Rgba8,
+    Rgba16F,
+    Rgba32F
+};
+
+enum class SimdInstructionSet {
+    Scalar,
+    Sse41,
+    Avx2,
+    Avx512
+};
+
+constexpr size_t ErrorHistogramBinCount { 256 };
+constexpr size_t ErrorMetricBlockSize { 4 };
+constexpr size_t ErrorMetricMomentCount { 20 };
+
+struct ErrorMetricImage {
+    const uint8_t* Pixels;
+    size_t RowPitch;
+    size_t Width;
+    size_t Height;
+    ErrorMetricPixelFormat Format;
+};
+
+struct ErrorMetricResult {
+    std::array<double, 4> Mse;
+    std::array<double, 4> Psnr;
+    std::array<double, 4> Ssim;
+    std::array<uint32_t, ErrorHistogramBinCount * 4> Histograms;
+    uint64_t PixelCount;
+};
+
+struct ErrorMetricRowKernels {
+    void (*ConvertRgba8Row)(const uint8_t* Source, size_t Width, float* Destination);
+    void (*ConvertRgba16FRow)(const uint8_t* Source, size_t Width, float* Destination);
+    void (*AccumulateRow)(const float* Reference, const float* Candidate, size_t Width, float* BlockMoments, double* SquaredErrorSums, uint32_t* Histograms);
+    void (*WriteDifferenceRow)(const float* Reference, const float* Candidate, size_t Width, float Gain, uint8_t* Destination);
+};
+
+bool ComputeErrorMetrics(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, SimdInstructionSet InstructionSet, ErrorMetricResult& ResultOut);
+bool ComputeErrorMetricsReference(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, ErrorMetricResult& ResultOut);
+bool ComputeDifferenceImage(const ErrorMetricImage& Reference, const ErrorMetricImage& Candidate, float Gain, SimdInstructionSet InstructionSet, uint8_t* Destination, size_t DestinationRowPitch);
+bool IsInstructionSetSupported(SimdInstructionSet InstructionSet);
+SimdInstructionSet ResolveErrorMetricInstructionSet();
+const char* GetSimdInstructionSetName(SimdInstructionSet InstructionSet);
+size_t GetErrorMetricBytesPerPixel(ErrorMetricPixelFormat Format);
+
+const ErrorMetricRowKernels& GetScalarErrorMetricRowKernels();
+#if ERROR_METRIC_KERNELS_X86
+const ErrorMetricRowKernels& GetSse41ErrorMetricRowKernels();
+const ErrorMetricRowKernels& GetAvx2ErrorMetricRowKernels();
+const ErrorMetricRowKernels& GetAvx512ErrorMetricRowKernels();
+#endif
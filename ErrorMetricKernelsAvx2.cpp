@@ -0,0 +1,118 @@
+#include "ErrorMetricKernels.h"
+
+#if ERROR_METRIC_KERNELS_X86
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace {
+    void ConvertRgba8RowAvx2(const uint8_t* Source, size_t Width, float* Destination) {
+        const __m256 Scale { _mm256_set1_ps(1.0f / 255.0f) };
+        size_t X { 0 };
+        for (; X + 2 <= Width; X += 2) {
+            const __m256i Values { _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + X * 4))) };
+            _mm256_storeu_ps(Destination + X * 4, _mm256_mul_ps(_mm256_cvtepi32_ps(Values), Scale));
+        }
+        for (; X < Width; ++X) {
+            int32_t Packed { 0 };
+            std::memcpy(&Packed, Source + X * 4, sizeof(Packed));
+            const __m128 Pixel { _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(Packed))) };
+            _mm_storeu_ps(Destination + X * 4, _mm_mul_ps(Pixel, _mm256_castps256_ps128(Scale)));
+        }
+    }
+
+    void ConvertRgba16FRowAvx2(const uint8_t* Source, size_t Width, float* Destination) {
+        size_t X { 0 };
+        for (; X + 2 <= Width; X += 2) {
+            _mm256_storeu_ps(Destination + X * 4, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + X * 8))));
+        }
+        for (; X < Width; ++X) {
+            _mm_storeu_ps(Destination + X * 4, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + X * 8))));
+        }
+    }
+
+    void AddHistogram(__m256 Difference, uint32_t* Histograms) {
+        const __m256 AbsoluteMask { _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)) };
+        const __m256 Scaled { _mm256_add_ps(_mm256_mul_ps(_mm256_and_ps(Difference, AbsoluteMask), _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)) };
+        alignas(32) int32_t Bins[8] {};
+        _mm256_store_si256(reinterpret_cast<__m256i*>(Bins), _mm256_cvttps_epi32(_mm256_min_ps(Scaled, _mm256_set1_ps(255.0f))));
+        for (size_t Lane { 0 }; Lane < 8; ++Lane) {
+            ++Histograms[(Lane % 4) * ErrorHistogramBinCount + static_cast<uint32_t>(Bins[Lane])];
+        }
+    }
+
+    void AddToMoments(float* Moments, size_t Offset, __m256 Value) {
+        const __m128 Folded { _mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1)) };
+        _mm_storeu_ps(Moments + Offset, _mm_add_ps(_mm_loadu_ps(Moments + Offset), Folded));
+    }
+
+    void AccumulateRowAvx2(const float* Reference, const float* Candidate, size_t Width, float* BlockMoments, double* SquaredErrorSums, uint32_t* Histograms) {
+        const size_t BlockCount { Width / ErrorMetricBlockSize };
+        __m256 SquaredError { _mm256_setzero_ps() };
+        for (size_t Block { 0 }; Block < BlockCount; ++Block) {
+            const size_t Offset { Block * ErrorMetricBlockSize * 4 };
+            const __m256 ValueX0 { _mm256_loadu_ps(Reference + Offset) };
+            const __m256 ValueY0 { _mm256_loadu_ps(Candidate + Offset) };
+            const __m256 ValueX1 { _mm256_loadu_ps(Reference + Offset + 8) };
+            const __m256 ValueY1 { _mm256_loadu_ps(Candidate + Offset + 8) };
+            const __m256 Difference0 { _mm256_sub_ps(ValueX0, ValueY0) };
+            const __m256 Difference1 { _mm256_sub_ps(ValueX1, ValueY1) };
+            SquaredError = _mm256_add_ps(SquaredError, _mm256_mul_ps(Difference0, Difference0));
+            SquaredError = _mm256_add_ps(SquaredError, _mm256_mul_ps(Difference1, Difference1));
+            AddHistogram(Difference0, Histograms);
+            AddHistogram(Difference1, Histograms);
+            float* Moments { BlockMoments + Block * ErrorMetricMomentCount };
+            AddToMoments(Moments, 0, _mm256_add_ps(ValueX0, ValueX1));
+            AddToMoments(Moments, 4, _mm256_add_ps(ValueY0, ValueY1));
+            AddToMoments(Moments, 8, _mm256_add_ps(_mm256_mul_ps(ValueX0, ValueX0), _mm256_mul_ps(ValueX1, ValueX1)));
+            AddToMoments(Moments, 12, _mm256_add_ps(_mm256_mul_ps(ValueY0, ValueY0), _mm256_mul_ps(ValueY1, ValueY1)));
+            AddToMoments(Moments, 16, _mm256_add_ps(_mm256_mul_ps(ValueX0, ValueY0), _mm256_mul_ps(ValueX1, ValueY1)));
+        }
+        __m128 Folded { _mm_add_ps(_mm256_castps256_ps128(SquaredError), _mm256_extractf128_ps(SquaredError, 1)) };
+        for (size_t X { BlockCount * ErrorMetricBlockSize }; X < Width; ++X) {
+            const __m128 Difference { _mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)) };
+            Folded = _mm_add_ps(Folded, _mm_mul_ps(Difference, Difference));
+            const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_and_ps(Difference, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+            alignas(16) int32_t Bins[4] {};
+            _mm_store_si128(reinterpret_cast<__m128i*>(Bins), _mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))));
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                ++Histograms[Channel * ErrorHistogramBinCount + static_cast<uint32_t>(Bins[Channel])];
+            }
+        }
+        alignas(16) float Sums[4] {};
+        _mm_store_ps(Sums, Folded);
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            SquaredErrorSums[Channel] += Sums[Channel];
+        }
+    }
+
+    void WriteDifferenceRowAvx2(const float* Reference, const float* Candidate, size_t Width, float Gain, uint8_t* Destination) {
+        const __m256 AbsoluteMask { _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)) };
+        const __m256 GainVector { _mm256_set1_ps(Gain) };
+        const __m256i ColorMask { _mm256_set_epi32(0, -1, -1, -1, 0, -1, -1, -1) };
+        const __m256i OpaqueAlpha { _mm256_set_epi32(255, 0, 0, 0, 255, 0, 0, 0) };
+        size_t X { 0 };
+        for (; X + 2 <= Width; X += 2) {
+            const __m256 Difference { _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(Reference + X * 4), _mm256_loadu_ps(Candidate + X * 4)), AbsoluteMask) };
+            const __m256 Scaled { _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(Difference, GainVector), _mm256_set1_ps(255.0f)), _mm256_set1_ps(0.5f)) };
+            const __m256i Values { _mm256_or_si256(_mm256_and_si256(_mm256_cvttps_epi32(_mm256_min_ps(Scaled, _mm256_set1_ps(255.0f))), ColorMask), OpaqueAlpha) };
+            const __m128i Words { _mm_packus_epi32(_mm256_castsi256_si128(Values), _mm256_extracti128_si256(Values, 1)) };
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(Destination + X * 4), _mm_packus_epi16(Words, Words));
+        }
+        for (; X < Width; ++X) {
+            const __m128 Difference { _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)), _mm256_castps256_ps128(AbsoluteMask)) };
+            const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Difference, _mm256_castps256_ps128(GainVector)), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+            const __m128i Values { _mm_or_si128(_mm_and_si128(_mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))), _mm256_castsi256_si128(ColorMask)), _mm256_castsi256_si128(OpaqueAlpha)) };
+            const __m128i Packed { _mm_packus_epi16(_mm_packus_epi32(Values, Values), _mm_setzero_si128()) };
+            const int32_t Pixel { _mm_cvtsi128_si32(Packed) };
+            std::memcpy(Destination + X * 4, &Pixel, sizeof(Pixel));
+        }
+    }
+}
+
+const ErrorMetricRowKernels& GetAvx2ErrorMetricRowKernels() {
+    static const ErrorMetricRowKernels Kernels { ConvertRgba8RowAvx2, ConvertRgba16FRowAvx2, AccumulateRowAvx2, WriteDifferenceRowAvx2 };
+    return Kernels;
+}
+
+#endif
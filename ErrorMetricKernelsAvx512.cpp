@@ -0,0 +1,117 @@
+#include "ErrorMetricKernels.h"
+
+#if ERROR_METRIC_KERNELS_X86
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace {
+    void ConvertRgba8RowAvx512(const uint8_t* Source, size_t Width, float* Destination) {
+        const __m512 Scale { _mm512_set1_ps(1.0f / 255.0f) };
+        size_t X { 0 };
+        for (; X + 4 <= Width; X += 4) {
+            const __m512i Values { _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + X * 4))) };
+            _mm512_storeu_ps(Destination + X * 4, _mm512_mul_ps(_mm512_cvtepi32_ps(Values), Scale));
+        }
+        for (; X < Width; ++X) {
+            int32_t Packed { 0 };
+            std::memcpy(&Packed, Source + X * 4, sizeof(Packed));
+            const __m128 Pixel { _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(Packed))) };
+            _mm_storeu_ps(Destination + X * 4, _mm_mul_ps(Pixel, _mm_set1_ps(1.0f / 255.0f)));
+        }
+    }
+
+    void ConvertRgba16FRowAvx512(const uint8_t* Source, size_t Width, float* Destination) {
+        size_t X { 0 };
+        for (; X + 4 <= Width; X += 4) {
+            _mm512_storeu_ps(Destination + X * 4, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + X * 8))));
+        }
+        for (; X < Width; ++X) {
+            _mm_storeu_ps(Destination + X * 4, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source + X * 8))));
+        }
+    }
+
+    __m128 FoldToPixel(__m512 Value) {
+        const __m128 Low { _mm_add_ps(_mm512_extractf32x4_ps(Value, 0), _mm512_extractf32x4_ps(Value, 1)) };
+        const __m128 High { _mm_add_ps(_mm512_extractf32x4_ps(Value, 2), _mm512_extractf32x4_ps(Value, 3)) };
+        return _mm_add_ps(Low, High);
+    }
+
+    void AddHistogram(__m512 Difference, uint32_t* Histograms) {
+        const __m512 Absolute { _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(Difference), _mm512_set1_epi32(0x7FFFFFFF))) };
+        const __m512 Scaled { _mm512_add_ps(_mm512_mul_ps(Absolute, _mm512_set1_ps(255.0f)), _mm512_set1_ps(0.5f)) };
+        alignas(64) int32_t Bins[16] {};
+        _mm512_store_si512(Bins, _mm512_cvttps_epi32(_mm512_min_ps(Scaled, _mm512_set1_ps(255.0f))));
+        for (size_t Lane { 0 }; Lane < 16; ++Lane) {
+            ++Histograms[(Lane % 4) * ErrorHistogramBinCount + static_cast<uint32_t>(Bins[Lane])];
+        }
+    }
+
+    void AddToMoments(float* Moments, size_t Offset, __m512 Value) {
+        _mm_storeu_ps(Moments + Offset, _mm_add_ps(_mm_loadu_ps(Moments + Offset), FoldToPixel(Value)));
+    }
+
+    void AccumulateRowAvx512(const float* Reference, const float* Candidate, size_t Width, float* BlockMoments, double* SquaredErrorSums, uint32_t* Histograms) {
+        const size_t BlockCount { Width / ErrorMetricBlockSize };
+        __m512 SquaredError { _mm512_setzero_ps() };
+        for (size_t Block { 0 }; Block < BlockCount; ++Block) {
+            const size_t Offset { Block * ErrorMetricBlockSize * 4 };
+            const __m512 ValueX { _mm512_loadu_ps(Reference + Offset) };
+            const __m512 ValueY { _mm512_loadu_ps(Candidate + Offset) };
+            const __m512 Difference { _mm512_sub_ps(ValueX, ValueY) };
+            SquaredError = _mm512_add_ps(SquaredError, _mm512_mul_ps(Difference, Difference));
+            AddHistogram(Difference, Histograms);
+            float* Moments { BlockMoments + Block * ErrorMetricMomentCount };
+            AddToMoments(Moments, 0, ValueX);
+            AddToMoments(Moments, 4, ValueY);
+            AddToMoments(Moments, 8, _mm512_mul_ps(ValueX, ValueX));
+            AddToMoments(Moments, 12, _mm512_mul_ps(ValueY, ValueY));
+            AddToMoments(Moments, 16, _mm512_mul_ps(ValueX, ValueY));
+        }
+        __m128 Folded { FoldToPixel(SquaredError) };
+        for (size_t X { BlockCount * ErrorMetricBlockSize }; X < Width; ++X) {
+            const __m128 Difference { _mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)) };
+            Folded = _mm_add_ps(Folded, _mm_mul_ps(Difference, Difference));
+            const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_and_ps(Difference, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+            alignas(16) int32_t Bins[4] {};
+            _mm_store_si128(reinterpret_cast<__m128i*>(Bins), _mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))));
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                ++Histograms[Channel * ErrorHistogramBinCount + static_cast<uint32_t>(Bins[Channel])];
+            }
+        }
+        alignas(16) float Sums[4] {};
+        _mm_store_ps(Sums, Folded);
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            SquaredErrorSums[Channel] += Sums[Channel];
+        }
+    }
+
+    void WriteDifferenceRowAvx512(const float* Reference, const float* Candidate, size_t Width, float Gain, uint8_t* Destination) {
+        const __m512i AbsoluteMask { _mm512_set1_epi32(0x7FFFFFFF) };
+        const __m512 GainVector { _mm512_set1_ps(Gain) };
+        const __mmask16 ColorLanes { 0x7777 };
+        const __m512i OpaqueAlpha { _mm512_set1_epi32(255) };
+        size_t X { 0 };
+        for (; X + 4 <= Width; X += 4) {
+            const __m512 Difference { _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(_mm512_sub_ps(_mm512_loadu_ps(Reference + X * 4), _mm512_loadu_ps(Candidate + X * 4))), AbsoluteMask)) };
+            const __m512 Scaled { _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(Difference, GainVector), _mm512_set1_ps(255.0f)), _mm512_set1_ps(0.5f)) };
+            const __m512i Values { _mm512_mask_blend_epi32(ColorLanes, OpaqueAlpha, _mm512_cvttps_epi32(_mm512_min_ps(Scaled, _mm512_set1_ps(255.0f)))) };
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + X * 4), _mm512_cvtepi32_epi8(Values));
+        }
+        for (; X < Width; ++X) {
+            const __m128 Difference { _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)), _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))) };
+            const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Difference, _mm_set1_ps(Gain)), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+            const __m128i Values { _mm_or_si128(_mm_and_si128(_mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))), _mm_set_epi32(0, -1, -1, -1)), _mm_set_epi32(255, 0, 0, 0)) };
+            const __m128i Packed { _mm_packus_epi16(_mm_packus_epi32(Values, Values), _mm_setzero_si128()) };
+            const int32_t Pixel { _mm_cvtsi128_si32(Packed) };
+            std::memcpy(Destination + X * 4, &Pixel, sizeof(Pixel));
+        }
+    }
+}
+
+const ErrorMetricRowKernels& GetAvx512ErrorMetricRowKernels() {
+    static const ErrorMetricRowKernels Kernels { ConvertRgba8RowAvx512, ConvertRgba16FRowAvx512, AccumulateRowAvx512, WriteDifferenceRowAvx512 };
+    return Kernels;
+}
+
+#endif
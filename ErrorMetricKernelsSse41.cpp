@@ -0,0 +1,95 @@
+#include "ErrorMetricKernels.h"
+
+#if ERROR_METRIC_KERNELS_X86
+
+#include <cstring>
+#include <smmintrin.h>
+
+namespace {
+    void ConvertRgba8RowSse41(const uint8_t* Source, size_t Width, float* Destination) {
+        const __m128 Scale { _mm_set1_ps(1.0f / 255.0f) };
+        for (size_t X { 0 }; X < Width; ++X) {
+            int32_t Packed { 0 };
+            std::memcpy(&Packed, Source + X * 4, sizeof(Packed));
+            const __m128 Pixel { _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(Packed))) };
+            _mm_storeu_ps(Destination + X * 4, _mm_mul_ps(Pixel, Scale));
+        }
+    }
+
+    void AddHistogram(__m128 Difference, uint32_t* Histograms) {
+        const __m128 AbsoluteMask { _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)) };
+        const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_and_ps(Difference, AbsoluteMask), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+        const __m128i Bins { _mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))) };
+        ++Histograms[static_cast<uint32_t>(_mm_extract_epi32(Bins, 0))];
+        ++Histograms[ErrorHistogramBinCount + static_cast<uint32_t>(_mm_extract_epi32(Bins, 1))];
+        ++Histograms[ErrorHistogramBinCount * 2 + static_cast<uint32_t>(_mm_extract_epi32(Bins, 2))];
+        ++Histograms[ErrorHistogramBinCount * 3 + static_cast<uint32_t>(_mm_extract_epi32(Bins, 3))];
+    }
+
+    void AddToMoments(float* Moments, size_t Offset, __m128 Value) {
+        _mm_storeu_ps(Moments + Offset, _mm_add_ps(_mm_loadu_ps(Moments + Offset), Value));
+    }
+
+    void AccumulateRowSse41(const float* Reference, const float* Candidate, size_t Width, float* BlockMoments, double* SquaredErrorSums, uint32_t* Histograms) {
+        const size_t BlockCount { Width / ErrorMetricBlockSize };
+        __m128 SquaredError { _mm_setzero_ps() };
+        for (size_t Block { 0 }; Block < BlockCount; ++Block) {
+            __m128 SumX { _mm_setzero_ps() };
+            __m128 SumY { _mm_setzero_ps() };
+            __m128 SumXX { _mm_setzero_ps() };
+            __m128 SumYY { _mm_setzero_ps() };
+            __m128 SumXY { _mm_setzero_ps() };
+            for (size_t Pixel { 0 }; Pixel < ErrorMetricBlockSize; ++Pixel) {
+                const size_t Offset { (Block * ErrorMetricBlockSize + Pixel) * 4 };
+                const __m128 ValueX { _mm_loadu_ps(Reference + Offset) };
+                const __m128 ValueY { _mm_loadu_ps(Candidate + Offset) };
+                const __m128 Difference { _mm_sub_ps(ValueX, ValueY) };
+                SquaredError = _mm_add_ps(SquaredError, _mm_mul_ps(Difference, Difference));
+                AddHistogram(Difference, Histograms);
+                SumX = _mm_add_ps(SumX, ValueX);
+                SumY = _mm_add_ps(SumY, ValueY);
+                SumXX = _mm_add_ps(SumXX, _mm_mul_ps(ValueX, ValueX));
+                SumYY = _mm_add_ps(SumYY, _mm_mul_ps(ValueY, ValueY));
+                SumXY = _mm_add_ps(SumXY, _mm_mul_ps(ValueX, ValueY));
+            }
+            float* Moments { BlockMoments + Block * ErrorMetricMomentCount };
+            AddToMoments(Moments, 0, SumX);
+            AddToMoments(Moments, 4, SumY);
+            AddToMoments(Moments, 8, SumXX);
+            AddToMoments(Moments, 12, SumYY);
+            AddToMoments(Moments, 16, SumXY);
+        }
+        for (size_t X { BlockCount * ErrorMetricBlockSize }; X < Width; ++X) {
+            const __m128 Difference { _mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)) };
+            SquaredError = _mm_add_ps(SquaredError, _mm_mul_ps(Difference, Difference));
+            AddHistogram(Difference, Histograms);
+        }
+        alignas(16) float Sums[4] {};
+        _mm_store_ps(Sums, SquaredError);
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            SquaredErrorSums[Channel] += Sums[Channel];
+        }
+    }
+
+    void WriteDifferenceRowSse41(const float* Reference, const float* Candidate, size_t Width, float Gain, uint8_t* Destination) {
+        const __m128 AbsoluteMask { _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)) };
+        const __m128 GainVector { _mm_set1_ps(Gain) };
+        const __m128i OpaqueAlpha { _mm_set_epi32(255, 0, 0, 0) };
+        const __m128i ColorMask { _mm_set_epi32(0, -1, -1, -1) };
+        for (size_t X { 0 }; X < Width; ++X) {
+            const __m128 Difference { _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(Reference + X * 4), _mm_loadu_ps(Candidate + X * 4)), AbsoluteMask) };
+            const __m128 Scaled { _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Difference, GainVector), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)) };
+            const __m128i Values { _mm_or_si128(_mm_and_si128(_mm_cvttps_epi32(_mm_min_ps(Scaled, _mm_set1_ps(255.0f))), ColorMask), OpaqueAlpha) };
+            const __m128i Packed { _mm_packus_epi16(_mm_packus_epi32(Values, Values), _mm_setzero_si128()) };
+            const int32_t Pixel { _mm_cvtsi128_si32(Packed) };
+            std::memcpy(Destination + X * 4, &Pixel, sizeof(Pixel));
+        }
+    }
+}
+
+const ErrorMetricRowKernels& GetSse41ErrorMetricRowKernels() {
+    static const ErrorMetricRowKernels Kernels { ConvertRgba8RowSse41, GetScalarErrorMetricRowKernels().ConvertRgba16FRow, AccumulateRowSse41, WriteDifferenceRowSse41 };
+    return Kernels;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    mPath {},
+    mData { nullptr },
+    mSize { 0 },
+#ifdef _WIN32
+    mFileHandle { INVALID_HANDLE_VALUE },
+    mMappingHandle { nullptr } {
+#else
+    mFileDescriptor { -1 } {
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(const MappedFile& Other) :
+    MappedFile {} {
+    if (Other.IsOpen()) {
+        Open(Other.mPath);
+    }
+}
+
+MappedFile& MappedFile::operator=(const MappedFile& Other) {
+    if (this != &Other) {
+        Close();
+        if (Other.IsOpen()) {
+            Open(Other.mPath);
+        }
+    }
+    return *this;
+}
+
+MappedFile::MappedFile(MappedFile&& Other) noexcept :
+    MappedFile {} {
+    TakeFrom(Other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& Other) noexcept {
+    if (this != &Other) {
+        Close();
+        TakeFrom(Other);
+    }
+    return *this;
+}
+
+bool MappedFile::Open(const std::filesystem::path& FilePath) {
+    Close();
+#ifdef _WIN32
+    const HANDLE File { CreateFileW(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+    if (File == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER FileSize {};
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart <= 0) {
+        CloseHandle(File);
+        return false;
+    }
+    const HANDLE Mapping { CreateFileMappingW(File, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+    if (Mapping == nullptr) {
+        CloseHandle(File);
+        return false;
+    }
+    const void* View { MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0) };
+    if (View == nullptr) {
+        CloseHandle(Mapping);
+        CloseHandle(File);
+        return false;
+    }
+    mFileHandle = File;
+    mMappingHandle = Mapping;
+    mData = static_cast<const uint8_t*>(View);
+    mSize = static_cast<size_t>(FileSize.QuadPart);
+#else
+    const int FileDescriptor { open(FilePath.c_str(), O_RDONLY) };
+    if (FileDescriptor < 0) {
+        return false;
+    }
+    struct stat FileStatus {};
+    if (fstat(FileDescriptor, &FileStatus) != 0 || FileStatus.st_size <= 0) {
+        close(FileDescriptor);
+        return false;
+    }
+    void* View { mmap(nullptr, static_cast<size_t>(FileStatus.st_size), PROT_READ, MAP_PRIVATE, FileDescriptor, 0) };
+    if (View == MAP_FAILED) {
+        close(FileDescriptor);
+        return false;
+    }
+    mFileDescriptor = FileDescriptor;
+    mData = static_cast<const uint8_t*>(View);
+    mSize = static_cast<size_t>(FileStatus.st_size);
+#endif
+    mPath = FilePath;
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (mData != nullptr) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMappingHandle != nullptr) {
+        CloseHandle(mMappingHandle);
+    }
+    if (mFileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(mFileHandle);
+    }
+    mFileHandle = INVALID_HANDLE_VALUE;
+    mMappingHandle = nullptr;
+#else
+    if (mData != nullptr) {
+        munmap(const_cast<uint8_t*>(mData), mSize);
+    }
+    if (mFileDescriptor >= 0) {
+        close(mFileDescriptor);
+    }
+    mFileDescriptor = -1;
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mPath.clear();
+}
+
+bool MappedFile::IsOpen() const {
+    return mData != nullptr;
+}
+
+bool MappedFile::IsIntact() const {
+    if (mData == nullptr) {
+        return false;
+    }
+#ifdef _WIN32
+    LARGE_INTEGER FileSize {};
+    return GetFileSizeEx(mFileHandle, &FileSize) && static_cast<size_t>(FileSize.QuadPart) >= mSize;
+#else
+    struct stat FileStatus {};
+    return fstat(mFileDescriptor, &FileStatus) == 0 && static_cast<size_t>(FileStatus.st_size) >= mSize;
+#endif
+}
+
+const uint8_t* MappedFile::GetData() const {
+    return mData;
+}
+
+size_t MappedFile::GetSize() const {
+    return mSize;
+}
+
+const std::filesystem::path& MappedFile::GetPath() const {
+    return mPath;
+}
+
+void MappedFile::TakeFrom(MappedFile& Other) {
+    mPath = std::move(Other.mPath);
+    mData = Other.mData;
+    mSize = Other.mSize;
+#ifdef _WIN32
+    mFileHandle = Other.mFileHandle;
+    mMappingHandle = Other.mMappingHandle;
+    Other.mFileHandle = INVALID_HANDLE_VALUE;
+    Other.mMappingHandle = nullptr;
+#else
+    mFileDescriptor = Other.mFileDescriptor;
+    Other.mFileDescriptor = -1;
+#endif
+    Other.mData = nullptr;
+    Other.mSize = 0;
+    Other.mPath.clear();
+}
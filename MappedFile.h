@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile& Other);
+    MappedFile& operator=(const MappedFile& Other);
+    MappedFile(MappedFile&& Other) noexcept;
+    MappedFile& operator=(MappedFile&& Other) noexcept;
+
+public:
+    bool Open(const std::filesystem::path& FilePath);
+    void Close();
+    bool IsOpen() const;
+    bool IsIntact() const;
+    const uint8_t* GetData() const;
+    size_t GetSize() const;
+    const std::filesystem::path& GetPath() const;
+
+private:
+    void TakeFrom(MappedFile& Other);
+
+private:
+    std::filesystem::path mPath;
+    const uint8_t* mData;
+    size_t mSize;
+#ifdef _WIN32
+    void* mFileHandle;
+    void* mMappingHandle;
+#else
+    int mFileDescriptor;
+#endif
+};
@@ -0,0 +1,413 @@
+#include "BlockCompressionEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NATIVE_BC6H_ENCODER_X86 1
+#include <emmintrin.h>
+#else
+#define NATIVE_BC6H_ENCODER_X86 0
+#endif
+
+using namespace DirectX;
+
+namespace {
+#if NATIVE_BC6H_ENCODER_X86
+    constexpr size_t BlockDimension { 4 };
+    constexpr size_t BlockPixelCount { 16 };
+    constexpr size_t BlockBytes { 16 };
+    constexpr int32_t IndexCount { 16 };
+    constexpr int32_t AnchorIndexLimit { 8 };
+    constexpr uint32_t BaseFieldBits { 10 };
+    constexpr uint16_t MaximumHalf { 0x7BFF };
+    constexpr float LargeError { 1.0e30f };
+
+    constexpr int32_t Weights4[IndexCount] { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct Bc6hModeInfo {
+        uint32_t ModeBits;
+        uint32_t EndpointBits;
+        uint32_t DeltaBits;
+    };
+
+    constexpr Bc6hModeInfo SingleRegionModes[4] {
+        { 0x03, 10, 0 },
+        { 0x07, 11, 9 },
+        { 0x0B, 12, 8 },
+        { 0x0F, 16, 4 }
+    };
+
+    struct Bc6hSearchBudget {
+        size_t ModeCount;
+        uint32_t RefinementPasses;
+        bool ExhaustiveIndices;
+    };
+
+    constexpr Bc6hSearchBudget SearchBudgets[3] {
+        { 1, 0, false },
+        { 4, 1, false },
+        { 4, 3, true }
+    };
+
+    struct HdrBlock {
+        __m128 Values[BlockPixelCount];
+    };
+
+    struct HdrEncoding {
+        const Bc6hModeInfo* Mode;
+        int32_t Quantized[2][3];
+        uint8_t Indices[BlockPixelCount];
+        float Error;
+    };
+
+    struct BitWriter {
+        uint8_t* Data;
+        uint32_t Position;
+
+        void Write(uint32_t Value, uint32_t Bits) {
+            for (uint32_t Bit { 0 }; Bit < Bits; ++Bit, ++Position) {
+                if ((Value >> Bit) & 1u) {
+                    Data[Position / 8] = static_cast<uint8_t>(Data[Position / 8] | (1u << (Position % 8)));
+                }
+            }
+        }
+    };
+
+    float HorizontalSum(__m128 Value) {
+        const __m128 Pairs { _mm_add_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 0, 3, 2))) };
+        return _mm_cvtss_f32(_mm_add_ss(Pairs, _mm_shuffle_ps(Pairs, Pairs, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+
+    float Dot(__m128 Left, __m128 Right) {
+        return HorizontalSum(_mm_mul_ps(Left, Right));
+    }
+
+    __m128 Broadcast(__m128 Value, size_t Channel) {
+        switch (Channel) {
+        case 0:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(0, 0, 0, 0));
+        case 1:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 1, 1, 1));
+        default:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(2, 2, 2, 2));
+        }
+    }
+
+    float HalfToDomain(uint16_t Half, bool IsSigned) {
+        const int32_t Magnitude { std::min<int32_t>(Half & 0x7FFF, MaximumHalf) };
+        if ((Half & 0x8000) == 0) {
+            return static_cast<float>(Magnitude);
+        }
+        return IsSigned ? -static_cast<float>(Magnitude) : 0.0f;
+    }
+
+    int32_t Unquantize(int32_t Value, uint32_t Bits, bool IsSigned) {
+        if (!IsSigned) {
+            if (Bits >= 15 || Value == 0) {
+                return Value;
+            }
+            if (Value == (1 << Bits) - 1) {
+                return 0xFFFF;
+            }
+            return ((Value << 16) + 0x8000) >> Bits;
+        }
+        if (Bits >= 16) {
+            return Value;
+        }
+        const int32_t Magnitude { std::abs(Value) };
+        int32_t Result { 0 };
+        if (Magnitude >= (1 << (Bits - 1)) - 1) {
+            Result = 0x7FFF;
+        } else if (Magnitude != 0) {
+            Result = ((Magnitude << 15) + 0x4000) >> (Bits - 1);
+        }
+        return Value < 0 ? -Result : Result;
+    }
+
+    int32_t FinishUnquantize(int32_t Value, bool IsSigned) {
+        if (!IsSigned) {
+            return (Value * 31) >> 6;
+        }
+        return Value < 0 ? -(((-Value) * 31) >> 5) : (Value * 31) >> 5;
+    }
+
+    int32_t QuantizeChannel(float Value, uint32_t Bits, bool IsSigned) {
+        const float Interpolated { Value * (IsSigned ? 32.0f : 64.0f) / 31.0f };
+        const int32_t Maximum { IsSigned ? (1 << (Bits - 1)) - 1 : (1 << Bits) - 1 };
+        const int32_t Minimum { IsSigned ? -Maximum : 0 };
+        const float Range { IsSigned ? 32768.0f : 65536.0f };
+        const int32_t Guess { std::clamp(static_cast<int32_t>(std::floor(Interpolated * static_cast<float>(Maximum + 1) / Range)), Minimum, Maximum) };
+        int32_t Best { Guess };
+        float BestError { LargeError };
+        for (int32_t Candidate { std::max(Guess - 1, Minimum) }; Candidate <= std::min(Guess + 1, Maximum); ++Candidate) {
+            const float Error { std::fabs(static_cast<float>(Unquantize(Candidate, Bits, IsSigned)) - Interpolated) };
+            if (Error < BestError) {
+                BestError = Error;
+                Best = Candidate;
+            }
+        }
+        return Best;
+    }
+
+    void QuantizeEndpoints(__m128 Endpoint0, __m128 Endpoint1, const Bc6hModeInfo& Mode, bool IsSigned, HdrEncoding& Encoding) {
+        alignas(16) float Values[2][4] {};
+        _mm_store_ps(Values[0], Endpoint0);
+        _mm_store_ps(Values[1], Endpoint1);
+        for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+            const int32_t Base { QuantizeChannel(Values[0][Channel], Mode.EndpointBits, IsSigned) };
+            int32_t Other { QuantizeChannel(Values[1][Channel], Mode.EndpointBits, IsSigned) };
+            if (Mode.DeltaBits != 0) {
+                const int32_t DeltaLimit { 1 << (Mode.DeltaBits - 1) };
+                Other = Base + std::clamp(Other - Base, -DeltaLimit, DeltaLimit - 1);
+            }
+            Encoding.Quantized[0][Channel] = Base;
+            Encoding.Quantized[1][Channel] = Other;
+        }
+        Encoding.Mode = &Mode;
+    }
+
+    void EvaluateEncoding(const HdrBlock& Block, bool IsSigned, bool ExhaustiveIndices, HdrEncoding& Encoding) {
+        alignas(16) int32_t Endpoints[2][4] {};
+        for (size_t Endpoint { 0 }; Endpoint < 2; ++Endpoint) {
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                Endpoints[Endpoint][Channel] = Unquantize(Encoding.Quantized[Endpoint][Channel], Encoding.Mode->EndpointBits, IsSigned);
+            }
+        }
+        __m128 Palette[IndexCount] {};
+        for (int32_t Index { 0 }; Index < IndexCount; ++Index) {
+            alignas(16) float Entry[4] {};
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                const int32_t Interpolated { (Endpoints[0][Channel] * (64 - Weights4[Index]) + Endpoints[1][Channel] * Weights4[Index] + 32) >> 6 };
+                Entry[Channel] = static_cast<float>(FinishUnquantize(Interpolated, IsSigned));
+            }
+            Palette[Index] = _mm_load_ps(Entry);
+        }
+
+        const __m128 Direction { _mm_sub_ps(Palette[IndexCount - 1], Palette[0]) };
+        const float DirectionLength { Dot(Direction, Direction) };
+        const float IndexScale { DirectionLength > 0.0f ? static_cast<float>(IndexCount - 1) / DirectionLength : 0.0f };
+        float Error { 0.0f };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Value { Block.Values[Pixel] };
+            const int32_t Limit { Pixel == 0 ? AnchorIndexLimit - 1 : IndexCount - 1 };
+            const int32_t Guess { std::clamp(static_cast<int32_t>(Dot(_mm_sub_ps(Value, Palette[0]), Direction) * IndexScale + 0.5f), 0, Limit) };
+            const int32_t First { ExhaustiveIndices ? 0 : std::max(Guess - 1, 0) };
+            const int32_t Last { ExhaustiveIndices ? Limit : std::min(Guess + 1, Limit) };
+            float BestError { LargeError };
+            int32_t BestIndex { Guess };
+            for (int32_t Index { First }; Index <= Last; ++Index) {
+                const __m128 Difference { _mm_sub_ps(Value, Palette[Index]) };
+                const float Candidate { Dot(Difference, Difference) };
+                if (Candidate < BestError) {
+                    BestError = Candidate;
+                    BestIndex = Index;
+                }
+            }
+            Encoding.Indices[Pixel] = static_cast<uint8_t>(BestIndex);
+            Error += BestError;
+        }
+        Encoding.Error = Error;
+    }
+
+    void FitEndpoints(const HdrBlock& Block, __m128& Endpoint0Out, __m128& Endpoint1Out) {
+        __m128 Sum { _mm_setzero_ps() };
+        __m128 Minimum { Block.Values[0] };
+        __m128 Maximum { Block.Values[0] };
+        for (const __m128 Value : Block.Values) {
+            Sum = _mm_add_ps(Sum, Value);
+            Minimum = _mm_min_ps(Minimum, Value);
+            Maximum = _mm_max_ps(Maximum, Value);
+        }
+        const __m128 Mean { _mm_mul_ps(Sum, _mm_set1_ps(1.0f / static_cast<float>(BlockPixelCount))) };
+        __m128 Covariance[3] {};
+        for (const __m128 Value : Block.Values) {
+            const __m128 Delta { _mm_sub_ps(Value, Mean) };
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                Covariance[Channel] = _mm_add_ps(Covariance[Channel], _mm_mul_ps(Delta, Broadcast(Delta, Channel)));
+            }
+        }
+        __m128 Axis { _mm_sub_ps(Maximum, Minimum) };
+        for (uint32_t Iteration { 0 }; Iteration < 4; ++Iteration) {
+            const __m128 Next { _mm_add_ps(_mm_add_ps(_mm_mul_ps(Covariance[0], Broadcast(Axis, 0)), _mm_mul_ps(Covariance[1], Broadcast(Axis, 1))), _mm_mul_ps(Covariance[2], Broadcast(Axis, 2))) };
+            const float Length { std::sqrt(Dot(Next, Next)) };
+            if (Length <= 1.0e-6f) {
+                break;
+            }
+            Axis = _mm_mul_ps(Next, _mm_set1_ps(1.0f / Length));
+        }
+        const float AxisLength { std::sqrt(Dot(Axis, Axis)) };
+        Axis = AxisLength > 1.0e-6f ? _mm_mul_ps(Axis, _mm_set1_ps(1.0f / AxisLength)) : _mm_setzero_ps();
+
+        float MinimumProjection { 0.0f };
+        float MaximumProjection { 0.0f };
+        for (const __m128 Value : Block.Values) {
+            const float Projection { Dot(_mm_sub_ps(Value, Mean), Axis) };
+            MinimumProjection = std::min(MinimumProjection, Projection);
+            MaximumProjection = std::max(MaximumProjection, Projection);
+        }
+        Endpoint0Out = _mm_add_ps(Mean, _mm_mul_ps(Axis, _mm_set1_ps(MinimumProjection)));
+        Endpoint1Out = _mm_add_ps(Mean, _mm_mul_ps(Axis, _mm_set1_ps(MaximumProjection)));
+    }
+
+    bool RefitEndpoints(const HdrBlock& Block, const HdrEncoding& Current, __m128& Endpoint0Out, __m128& Endpoint1Out) {
+        float AlphaAlpha { 0.0f };
+        float BetaBeta { 0.0f };
+        float AlphaBeta { 0.0f };
+        __m128 AlphaValue { _mm_setzero_ps() };
+        __m128 BetaValue { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const float Beta { static_cast<float>(Weights4[Current.Indices[Pixel]]) / 64.0f };
+            const float Alpha { 1.0f - Beta };
+            AlphaAlpha += Alpha * Alpha;
+            BetaBeta += Beta * Beta;
+            AlphaBeta += Alpha * Beta;
+            AlphaValue = _mm_add_ps(AlphaValue, _mm_mul_ps(Block.Values[Pixel], _mm_set1_ps(Alpha)));
+            BetaValue = _mm_add_ps(BetaValue, _mm_mul_ps(Block.Values[Pixel], _mm_set1_ps(Beta)));
+        }
+        const float Determinant { AlphaAlpha * BetaBeta - AlphaBeta * AlphaBeta };
+        if (Determinant < 1.0e-6f) {
+            return false;
+        }
+        const __m128 InverseDeterminant { _mm_set1_ps(1.0f / Determinant) };
+        Endpoint0Out = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaValue, _mm_set1_ps(BetaBeta)), _mm_mul_ps(BetaValue, _mm_set1_ps(AlphaBeta))), InverseDeterminant);
+        Endpoint1Out = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaValue, _mm_set1_ps(AlphaAlpha)), _mm_mul_ps(AlphaValue, _mm_set1_ps(AlphaBeta))), InverseDeterminant);
+        return true;
+    }
+
+    void OrientEndpoints(const HdrBlock& Block, __m128& Endpoint0, __m128& Endpoint1) {
+        const __m128 Direction { _mm_sub_ps(Endpoint1, Endpoint0) };
+        const float DirectionLength { Dot(Direction, Direction) };
+        if (DirectionLength > 0.0f && Dot(_mm_sub_ps(Block.Values[0], Endpoint0), Direction) > 0.5f * DirectionLength) {
+            std::swap(Endpoint0, Endpoint1);
+        }
+    }
+
+    void ClampEndpoints(bool IsSigned, __m128& Endpoint0, __m128& Endpoint1) {
+        const __m128 Minimum { _mm_set1_ps(IsSigned ? -static_cast<float>(MaximumHalf) : 0.0f) };
+        const __m128 Maximum { _mm_set1_ps(static_cast<float>(MaximumHalf)) };
+        Endpoint0 = _mm_min_ps(_mm_max_ps(Endpoint0, Minimum), Maximum);
+        Endpoint1 = _mm_min_ps(_mm_max_ps(Endpoint1, Minimum), Maximum);
+    }
+
+    void EncodeMode(const HdrBlock& Block, const Bc6hModeInfo& Mode, bool IsSigned, const Bc6hSearchBudget& Budget, HdrEncoding& BestOut) {
+        __m128 Endpoint0 {};
+        __m128 Endpoint1 {};
+        FitEndpoints(Block, Endpoint0, Endpoint1);
+        HdrEncoding Current {};
+        for (uint32_t Pass { 0 }; Pass <= Budget.RefinementPasses; ++Pass) {
+            if (Pass != 0 && !RefitEndpoints(Block, Current, Endpoint0, Endpoint1)) {
+                break;
+            }
+            ClampEndpoints(IsSigned, Endpoint0, Endpoint1);
+            OrientEndpoints(Block, Endpoint0, Endpoint1);
+            QuantizeEndpoints(Endpoint0, Endpoint1, Mode, IsSigned, Current);
+            EvaluateEncoding(Block, IsSigned, Budget.ExhaustiveIndices, Current);
+            if (Current.Error < BestOut.Error) {
+                BestOut = Current;
+            }
+        }
+    }
+
+    void WriteBlock(const HdrEncoding& Encoding, uint8_t* Output) {
+        const Bc6hModeInfo& Mode { *Encoding.Mode };
+        const uint32_t BaseMask { (1u << Mode.EndpointBits) - 1 };
+        memset(Output, 0, BlockBytes);
+        BitWriter Writer { Output, 0 };
+        Writer.Write(Mode.ModeBits, 5);
+        for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+            Writer.Write(static_cast<uint32_t>(Encoding.Quantized[0][Channel]) & BaseMask, BaseFieldBits);
+        }
+        for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+            const uint32_t Base { static_cast<uint32_t>(Encoding.Quantized[0][Channel]) & BaseMask };
+            if (Mode.DeltaBits == 0) {
+                Writer.Write(static_cast<uint32_t>(Encoding.Quantized[1][Channel]) & BaseMask, BaseFieldBits);
+                continue;
+            }
+            Writer.Write(static_cast<uint32_t>(Encoding.Quantized[1][Channel] - Encoding.Quantized[0][Channel]) & ((1u << Mode.DeltaBits) - 1), Mode.DeltaBits);
+            for (uint32_t Bit { Mode.EndpointBits }; Bit-- > BaseFieldBits;) {
+                Writer.Write((Base >> Bit) & 1u, 1);
+            }
+        }
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            Writer.Write(Encoding.Indices[Pixel], Pixel == 0 ? 3 : 4);
+        }
+    }
+
+    void EncodeBc6hBlock(const HdrBlock& Block, bool IsSigned, const Bc6hSearchBudget& Budget, uint8_t* Output) {
+        HdrEncoding Best {};
+        Best.Error = LargeError;
+        for (size_t ModeIndex { 0 }; ModeIndex < Budget.ModeCount; ++ModeIndex) {
+            EncodeMode(Block, SingleRegionModes[ModeIndex], IsSigned, Budget, Best);
+        }
+        WriteBlock(Best, Output);
+    }
+
+    void GatherBlock(const Image& Source, size_t BlockColumn, size_t BlockRow, bool IsSigned, HdrBlock& BlockOut) {
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const size_t X { std::min(BlockColumn * BlockDimension + Pixel % BlockDimension, Source.width - 1) };
+            const size_t Y { std::min(BlockRow * BlockDimension + Pixel / BlockDimension, Source.height - 1) };
+            uint16_t Texel[4] {};
+            memcpy(Texel, Source.pixels + Y * Source.rowPitch + X * sizeof(Texel), sizeof(Texel));
+            BlockOut.Values[Pixel] = _mm_set_ps(0.0f, HalfToDomain(Texel[2], IsSigned), HalfToDomain(Texel[1], IsSigned), HalfToDomain(Texel[0], IsSigned));
+        }
+    }
+#endif
+
+    bool SupportsBc6hFormat(DXGI_FORMAT Format) {
+#if NATIVE_BC6H_ENCODER_X86
+        return Format == DXGI_FORMAT_BC6H_UF16 || Format == DXGI_FORMAT_BC6H_SF16;
+#else
+        (void)Format;
+        return false;
+#endif
+    }
+
+    bool EncodeBc6hImage(const Image& Source, const Image& Destination, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda) {
+        (void)Options;
+        (void)RdoLambda;
+#if NATIVE_BC6H_ENCODER_X86
+        if (!SupportsBc6hFormat(Destination.format) || Source.pixels == nullptr || Destination.pixels == nullptr || Source.width == 0 || Source.height == 0) {
+            return false;
+        }
+
+        ScratchImage Converted {};
+        const Image* Working { &Source };
+        if (Source.format != DXGI_FORMAT_R16G16B16A16_FLOAT) {
+            const HRESULT ConvertHr { Convert(Source, DXGI_FORMAT_R16G16B16A16_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Converted) };
+            if (FAILED(ConvertHr)) {
+                return false;
+            }
+            Working = Converted.GetImage(0, 0, 0);
+            if (Working == nullptr) {
+                return false;
+            }
+        }
+
+        const bool IsSigned { Destination.format == DXGI_FORMAT_BC6H_SF16 };
+        const Bc6hSearchBudget& Budget { SearchBudgets[std::min<uint32_t>(RefinementPasses, 2)] };
+        const size_t BlockColumns { (Working->width + BlockDimension - 1) / BlockDimension };
+        const size_t BlockRows { (Working->height + BlockDimension - 1) / BlockDimension };
+        HdrBlock Block {};
+        for (size_t BlockRow { 0 }; BlockRow < BlockRows; ++BlockRow) {
+            uint8_t* DestinationRow { Destination.pixels + BlockRow * Destination.rowPitch };
+            for (size_t BlockColumn { 0 }; BlockColumn < BlockColumns; ++BlockColumn) {
+                GatherBlock(*Working, BlockColumn, BlockRow, IsSigned, Block);
+                EncodeBc6hBlock(Block, IsSigned, Budget, DestinationRow + BlockColumn * BlockBytes);
+            }
+        }
+        return true;
+#else
+        (void)Source;
+        (void)Destination;
+        (void)RefinementPasses;
+        return false;
+#endif
+    }
+}
+
+const BlockEncoder& GetNativeBc6hBlockEncoder() {
+    static const BlockEncoder Encoder { BlockEncoderBackend::Native, "Native BC6H", SupportsBc6hFormat, EncodeBc6hImage };
+    return Encoder;
+}
@@ -0,0 +1,867 @@
+#include "BlockCompressionEncoder.h"
+#include "BlockRateModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NATIVE_BC7_ENCODER_X86 1
+#include <emmintrin.h>
+#else
+#define NATIVE_BC7_ENCODER_X86 0
+#endif
+
+using namespace DirectX;
+
+namespace {
+#if NATIVE_BC7_ENCODER_X86
+    constexpr size_t BlockDimension { 4 };
+    constexpr size_t BlockPixelCount { 16 };
+    constexpr size_t PartitionCount { 64 };
+    constexpr size_t BlockBytes { 16 };
+    constexpr float LargeError { 1.0e30f };
+
+    constexpr uint16_t PartitionMasks[PartitionCount] {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+    };
+
+    constexpr uint8_t SecondSubsetAnchors[PartitionCount] {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+        6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+    };
+
+    constexpr int32_t Weights2[4] { 0, 21, 43, 64 };
+    constexpr int32_t Weights3[8] { 0, 9, 18, 27, 37, 46, 55, 64 };
+    constexpr int32_t Weights4[16] { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    enum class PBitMode {
+        None,
+        Shared,
+        Unique
+    };
+
+    struct SubsetFormat {
+        bool IncludeColor;
+        bool IncludeAlpha;
+        uint32_t ColorBits;
+        uint32_t AlphaBits;
+        PBitMode PBits;
+        uint32_t IndexBits;
+    };
+
+    struct Bc7SearchBudget {
+        uint32_t OpaqueModeMask;
+        uint32_t AlphaModeMask;
+        uint32_t PartitionCandidates;
+        uint32_t RefinementPasses;
+        bool TryBothIndexSelections;
+        float EarlyOutError;
+    };
+
+    constexpr Bc7SearchBudget SearchBudgets[3] {
+        { 1u << 6, (1u << 6) | (1u << 5), 0, 1, false, 0.0f },
+        { (1u << 6) | (1u << 1) | (1u << 3), (1u << 6) | (1u << 5) | (1u << 7), 4, 1, false, 16.0f },
+        { (1u << 6) | (1u << 1) | (1u << 3) | (1u << 5), (1u << 6) | (1u << 5) | (1u << 4) | (1u << 7), 16, 2, true, 4.0f }
+    };
+
+    struct BlockPixels {
+        __m128 Values[BlockPixelCount];
+        bool IsOpaque;
+    };
+
+    struct QuantizedEndpoint {
+        int32_t Values[4];
+        int32_t PBit;
+        __m128 Expanded;
+    };
+
+    struct SubsetEncoding {
+        QuantizedEndpoint Endpoints[2];
+        uint8_t Indices[BlockPixelCount];
+        float Error;
+    };
+
+    struct Bc7Candidate {
+        uint32_t Mode;
+        uint32_t Partition;
+        uint32_t IndexSelection;
+        SubsetEncoding Subsets[2];
+        float Error;
+    };
+
+    struct QuantizationGrid {
+        __m128 Scale;
+        __m128 Maximum;
+        __m128 ExpandHigh;
+        __m128 ExpandLow;
+        __m128 ChannelMask;
+        __m128 Fill;
+        bool HasPBit;
+    };
+
+    struct PartitionMoments {
+        __m128 Values[BlockPixelCount];
+        __m128 Products[BlockPixelCount][4];
+        __m128 TotalValue;
+        __m128 TotalProducts[4];
+    };
+
+    struct BitWriter {
+        uint8_t* Data;
+        uint32_t Position;
+
+        void Write(uint32_t Value, uint32_t Bits) {
+            for (uint32_t Bit { 0 }; Bit < Bits; ++Bit, ++Position) {
+                if ((Value >> Bit) & 1u) {
+                    Data[Position / 8] = static_cast<uint8_t>(Data[Position / 8] | (1u << (Position % 8)));
+                }
+            }
+        }
+    };
+
+    struct BitReader {
+        const uint8_t* Data;
+        uint32_t Position;
+
+        uint32_t Read(uint32_t Bits) {
+            uint32_t Value { 0 };
+            for (uint32_t Bit { 0 }; Bit < Bits; ++Bit, ++Position) {
+                Value |= static_cast<uint32_t>((Data[Position / 8] >> (Position % 8)) & 1u) << Bit;
+            }
+            return Value;
+        }
+    };
+
+    const int32_t* GetWeights(uint32_t IndexBits) {
+        return IndexBits == 2 ? Weights2 : IndexBits == 3 ? Weights3 : Weights4;
+    }
+
+    float HorizontalSum(__m128 Value) {
+        const __m128 Pairs { _mm_add_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 0, 3, 2))) };
+        return _mm_cvtss_f32(_mm_add_ss(Pairs, _mm_shuffle_ps(Pairs, Pairs, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+
+    float Dot(__m128 Left, __m128 Right) {
+        return HorizontalSum(_mm_mul_ps(Left, Right));
+    }
+
+    __m128 Clamp(__m128 Value) {
+        return _mm_min_ps(_mm_max_ps(Value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    }
+
+    __m128 BuildChannelMask(const SubsetFormat& Format) {
+        const float Color { Format.IncludeColor ? 1.0f : 0.0f };
+        return _mm_set_ps(Format.IncludeAlpha ? 1.0f : 0.0f, Color, Color, Color);
+    }
+
+    QuantizationGrid BuildQuantizationGrid(const SubsetFormat& Format) {
+        const uint32_t PBitCount { Format.PBits == PBitMode::None ? 0u : 1u };
+        alignas(16) float Scale[4] {};
+        alignas(16) float Maximum[4] {};
+        alignas(16) float ExpandHigh[4] {};
+        alignas(16) float ExpandLow[4] {};
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            const bool IsAlpha { Channel == 3 };
+            if (IsAlpha ? !Format.IncludeAlpha : !Format.IncludeColor) {
+                continue;
+            }
+            const uint32_t Bits { IsAlpha ? Format.AlphaBits : Format.ColorBits };
+            const uint32_t TotalBits { Bits + PBitCount };
+            Scale[Channel] = static_cast<float>((1u << TotalBits) - 1) / 255.0f;
+            Maximum[Channel] = static_cast<float>((1u << Bits) - 1);
+            ExpandHigh[Channel] = static_cast<float>(1u << (8 - TotalBits));
+            ExpandLow[Channel] = TotalBits >= 8 ? 0.0f : 1.0f / static_cast<float>(1u << (2 * TotalBits - 8));
+        }
+        const __m128 ChannelMask { BuildChannelMask(Format) };
+        return QuantizationGrid {
+            _mm_load_ps(Scale),
+            _mm_load_ps(Maximum),
+            _mm_load_ps(ExpandHigh),
+            _mm_load_ps(ExpandLow),
+            ChannelMask,
+            _mm_set_ps(Format.IncludeAlpha ? 0.0f : 255.0f, 0.0f, 0.0f, 0.0f),
+            PBitCount != 0
+        };
+    }
+
+    float QuantizeEndpoint(__m128 Value, const QuantizationGrid& Grid, int32_t PBit, QuantizedEndpoint& EndpointOut) {
+        const __m128 Source { Clamp(Value) };
+        const __m128 PBitValue { _mm_set1_ps(static_cast<float>(PBit)) };
+        const __m128 Scaled { _mm_mul_ps(Source, Grid.Scale) };
+        const __m128 Target { Grid.HasPBit ? _mm_mul_ps(_mm_sub_ps(Scaled, PBitValue), _mm_set1_ps(0.5f)) : Scaled };
+        const __m128i QuantizedInteger { _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(Target, _mm_setzero_ps()), Grid.Maximum)) };
+        const __m128 Quantized { _mm_cvtepi32_ps(QuantizedInteger) };
+        const __m128 Full { Grid.HasPBit ? _mm_add_ps(_mm_add_ps(Quantized, Quantized), PBitValue) : Quantized };
+        const __m128 Low { _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(Full, Grid.ExpandLow))) };
+        const __m128 Expanded { _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(Full, Grid.ExpandHigh), Low), Grid.ChannelMask), Grid.Fill) };
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(EndpointOut.Values), QuantizedInteger);
+        EndpointOut.PBit = PBit;
+        EndpointOut.Expanded = Expanded;
+        const __m128 Difference { _mm_mul_ps(_mm_sub_ps(Expanded, Source), Grid.ChannelMask) };
+        return Dot(Difference, Difference);
+    }
+
+    void QuantizeEndpoints(__m128 Endpoint0, __m128 Endpoint1, const SubsetFormat& Format, QuantizedEndpoint* EndpointsOut) {
+        const QuantizationGrid Grid { BuildQuantizationGrid(Format) };
+        if (Format.PBits == PBitMode::None) {
+            QuantizeEndpoint(Endpoint0, Grid, 0, EndpointsOut[0]);
+            QuantizeEndpoint(Endpoint1, Grid, 0, EndpointsOut[1]);
+            return;
+        }
+        QuantizedEndpoint Candidates[2][2] {};
+        float Errors[2][2] {};
+        for (int32_t PBit { 0 }; PBit < 2; ++PBit) {
+            Errors[0][PBit] = QuantizeEndpoint(Endpoint0, Grid, PBit, Candidates[0][PBit]);
+            Errors[1][PBit] = QuantizeEndpoint(Endpoint1, Grid, PBit, Candidates[1][PBit]);
+        }
+        if (Format.PBits == PBitMode::Shared) {
+            const int32_t PBit { Errors[0][1] + Errors[1][1] < Errors[0][0] + Errors[1][0] ? 1 : 0 };
+            EndpointsOut[0] = Candidates[0][PBit];
+            EndpointsOut[1] = Candidates[1][PBit];
+            return;
+        }
+        const __m128 Endpoints[2] { Endpoint0, Endpoint1 };
+        for (size_t Endpoint { 0 }; Endpoint < 2; ++Endpoint) {
+            const bool IsOpaque { Format.IncludeAlpha && _mm_cvtss_f32(_mm_shuffle_ps(Endpoints[Endpoint], Endpoints[Endpoint], _MM_SHUFFLE(3, 3, 3, 3))) >= 254.5f };
+            EndpointsOut[Endpoint] = Candidates[Endpoint][IsOpaque || Errors[Endpoint][1] < Errors[Endpoint][0] ? 1 : 0];
+        }
+    }
+
+    void EvaluateSubset(const BlockPixels& Pixels, uint16_t PixelMask, const SubsetFormat& Format, SubsetEncoding& Encoding) {
+        const uint32_t PaletteSize { 1u << Format.IndexBits };
+        const int32_t* Weights { GetWeights(Format.IndexBits) };
+        const __m128 ChannelMask { BuildChannelMask(Format) };
+        const __m128 Endpoint0 { Encoding.Endpoints[0].Expanded };
+        const __m128 Endpoint1 { Encoding.Endpoints[1].Expanded };
+        __m128 Palette[16] {};
+        for (uint32_t Index { 0 }; Index < PaletteSize; ++Index) {
+            const __m128 Blend { _mm_add_ps(_mm_add_ps(_mm_mul_ps(Endpoint0, _mm_set1_ps(static_cast<float>(64 - Weights[Index]))), _mm_mul_ps(Endpoint1, _mm_set1_ps(static_cast<float>(Weights[Index])))), _mm_set1_ps(32.0f)) };
+            Palette[Index] = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(Blend, _mm_set1_ps(1.0f / 64.0f))));
+        }
+
+        const __m128 Direction { _mm_mul_ps(_mm_sub_ps(Endpoint1, Endpoint0), ChannelMask) };
+        const float DirectionLength { Dot(Direction, Direction) };
+        const float IndexScale { DirectionLength > 0.0f ? static_cast<float>(PaletteSize - 1) / DirectionLength : 0.0f };
+        float Error { 0.0f };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) == 0) {
+                continue;
+            }
+            const __m128 Value { Pixels.Values[Pixel] };
+            const int32_t Guess { std::clamp(static_cast<int32_t>(Dot(_mm_sub_ps(Value, Endpoint0), Direction) * IndexScale + 0.5f), 0, static_cast<int32_t>(PaletteSize) - 1) };
+            const int32_t First { std::max(Guess - 1, 0) };
+            const int32_t Last { std::min(Guess + 1, static_cast<int32_t>(PaletteSize) - 1) };
+            float BestError { LargeError };
+            int32_t BestIndex { Guess };
+            for (int32_t Index { First }; Index <= Last; ++Index) {
+                const __m128 Difference { _mm_mul_ps(_mm_sub_ps(Value, Palette[Index]), ChannelMask) };
+                const float Candidate { Dot(Difference, Difference) };
+                if (Candidate < BestError) {
+                    BestError = Candidate;
+                    BestIndex = Index;
+                }
+            }
+            Encoding.Indices[Pixel] = static_cast<uint8_t>(BestIndex);
+            Error += BestError;
+        }
+        Encoding.Error = Error;
+    }
+
+    __m128 Broadcast(__m128 Value, size_t Channel) {
+        switch (Channel) {
+        case 0:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(0, 0, 0, 0));
+        case 1:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 1, 1, 1));
+        case 2:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(2, 2, 2, 2));
+        default:
+            return _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+
+    void ComputeCovariance(const BlockPixels& Pixels, uint16_t PixelMask, __m128 ChannelMask, __m128& MeanOut, __m128* CovarianceOut, __m128& ExtentOut) {
+        __m128 Sum { _mm_setzero_ps() };
+        __m128 Minimum { _mm_set1_ps(255.0f) };
+        __m128 Maximum { _mm_setzero_ps() };
+        float Count { 0.0f };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) != 0) {
+                Sum = _mm_add_ps(Sum, Pixels.Values[Pixel]);
+                Minimum = _mm_min_ps(Minimum, Pixels.Values[Pixel]);
+                Maximum = _mm_max_ps(Maximum, Pixels.Values[Pixel]);
+                Count += 1.0f;
+            }
+        }
+        MeanOut = _mm_mul_ps(Sum, _mm_set1_ps(1.0f / std::max(Count, 1.0f)));
+        ExtentOut = _mm_mul_ps(_mm_sub_ps(Maximum, Minimum), ChannelMask);
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            CovarianceOut[Channel] = _mm_setzero_ps();
+        }
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) == 0) {
+                continue;
+            }
+            const __m128 Delta { _mm_mul_ps(_mm_sub_ps(Pixels.Values[Pixel], MeanOut), ChannelMask) };
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                CovarianceOut[Channel] = _mm_add_ps(CovarianceOut[Channel], _mm_mul_ps(Delta, Broadcast(Delta, Channel)));
+            }
+        }
+    }
+
+    __m128 MultiplyCovariance(const __m128* Covariance, __m128 Vector) {
+        __m128 Result { _mm_mul_ps(Covariance[0], Broadcast(Vector, 0)) };
+        Result = _mm_add_ps(Result, _mm_mul_ps(Covariance[1], Broadcast(Vector, 1)));
+        Result = _mm_add_ps(Result, _mm_mul_ps(Covariance[2], Broadcast(Vector, 2)));
+        return _mm_add_ps(Result, _mm_mul_ps(Covariance[3], Broadcast(Vector, 3)));
+    }
+
+    __m128 FindPrincipalAxis(const __m128* Covariance, __m128 Initial, uint32_t Iterations) {
+        __m128 Axis { Initial };
+        for (uint32_t Iteration { 0 }; Iteration < Iterations; ++Iteration) {
+            const __m128 Next { MultiplyCovariance(Covariance, Axis) };
+            const float Length { std::sqrt(Dot(Next, Next)) };
+            if (Length <= 1.0e-6f) {
+                break;
+            }
+            Axis = _mm_mul_ps(Next, _mm_set1_ps(1.0f / Length));
+        }
+        const float Length { std::sqrt(Dot(Axis, Axis)) };
+        return Length > 1.0e-6f ? _mm_mul_ps(Axis, _mm_set1_ps(1.0f / Length)) : _mm_setzero_ps();
+    }
+
+    void FitSubset(const BlockPixels& Pixels, uint16_t PixelMask, const SubsetFormat& Format, __m128& Endpoint0Out, __m128& Endpoint1Out) {
+        const __m128 ChannelMask { BuildChannelMask(Format) };
+        __m128 Mean {};
+        __m128 Covariance[4] {};
+        __m128 Extent {};
+        ComputeCovariance(Pixels, PixelMask, ChannelMask, Mean, Covariance, Extent);
+        const __m128 Axis { FindPrincipalAxis(Covariance, Extent, 4) };
+        float MinimumProjection { LargeError };
+        float MaximumProjection { -LargeError };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) == 0) {
+                continue;
+            }
+            const float Projection { Dot(_mm_sub_ps(Pixels.Values[Pixel], Mean), Axis) };
+            MinimumProjection = std::min(MinimumProjection, Projection);
+            MaximumProjection = std::max(MaximumProjection, Projection);
+        }
+        if (MinimumProjection > MaximumProjection) {
+            MinimumProjection = 0.0f;
+            MaximumProjection = 0.0f;
+        }
+        Endpoint0Out = Clamp(_mm_add_ps(Mean, _mm_mul_ps(Axis, _mm_set1_ps(MinimumProjection))));
+        Endpoint1Out = Clamp(_mm_add_ps(Mean, _mm_mul_ps(Axis, _mm_set1_ps(MaximumProjection))));
+    }
+
+    bool RefitSubset(const BlockPixels& Pixels, uint16_t PixelMask, const SubsetFormat& Format, const SubsetEncoding& Current, __m128& Endpoint0Out, __m128& Endpoint1Out) {
+        const int32_t* Weights { GetWeights(Format.IndexBits) };
+        float AlphaAlpha { 0.0f };
+        float BetaBeta { 0.0f };
+        float AlphaBeta { 0.0f };
+        __m128 AlphaValue { _mm_setzero_ps() };
+        __m128 BetaValue { _mm_setzero_ps() };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) == 0) {
+                continue;
+            }
+            const float Beta { static_cast<float>(Weights[Current.Indices[Pixel]]) / 64.0f };
+            const float Alpha { 1.0f - Beta };
+            AlphaAlpha += Alpha * Alpha;
+            BetaBeta += Beta * Beta;
+            AlphaBeta += Alpha * Beta;
+            AlphaValue = _mm_add_ps(AlphaValue, _mm_mul_ps(Pixels.Values[Pixel], _mm_set1_ps(Alpha)));
+            BetaValue = _mm_add_ps(BetaValue, _mm_mul_ps(Pixels.Values[Pixel], _mm_set1_ps(Beta)));
+        }
+        const float Determinant { AlphaAlpha * BetaBeta - AlphaBeta * AlphaBeta };
+        if (Determinant < 1.0e-6f) {
+            return false;
+        }
+        const __m128 InverseDeterminant { _mm_set1_ps(1.0f / Determinant) };
+        Endpoint0Out = Clamp(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaValue, _mm_set1_ps(BetaBeta)), _mm_mul_ps(BetaValue, _mm_set1_ps(AlphaBeta))), InverseDeterminant));
+        Endpoint1Out = Clamp(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaValue, _mm_set1_ps(AlphaAlpha)), _mm_mul_ps(AlphaValue, _mm_set1_ps(AlphaBeta))), InverseDeterminant));
+        return true;
+    }
+
+    float EncodeSubset(const BlockPixels& Pixels, uint16_t PixelMask, const SubsetFormat& Format, uint32_t RefinementPasses, SubsetEncoding& BestOut) {
+        __m128 Endpoint0 {};
+        __m128 Endpoint1 {};
+        FitSubset(Pixels, PixelMask, Format, Endpoint0, Endpoint1);
+        QuantizeEndpoints(Endpoint0, Endpoint1, Format, BestOut.Endpoints);
+        EvaluateSubset(Pixels, PixelMask, Format, BestOut);
+        SubsetEncoding Current { BestOut };
+        for (uint32_t Pass { 0 }; Pass < RefinementPasses; ++Pass) {
+            if (!RefitSubset(Pixels, PixelMask, Format, Current, Endpoint0, Endpoint1)) {
+                break;
+            }
+            QuantizeEndpoints(Endpoint0, Endpoint1, Format, Current.Endpoints);
+            EvaluateSubset(Pixels, PixelMask, Format, Current);
+            if (Current.Error < BestOut.Error) {
+                BestOut = Current;
+            }
+        }
+        return BestOut.Error;
+    }
+
+    void ComputePartitionMoments(const BlockPixels& Pixels, __m128 ChannelMask, PartitionMoments& MomentsOut) {
+        MomentsOut.TotalValue = _mm_setzero_ps();
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            MomentsOut.TotalProducts[Channel] = _mm_setzero_ps();
+        }
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Value { _mm_mul_ps(Pixels.Values[Pixel], ChannelMask) };
+            MomentsOut.Values[Pixel] = Value;
+            MomentsOut.TotalValue = _mm_add_ps(MomentsOut.TotalValue, Value);
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                MomentsOut.Products[Pixel][Channel] = _mm_mul_ps(Value, Broadcast(Value, Channel));
+                MomentsOut.TotalProducts[Channel] = _mm_add_ps(MomentsOut.TotalProducts[Channel], MomentsOut.Products[Pixel][Channel]);
+            }
+        }
+    }
+
+    float EstimateSubsetError(__m128 Sum, const __m128* Products, float Count) {
+        const __m128 Mean { _mm_mul_ps(Sum, _mm_set1_ps(1.0f / Count)) };
+        __m128 Scatter[4] {};
+        alignas(16) float Diagonal[4] {};
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            Scatter[Channel] = _mm_sub_ps(Products[Channel], _mm_mul_ps(Sum, Broadcast(Mean, Channel)));
+            alignas(16) float Row[4] {};
+            _mm_store_ps(Row, Scatter[Channel]);
+            Diagonal[Channel] = Row[Channel];
+        }
+        const size_t Dominant { static_cast<size_t>(std::max_element(Diagonal, Diagonal + 4) - Diagonal) };
+        const __m128 Axis { FindPrincipalAxis(Scatter, Scatter[Dominant], 2) };
+        const float Trace { Diagonal[0] + Diagonal[1] + Diagonal[2] + Diagonal[3] };
+        return std::max(Trace - Dot(Axis, MultiplyCovariance(Scatter, Axis)), 0.0f);
+    }
+
+    float EstimatePartitionError(const PartitionMoments& Moments, uint16_t SecondMask) {
+        __m128 SecondValue { _mm_setzero_ps() };
+        __m128 SecondProducts[4] {};
+        float SecondCount { 0.0f };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((SecondMask >> Pixel) & 1u) == 0) {
+                continue;
+            }
+            SecondValue = _mm_add_ps(SecondValue, Moments.Values[Pixel]);
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                SecondProducts[Channel] = _mm_add_ps(SecondProducts[Channel], Moments.Products[Pixel][Channel]);
+            }
+            SecondCount += 1.0f;
+        }
+        __m128 FirstProducts[4] {};
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            FirstProducts[Channel] = _mm_sub_ps(Moments.TotalProducts[Channel], SecondProducts[Channel]);
+        }
+        const float FirstCount { static_cast<float>(BlockPixelCount) - SecondCount };
+        return EstimateSubsetError(_mm_sub_ps(Moments.TotalValue, SecondValue), FirstProducts, FirstCount) + EstimateSubsetError(SecondValue, SecondProducts, SecondCount);
+    }
+
+    void SelectPartitions(const BlockPixels& Pixels, bool IncludeAlpha, uint32_t CandidateCount, uint32_t* PartitionsOut) {
+        PartitionMoments Moments {};
+        ComputePartitionMoments(Pixels, _mm_set_ps(IncludeAlpha ? 1.0f : 0.0f, 1.0f, 1.0f, 1.0f), Moments);
+        float Estimates[PartitionCount] {};
+        uint32_t Order[PartitionCount] {};
+        for (uint32_t Partition { 0 }; Partition < PartitionCount; ++Partition) {
+            Estimates[Partition] = EstimatePartitionError(Moments, PartitionMasks[Partition]);
+            Order[Partition] = Partition;
+        }
+        std::partial_sort(Order, Order + CandidateCount, Order + PartitionCount, [&Estimates](uint32_t Left, uint32_t Right) { return Estimates[Left] < Estimates[Right]; });
+        std::copy(Order, Order + CandidateCount, PartitionsOut);
+    }
+
+    SubsetFormat GetTwoSubsetFormat(uint32_t Mode) {
+        switch (Mode) {
+        case 1:
+            return SubsetFormat { true, false, 6, 0, PBitMode::Shared, 3 };
+        case 3:
+            return SubsetFormat { true, false, 7, 0, PBitMode::Unique, 2 };
+        default:
+            return SubsetFormat { true, true, 5, 5, PBitMode::Unique, 2 };
+        }
+    }
+
+    void EncodeSingleSubsetMode(const BlockPixels& Pixels, const Bc7SearchBudget& Budget, Bc7Candidate& Candidate) {
+        const SubsetFormat Format { true, true, 7, 7, PBitMode::Unique, 4 };
+        Candidate.Mode = 6;
+        Candidate.Partition = 0;
+        Candidate.IndexSelection = 0;
+        Candidate.Error = EncodeSubset(Pixels, 0xFFFF, Format, Budget.RefinementPasses, Candidate.Subsets[0]);
+    }
+
+    void EncodeSeparateAlphaMode(const BlockPixels& Pixels, uint32_t Mode, uint32_t IndexSelection, const Bc7SearchBudget& Budget, Bc7Candidate& Candidate) {
+        const bool IsMode4 { Mode == 4 };
+        const uint32_t ColorIndexBits { IsMode4 && IndexSelection == 1 ? 3u : 2u };
+        const uint32_t AlphaIndexBits { IsMode4 && IndexSelection == 0 ? 3u : 2u };
+        const SubsetFormat ColorFormat { true, false, IsMode4 ? 5u : 7u, 0, PBitMode::None, ColorIndexBits };
+        const SubsetFormat AlphaFormat { false, true, 0, IsMode4 ? 6u : 8u, PBitMode::None, AlphaIndexBits };
+        Candidate.Mode = Mode;
+        Candidate.Partition = 0;
+        Candidate.IndexSelection = IndexSelection;
+        Candidate.Error = EncodeSubset(Pixels, 0xFFFF, ColorFormat, Budget.RefinementPasses, Candidate.Subsets[0]);
+        Candidate.Error += EncodeSubset(Pixels, 0xFFFF, AlphaFormat, Budget.RefinementPasses, Candidate.Subsets[1]);
+    }
+
+    void EncodeTwoSubsetMode(const BlockPixels& Pixels, uint32_t Mode, uint32_t Partition, const Bc7SearchBudget& Budget, Bc7Candidate& Candidate) {
+        const SubsetFormat Format { GetTwoSubsetFormat(Mode) };
+        const uint16_t SecondMask { PartitionMasks[Partition] };
+        Candidate.Mode = Mode;
+        Candidate.Partition = Partition;
+        Candidate.IndexSelection = 0;
+        Candidate.Error = EncodeSubset(Pixels, static_cast<uint16_t>(~SecondMask), Format, Budget.RefinementPasses, Candidate.Subsets[0]);
+        Candidate.Error += EncodeSubset(Pixels, SecondMask, Format, Budget.RefinementPasses, Candidate.Subsets[1]);
+    }
+
+    void FixAnchor(SubsetEncoding& Encoding, uint16_t PixelMask, uint32_t AnchorPixel, uint32_t IndexBits) {
+        const uint32_t PaletteSize { 1u << IndexBits };
+        if (Encoding.Indices[AnchorPixel] < PaletteSize / 2) {
+            return;
+        }
+        std::swap(Encoding.Endpoints[0], Encoding.Endpoints[1]);
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (((PixelMask >> Pixel) & 1u) != 0) {
+                Encoding.Indices[Pixel] = static_cast<uint8_t>(PaletteSize - 1 - Encoding.Indices[Pixel]);
+            }
+        }
+    }
+
+    void WriteIndices(BitWriter& Writer, const SubsetEncoding& Encoding, uint32_t IndexBits) {
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            Writer.Write(Encoding.Indices[Pixel], Pixel == 0 ? IndexBits - 1 : IndexBits);
+        }
+    }
+
+    void WriteBc7Block(Bc7Candidate& Candidate, uint8_t* Output) {
+        memset(Output, 0, BlockBytes);
+        BitWriter Writer { Output, 0 };
+        Writer.Write(1u << Candidate.Mode, Candidate.Mode + 1);
+        if (Candidate.Mode == 6) {
+            SubsetEncoding& Subset { Candidate.Subsets[0] };
+            FixAnchor(Subset, 0xFFFF, 0, 4);
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                Writer.Write(static_cast<uint32_t>(Subset.Endpoints[0].Values[Channel]), 7);
+                Writer.Write(static_cast<uint32_t>(Subset.Endpoints[1].Values[Channel]), 7);
+            }
+            Writer.Write(static_cast<uint32_t>(Subset.Endpoints[0].PBit), 1);
+            Writer.Write(static_cast<uint32_t>(Subset.Endpoints[1].PBit), 1);
+            WriteIndices(Writer, Subset, 4);
+            return;
+        }
+        if (Candidate.Mode == 4 || Candidate.Mode == 5) {
+            const bool IsMode4 { Candidate.Mode == 4 };
+            SubsetEncoding& Color { Candidate.Subsets[0] };
+            SubsetEncoding& Alpha { Candidate.Subsets[1] };
+            const uint32_t ColorIndexBits { IsMode4 && Candidate.IndexSelection == 1 ? 3u : 2u };
+            const uint32_t AlphaIndexBits { IsMode4 && Candidate.IndexSelection == 0 ? 3u : 2u };
+            FixAnchor(Color, 0xFFFF, 0, ColorIndexBits);
+            FixAnchor(Alpha, 0xFFFF, 0, AlphaIndexBits);
+            Writer.Write(0, 2);
+            if (IsMode4) {
+                Writer.Write(Candidate.IndexSelection, 1);
+            }
+            const uint32_t ColorBits { IsMode4 ? 5u : 7u };
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                Writer.Write(static_cast<uint32_t>(Color.Endpoints[0].Values[Channel]), ColorBits);
+                Writer.Write(static_cast<uint32_t>(Color.Endpoints[1].Values[Channel]), ColorBits);
+            }
+            Writer.Write(static_cast<uint32_t>(Alpha.Endpoints[0].Values[3]), IsMode4 ? 6u : 8u);
+            Writer.Write(static_cast<uint32_t>(Alpha.Endpoints[1].Values[3]), IsMode4 ? 6u : 8u);
+            const bool ColorFirst { ColorIndexBits <= AlphaIndexBits };
+            WriteIndices(Writer, ColorFirst ? Color : Alpha, ColorFirst ? ColorIndexBits : AlphaIndexBits);
+            WriteIndices(Writer, ColorFirst ? Alpha : Color, ColorFirst ? AlphaIndexBits : ColorIndexBits);
+            return;
+        }
+
+        const SubsetFormat Format { GetTwoSubsetFormat(Candidate.Mode) };
+        const uint16_t SecondMask { PartitionMasks[Candidate.Partition] };
+        const uint32_t SecondAnchor { SecondSubsetAnchors[Candidate.Partition] };
+        FixAnchor(Candidate.Subsets[0], static_cast<uint16_t>(~SecondMask), 0, Format.IndexBits);
+        FixAnchor(Candidate.Subsets[1], SecondMask, SecondAnchor, Format.IndexBits);
+        Writer.Write(Candidate.Partition, 6);
+        const size_t ChannelCount { Format.IncludeAlpha ? size_t { 4 } : size_t { 3 } };
+        for (size_t Channel { 0 }; Channel < ChannelCount; ++Channel) {
+            for (const SubsetEncoding& Subset : Candidate.Subsets) {
+                Writer.Write(static_cast<uint32_t>(Subset.Endpoints[0].Values[Channel]), Channel == 3 ? Format.AlphaBits : Format.ColorBits);
+                Writer.Write(static_cast<uint32_t>(Subset.Endpoints[1].Values[Channel]), Channel == 3 ? Format.AlphaBits : Format.ColorBits);
+            }
+        }
+        for (const SubsetEncoding& Subset : Candidate.Subsets) {
+            Writer.Write(static_cast<uint32_t>(Subset.Endpoints[0].PBit), 1);
+            if (Format.PBits == PBitMode::Unique) {
+                Writer.Write(static_cast<uint32_t>(Subset.Endpoints[1].PBit), 1);
+            }
+        }
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const bool InSecond { ((SecondMask >> Pixel) & 1u) != 0 };
+            const bool IsAnchor { Pixel == 0 || Pixel == SecondAnchor };
+            Writer.Write(Candidate.Subsets[InSecond ? 1 : 0].Indices[Pixel], IsAnchor ? Format.IndexBits - 1 : Format.IndexBits);
+        }
+    }
+
+    float EncodeBc7Block(const BlockPixels& Pixels, const Bc7SearchBudget& Budget, uint8_t* Output) {
+        const uint32_t ModeMask { Pixels.IsOpaque ? Budget.OpaqueModeMask : Budget.AlphaModeMask };
+        Bc7Candidate Best {};
+        Best.Error = LargeError;
+        Bc7Candidate Candidate {};
+        const auto Consider { [&Best, &Candidate]() {
+            if (Candidate.Error < Best.Error) {
+                Best = Candidate;
+            }
+        } };
+
+        if ((ModeMask & (1u << 6)) != 0) {
+            EncodeSingleSubsetMode(Pixels, Budget, Candidate);
+            Consider();
+        }
+        if (Best.Error <= Budget.EarlyOutError) {
+            WriteBc7Block(Best, Output);
+            return Best.Error;
+        }
+        if ((ModeMask & (1u << 5)) != 0) {
+            EncodeSeparateAlphaMode(Pixels, 5, 0, Budget, Candidate);
+            Consider();
+        }
+        if ((ModeMask & (1u << 4)) != 0) {
+            EncodeSeparateAlphaMode(Pixels, 4, 0, Budget, Candidate);
+            Consider();
+            if (Budget.TryBothIndexSelections) {
+                EncodeSeparateAlphaMode(Pixels, 4, 1, Budget, Candidate);
+                Consider();
+            }
+        }
+
+        const uint32_t TwoSubsetModes { ModeMask & ((1u << 1) | (1u << 3) | (1u << 7)) };
+        if (TwoSubsetModes == 0 || Budget.PartitionCandidates == 0 || Best.Error <= Budget.EarlyOutError) {
+            WriteBc7Block(Best, Output);
+            return Best.Error;
+        }
+        uint32_t Partitions[PartitionCount] {};
+        const uint32_t CandidateCount { std::min<uint32_t>(Budget.PartitionCandidates, PartitionCount) };
+        SelectPartitions(Pixels, (TwoSubsetModes & (1u << 7)) != 0, CandidateCount, Partitions);
+        for (uint32_t Rank { 0 }; Rank < CandidateCount; ++Rank) {
+            for (const uint32_t Mode : { 1u, 3u, 7u }) {
+                if ((TwoSubsetModes & (1u << Mode)) == 0) {
+                    continue;
+                }
+                EncodeTwoSubsetMode(Pixels, Mode, Partitions[Rank], Budget, Candidate);
+                Consider();
+            }
+            if (Best.Error <= Budget.EarlyOutError) {
+                break;
+            }
+        }
+        WriteBc7Block(Best, Output);
+        return Best.Error;
+    }
+
+    constexpr RdoChunk Bc7RdoChunks[] { { 0, 8 }, { 8, 8 } };
+    constexpr uint32_t Mode6IndexOffset { 65 };
+
+    bool IsMode6Block(const uint8_t* Block) {
+        return (Block[0] & 0x7Fu) == 0x40u;
+    }
+
+    void DecodeMode6Palette(const uint8_t* Block, __m128 (&PaletteOut)[16]) {
+        BitReader Reader { Block, 7 };
+        int32_t Endpoints[2][4] {};
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            Endpoints[0][Channel] = static_cast<int32_t>(Reader.Read(7) << 1);
+            Endpoints[1][Channel] = static_cast<int32_t>(Reader.Read(7) << 1);
+        }
+        const int32_t PBit0 { static_cast<int32_t>(Reader.Read(1)) };
+        const int32_t PBit1 { static_cast<int32_t>(Reader.Read(1)) };
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            Endpoints[0][Channel] |= PBit0;
+            Endpoints[1][Channel] |= PBit1;
+        }
+        for (uint32_t Index { 0 }; Index < 16; ++Index) {
+            float Values[4] {};
+            for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                Values[Channel] = static_cast<float>((Endpoints[0][Channel] * (64 - Weights4[Index]) + Endpoints[1][Channel] * Weights4[Index] + 32) >> 6);
+            }
+            PaletteOut[Index] = _mm_loadu_ps(Values);
+        }
+    }
+
+    float EvaluateMode6Block(const BlockPixels& Pixels, const uint8_t* Block) {
+        __m128 Palette[16] {};
+        DecodeMode6Palette(Block, Palette);
+        BitReader Reader { Block, Mode6IndexOffset };
+        float Error { 0.0f };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Difference { _mm_sub_ps(Pixels.Values[Pixel], Palette[Reader.Read(Pixel == 0 ? 3 : 4)]) };
+            Error += Dot(Difference, Difference);
+        }
+        return Error;
+    }
+
+    void SelectMode6Indices(const BlockPixels& Pixels, uint8_t* Block) {
+        __m128 Palette[16] {};
+        DecodeMode6Palette(Block, Palette);
+        Block[8] = static_cast<uint8_t>(Block[8] & 1u);
+        memset(Block + 9, 0, BlockBytes - 9);
+        BitWriter Writer { Block, Mode6IndexOffset };
+        for (uint32_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const uint32_t PaletteSize { Pixel == 0 ? 8u : 16u };
+            uint32_t BestIndex { 0 };
+            float BestError { LargeError };
+            for (uint32_t Index { 0 }; Index < PaletteSize; ++Index) {
+                const __m128 Difference { _mm_sub_ps(Pixels.Values[Pixel], Palette[Index]) };
+                const float Candidate { Dot(Difference, Difference) };
+                if (Candidate < BestError) {
+                    BestError = Candidate;
+                    BestIndex = Index;
+                }
+            }
+            Writer.Write(BestIndex, Pixel == 0 ? 3 : 4);
+        }
+    }
+
+    void ConsiderRdoCandidate(const RdoBlockHistory& History, float Lambda, float Distortion, const uint8_t* Candidate, float& BestCost, uint8_t* Best) {
+        if (Distortion + Lambda * EstimateRdoMinimumRateBits(History) >= BestCost) {
+            return;
+        }
+        const float Cost { Distortion + Lambda * EstimateRdoRateBits(History, Candidate, Bc7RdoChunks, std::size(Bc7RdoChunks)) };
+        if (Cost < BestCost) {
+            BestCost = Cost;
+            memcpy(Best, Candidate, BlockBytes);
+        }
+    }
+
+    bool IsRepeatedHistoryBlock(const RdoBlockHistory& History, size_t Age) {
+        const uint8_t* Block { GetRdoHistoryBlock(History, Age) };
+        for (size_t Younger { 0 }; Younger < Age; ++Younger) {
+            if (memcmp(GetRdoHistoryBlock(History, Younger), Block, BlockBytes) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    float EncodeMode6Block(const BlockPixels& Pixels, const Bc7SearchBudget& Budget, uint8_t* Output) {
+        Bc7Candidate Candidate {};
+        EncodeSingleSubsetMode(Pixels, Budget, Candidate);
+        WriteBc7Block(Candidate, Output);
+        return Candidate.Error;
+    }
+
+    void OptimizeBc7RateDistortion(const BlockPixels& Pixels, const Bc7SearchBudget& Budget, float Error, float Lambda, const RdoBlockHistory& History, uint8_t* Block) {
+        uint8_t Best[BlockBytes] {};
+        uint8_t Candidate[BlockBytes] {};
+        uint8_t Mode6[BlockBytes] {};
+        memcpy(Best, Block, BlockBytes);
+        float BestCost { LargeError };
+        ConsiderRdoCandidate(History, Lambda, Error, Block, BestCost, Best);
+        if (IsMode6Block(Block)) {
+            memcpy(Mode6, Block, BlockBytes);
+        } else {
+            ConsiderRdoCandidate(History, Lambda, EncodeMode6Block(Pixels, Budget, Mode6), Mode6, BestCost, Best);
+        }
+        for (size_t Age { 0 }; Age < History.Count; ++Age) {
+            const uint8_t* Previous { GetRdoHistoryBlock(History, Age) };
+            if (!IsMode6Block(Previous) || IsRepeatedHistoryBlock(History, Age)) {
+                continue;
+            }
+            memcpy(Candidate, Previous, BlockBytes);
+            ConsiderRdoCandidate(History, Lambda, EvaluateMode6Block(Pixels, Candidate), Candidate, BestCost, Best);
+            SelectMode6Indices(Pixels, Candidate);
+            ConsiderRdoCandidate(History, Lambda, EvaluateMode6Block(Pixels, Candidate), Candidate, BestCost, Best);
+            memcpy(Candidate, Mode6, 8);
+            Candidate[8] = static_cast<uint8_t>((Mode6[8] & 1u) | (Previous[8] & ~1u));
+            memcpy(Candidate + 9, Previous + 9, BlockBytes - 9);
+            ConsiderRdoCandidate(History, Lambda, EvaluateMode6Block(Pixels, Candidate), Candidate, BestCost, Best);
+        }
+        memcpy(Block, Best, BlockBytes);
+    }
+
+    const Bc7SearchBudget& ResolveSearchBudget(TEX_COMPRESS_FLAGS Flags) {
+        if ((Flags & TEX_COMPRESS_BC7_QUICK) != 0) {
+            return SearchBudgets[0];
+        }
+        return (Flags & TEX_COMPRESS_BC7_USE_3SUBSETS) != 0 ? SearchBudgets[2] : SearchBudgets[1];
+    }
+
+    void GatherBlock(const Image& Source, size_t BlockColumn, size_t BlockRow, BlockPixels& PixelsOut) {
+        bool IsOpaque { true };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const size_t X { std::min(BlockColumn * BlockDimension + Pixel % BlockDimension, Source.width - 1) };
+            const size_t Y { std::min(BlockRow * BlockDimension + Pixel / BlockDimension, Source.height - 1) };
+            const uint8_t* Texel { Source.pixels + Y * Source.rowPitch + X * 4 };
+            PixelsOut.Values[Pixel] = _mm_set_ps(static_cast<float>(Texel[3]), static_cast<float>(Texel[2]), static_cast<float>(Texel[1]), static_cast<float>(Texel[0]));
+            IsOpaque = IsOpaque && Texel[3] == 255;
+        }
+        PixelsOut.IsOpaque = IsOpaque;
+    }
+#endif
+
+    bool SupportsBc7Format(DXGI_FORMAT Format) {
+#if NATIVE_BC7_ENCODER_X86
+        return Format == DXGI_FORMAT_BC7_UNORM || Format == DXGI_FORMAT_BC7_UNORM_SRGB;
+#else
+        (void)Format;
+        return false;
+#endif
+    }
+
+    bool EncodeBc7Image(const Image& Source, const Image& Destination, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda) {
+        (void)RefinementPasses;
+#if NATIVE_BC7_ENCODER_X86
+        if (!SupportsBc7Format(Destination.format) || Source.pixels == nullptr || Destination.pixels == nullptr || Source.width == 0 || Source.height == 0) {
+            return false;
+        }
+
+        const DXGI_FORMAT WorkingFormat { IsSRGB(Destination.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM };
+        ScratchImage Converted {};
+        const Image* Working { &Source };
+        if (Source.format != WorkingFormat) {
+            const HRESULT ConvertHr { Convert(Source, WorkingFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Converted) };
+            if (FAILED(ConvertHr)) {
+                return false;
+            }
+            Working = Converted.GetImage(0, 0, 0);
+            if (Working == nullptr) {
+                return false;
+            }
+        }
+
+        const Bc7SearchBudget& Budget { ResolveSearchBudget(Options.flags) };
+        const size_t BlockColumns { (Working->width + BlockDimension - 1) / BlockDimension };
+        const size_t BlockRows { (Working->height + BlockDimension - 1) / BlockDimension };
+        BlockPixels Pixels {};
+        RdoBlockHistory History {};
+        ResetRdoHistory(History, BlockBytes);
+        for (size_t BlockRow { 0 }; BlockRow < BlockRows; ++BlockRow) {
+            uint8_t* DestinationRow { Destination.pixels + BlockRow * Destination.rowPitch };
+            for (size_t BlockColumn { 0 }; BlockColumn < BlockColumns; ++BlockColumn) {
+                uint8_t* Output { DestinationRow + BlockColumn * BlockBytes };
+                GatherBlock(*Working, BlockColumn, BlockRow, Pixels);
+                const float Error { EncodeBc7Block(Pixels, Budget, Output) };
+                if (RdoLambda > 0.0f) {
+                    OptimizeBc7RateDistortion(Pixels, Budget, Error, RdoLambda, History, Output);
+                    PushRdoHistory(History, Output);
+                }
+            }
+        }
+        return true;
+#else
+        (void)Source;
+        (void)Destination;
+        (void)Options;
+        (void)RdoLambda;
+        return false;
+#endif
+    }
+}
+
+const BlockEncoder& GetNativeBc7BlockEncoder() {
+    static const BlockEncoder Encoder { BlockEncoderBackend::Native, "Native BC7", SupportsBc7Format, EncodeBc7Image };
+    return Encoder;
+}
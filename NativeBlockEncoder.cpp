@@ -0,0 +1,923 @@
+#include "BlockCompressionEncoder.h"
+#include "BlockRateModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NATIVE_BLOCK_ENCODER_X86 1
+#include <emmintrin.h>
+#else
+#define NATIVE_BLOCK_ENCODER_X86 0
+#endif
+
+using namespace DirectX;
+
+namespace {
+#if NATIVE_BLOCK_ENCODER_X86
+    enum class NativeBlockFormat {
+        Bc1,
+        Bc3,
+        Bc4,
+        Bc5
+    };
+
+    bool GetNativeBlockFormat(DXGI_FORMAT Format, NativeBlockFormat& FormatOut) {
+        switch (Format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            FormatOut = NativeBlockFormat::Bc1;
+            return true;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            FormatOut = NativeBlockFormat::Bc3;
+            return true;
+        case DXGI_FORMAT_BC4_UNORM:
+            FormatOut = NativeBlockFormat::Bc4;
+            return true;
+        case DXGI_FORMAT_BC5_UNORM:
+            FormatOut = NativeBlockFormat::Bc5;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    constexpr size_t BlockDimension { 4 };
+    constexpr size_t BlockPixelCount { 16 };
+    constexpr size_t LaneCount { 4 };
+    constexpr float LargeError { 1.0e30f };
+
+    struct BlockGroup {
+        alignas(16) float Texels[4][BlockPixelCount][LaneCount];
+    };
+
+    struct ColorWeights {
+        float Red;
+        float Green;
+        float Blue;
+    };
+
+    struct ColorEndpoints {
+        __m128 Red0;
+        __m128 Green0;
+        __m128 Blue0;
+        __m128 Red1;
+        __m128 Green1;
+        __m128 Blue1;
+        __m128i Packed0;
+        __m128i Packed1;
+    };
+
+    struct ColorCandidate {
+        ColorEndpoints Endpoints;
+        __m128 Error;
+        __m128i Indices[BlockPixelCount];
+    };
+
+    struct AlphaCandidate {
+        __m128 High;
+        __m128 Low;
+        __m128 Error;
+        __m128i Steps[BlockPixelCount];
+    };
+
+    struct EncodedBlockGroup {
+        uint8_t Bytes[LaneCount][16];
+    };
+
+    __m128 Select(__m128 Mask, __m128 WhenSet, __m128 WhenClear) {
+        return _mm_or_ps(_mm_and_ps(Mask, WhenSet), _mm_andnot_ps(Mask, WhenClear));
+    }
+
+    __m128i Select(__m128i Mask, __m128i WhenSet, __m128i WhenClear) {
+        return _mm_or_si128(_mm_and_si128(Mask, WhenSet), _mm_andnot_si128(Mask, WhenClear));
+    }
+
+    __m128 Clamp(__m128 Value, float Low, float High) {
+        return _mm_min_ps(_mm_max_ps(Value, _mm_set1_ps(Low)), _mm_set1_ps(High));
+    }
+
+    __m128 Round(__m128 Value) {
+        return _mm_cvtepi32_ps(_mm_cvtps_epi32(Value));
+    }
+
+    __m128 Square(__m128 Value) {
+        return _mm_mul_ps(Value, Value);
+    }
+
+    void GatherBlockGroup(const Image& Source, size_t BlockColumn, size_t BlockRow, size_t BlockColumns, BlockGroup& Group) {
+        for (size_t Lane { 0 }; Lane < LaneCount; ++Lane) {
+            const size_t Column { std::min(BlockColumn + Lane, BlockColumns - 1) };
+            for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+                const size_t X { std::min(Column * BlockDimension + Pixel % BlockDimension, Source.width - 1) };
+                const size_t Y { std::min(BlockRow * BlockDimension + Pixel / BlockDimension, Source.height - 1) };
+                const uint8_t* Texel { Source.pixels + Y * Source.rowPitch + X * 4 };
+                for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+                    Group.Texels[Channel][Pixel][Lane] = static_cast<float>(Texel[Channel]);
+                }
+            }
+        }
+    }
+
+    void QuantizeColorEndpoints(__m128 Red0, __m128 Green0, __m128 Blue0, __m128 Red1, __m128 Green1, __m128 Blue1, ColorEndpoints& EndpointsOut) {
+        const __m128 Scale5 { _mm_set1_ps(31.0f / 255.0f) };
+        const __m128 Scale6 { _mm_set1_ps(63.0f / 255.0f) };
+        const __m128 Expand5 { _mm_set1_ps(255.0f / 31.0f) };
+        const __m128 Expand6 { _mm_set1_ps(255.0f / 63.0f) };
+        const __m128i R0 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Red0, 0.0f, 255.0f), Scale5)) };
+        const __m128i G0 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Green0, 0.0f, 255.0f), Scale6)) };
+        const __m128i B0 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Blue0, 0.0f, 255.0f), Scale5)) };
+        const __m128i R1 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Red1, 0.0f, 255.0f), Scale5)) };
+        const __m128i G1 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Green1, 0.0f, 255.0f), Scale6)) };
+        const __m128i B1 { _mm_cvtps_epi32(_mm_mul_ps(Clamp(Blue1, 0.0f, 255.0f), Scale5)) };
+        EndpointsOut.Red0 = _mm_mul_ps(_mm_cvtepi32_ps(R0), Expand5);
+        EndpointsOut.Green0 = _mm_mul_ps(_mm_cvtepi32_ps(G0), Expand6);
+        EndpointsOut.Blue0 = _mm_mul_ps(_mm_cvtepi32_ps(B0), Expand5);
+        EndpointsOut.Red1 = _mm_mul_ps(_mm_cvtepi32_ps(R1), Expand5);
+        EndpointsOut.Green1 = _mm_mul_ps(_mm_cvtepi32_ps(G1), Expand6);
+        EndpointsOut.Blue1 = _mm_mul_ps(_mm_cvtepi32_ps(B1), Expand5);
+        EndpointsOut.Packed0 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(R0, 11), _mm_slli_epi32(G0, 5)), B0);
+        EndpointsOut.Packed1 = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(R1, 11), _mm_slli_epi32(G1, 5)), B1);
+    }
+
+    __m128 ColorDistance(const BlockGroup& Group, size_t Pixel, __m128 Red, __m128 Green, __m128 Blue, const ColorWeights& Weights) {
+        const __m128 DeltaRed { _mm_sub_ps(_mm_load_ps(Group.Texels[0][Pixel]), Red) };
+        const __m128 DeltaGreen { _mm_sub_ps(_mm_load_ps(Group.Texels[1][Pixel]), Green) };
+        const __m128 DeltaBlue { _mm_sub_ps(_mm_load_ps(Group.Texels[2][Pixel]), Blue) };
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(Square(DeltaRed), _mm_set1_ps(Weights.Red)), _mm_mul_ps(Square(DeltaGreen), _mm_set1_ps(Weights.Green))), _mm_mul_ps(Square(DeltaBlue), _mm_set1_ps(Weights.Blue)));
+    }
+
+    void EvaluateColorEndpoints(const BlockGroup& Group, const __m128* Transparent, __m128 ThreeColor, const ColorWeights& Weights, ColorCandidate& Candidate) {
+        const ColorEndpoints& Ends { Candidate.Endpoints };
+        const __m128 Third { _mm_set1_ps(1.0f / 3.0f) };
+        const __m128 Half { _mm_set1_ps(0.5f) };
+        const __m128 Red2 { Select(ThreeColor, _mm_mul_ps(_mm_add_ps(Ends.Red0, Ends.Red1), Half), _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Red0, Ends.Red0), Ends.Red1), Third)) };
+        const __m128 Green2 { Select(ThreeColor, _mm_mul_ps(_mm_add_ps(Ends.Green0, Ends.Green1), Half), _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Green0, Ends.Green0), Ends.Green1), Third)) };
+        const __m128 Blue2 { Select(ThreeColor, _mm_mul_ps(_mm_add_ps(Ends.Blue0, Ends.Blue1), Half), _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Blue0, Ends.Blue0), Ends.Blue1), Third)) };
+        const __m128 Red3 { _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Red1, Ends.Red1), Ends.Red0), Third) };
+        const __m128 Green3 { _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Green1, Ends.Green1), Ends.Green0), Third) };
+        const __m128 Blue3 { _mm_mul_ps(_mm_add_ps(_mm_add_ps(Ends.Blue1, Ends.Blue1), Ends.Blue0), Third) };
+
+        __m128 Error { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            __m128 Best { ColorDistance(Group, Pixel, Ends.Red0, Ends.Green0, Ends.Blue0, Weights) };
+            __m128i Index { _mm_setzero_si128() };
+            const __m128 Distance1 { ColorDistance(Group, Pixel, Ends.Red1, Ends.Green1, Ends.Blue1, Weights) };
+            const __m128 Closer1 { _mm_cmplt_ps(Distance1, Best) };
+            Best = _mm_min_ps(Best, Distance1);
+            Index = Select(_mm_castps_si128(Closer1), _mm_set1_epi32(1), Index);
+            const __m128 Distance2 { ColorDistance(Group, Pixel, Red2, Green2, Blue2, Weights) };
+            const __m128 Closer2 { _mm_cmplt_ps(Distance2, Best) };
+            Best = _mm_min_ps(Best, Distance2);
+            Index = Select(_mm_castps_si128(Closer2), _mm_set1_epi32(2), Index);
+            const __m128 Distance3 { Select(ThreeColor, _mm_set1_ps(LargeError), ColorDistance(Group, Pixel, Red3, Green3, Blue3, Weights)) };
+            const __m128 Closer3 { _mm_cmplt_ps(Distance3, Best) };
+            Best = _mm_min_ps(Best, Distance3);
+            Index = Select(_mm_castps_si128(Closer3), _mm_set1_epi32(3), Index);
+            Candidate.Indices[Pixel] = Select(_mm_castps_si128(Transparent[Pixel]), _mm_set1_epi32(3), Index);
+            Error = _mm_add_ps(Error, _mm_andnot_ps(Transparent[Pixel], Best));
+        }
+        Candidate.Error = Error;
+    }
+
+    void FitColorEndpoints(const BlockGroup& Group, const __m128* Transparent, const ColorWeights& Weights, ColorCandidate& Candidate) {
+        const __m128 One { _mm_set1_ps(1.0f) };
+        const __m128 ScaleRed { _mm_set1_ps(std::sqrt(Weights.Red)) };
+        const __m128 ScaleGreen { _mm_set1_ps(std::sqrt(Weights.Green)) };
+        const __m128 ScaleBlue { _mm_set1_ps(std::sqrt(Weights.Blue)) };
+        __m128 Count { _mm_setzero_ps() };
+        __m128 SumRed { _mm_setzero_ps() };
+        __m128 SumGreen { _mm_setzero_ps() };
+        __m128 SumBlue { _mm_setzero_ps() };
+        __m128 MinRed { _mm_set1_ps(255.0f) };
+        __m128 MinGreen { _mm_set1_ps(255.0f) };
+        __m128 MinBlue { _mm_set1_ps(255.0f) };
+        __m128 MaxRed { _mm_setzero_ps() };
+        __m128 MaxGreen { _mm_setzero_ps() };
+        __m128 MaxBlue { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Weight { _mm_andnot_ps(Transparent[Pixel], One) };
+            const __m128 Red { _mm_load_ps(Group.Texels[0][Pixel]) };
+            const __m128 Green { _mm_load_ps(Group.Texels[1][Pixel]) };
+            const __m128 Blue { _mm_load_ps(Group.Texels[2][Pixel]) };
+            Count = _mm_add_ps(Count, Weight);
+            SumRed = _mm_add_ps(SumRed, _mm_mul_ps(Red, Weight));
+            SumGreen = _mm_add_ps(SumGreen, _mm_mul_ps(Green, Weight));
+            SumBlue = _mm_add_ps(SumBlue, _mm_mul_ps(Blue, Weight));
+            MinRed = Select(Transparent[Pixel], MinRed, _mm_min_ps(MinRed, Red));
+            MinGreen = Select(Transparent[Pixel], MinGreen, _mm_min_ps(MinGreen, Green));
+            MinBlue = Select(Transparent[Pixel], MinBlue, _mm_min_ps(MinBlue, Blue));
+            MaxRed = Select(Transparent[Pixel], MaxRed, _mm_max_ps(MaxRed, Red));
+            MaxGreen = Select(Transparent[Pixel], MaxGreen, _mm_max_ps(MaxGreen, Green));
+            MaxBlue = Select(Transparent[Pixel], MaxBlue, _mm_max_ps(MaxBlue, Blue));
+        }
+        const __m128 InverseCount { _mm_div_ps(One, _mm_max_ps(Count, One)) };
+        const __m128 MeanRed { _mm_mul_ps(SumRed, InverseCount) };
+        const __m128 MeanGreen { _mm_mul_ps(SumGreen, InverseCount) };
+        const __m128 MeanBlue { _mm_mul_ps(SumBlue, InverseCount) };
+
+        __m128 CovarianceRR { _mm_setzero_ps() };
+        __m128 CovarianceRG { _mm_setzero_ps() };
+        __m128 CovarianceRB { _mm_setzero_ps() };
+        __m128 CovarianceGG { _mm_setzero_ps() };
+        __m128 CovarianceGB { _mm_setzero_ps() };
+        __m128 CovarianceBB { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Red { _mm_andnot_ps(Transparent[Pixel], _mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[0][Pixel]), MeanRed), ScaleRed)) };
+            const __m128 Green { _mm_andnot_ps(Transparent[Pixel], _mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[1][Pixel]), MeanGreen), ScaleGreen)) };
+            const __m128 Blue { _mm_andnot_ps(Transparent[Pixel], _mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[2][Pixel]), MeanBlue), ScaleBlue)) };
+            CovarianceRR = _mm_add_ps(CovarianceRR, _mm_mul_ps(Red, Red));
+            CovarianceRG = _mm_add_ps(CovarianceRG, _mm_mul_ps(Red, Green));
+            CovarianceRB = _mm_add_ps(CovarianceRB, _mm_mul_ps(Red, Blue));
+            CovarianceGG = _mm_add_ps(CovarianceGG, _mm_mul_ps(Green, Green));
+            CovarianceGB = _mm_add_ps(CovarianceGB, _mm_mul_ps(Green, Blue));
+            CovarianceBB = _mm_add_ps(CovarianceBB, _mm_mul_ps(Blue, Blue));
+        }
+
+        __m128 AxisRed { _mm_mul_ps(_mm_sub_ps(MaxRed, MinRed), ScaleRed) };
+        __m128 AxisGreen { _mm_mul_ps(_mm_sub_ps(MaxGreen, MinGreen), ScaleGreen) };
+        __m128 AxisBlue { _mm_mul_ps(_mm_sub_ps(MaxBlue, MinBlue), ScaleBlue) };
+        for (size_t Iteration { 0 }; Iteration < 4; ++Iteration) {
+            const __m128 NextRed { _mm_add_ps(_mm_add_ps(_mm_mul_ps(CovarianceRR, AxisRed), _mm_mul_ps(CovarianceRG, AxisGreen)), _mm_mul_ps(CovarianceRB, AxisBlue)) };
+            const __m128 NextGreen { _mm_add_ps(_mm_add_ps(_mm_mul_ps(CovarianceRG, AxisRed), _mm_mul_ps(CovarianceGG, AxisGreen)), _mm_mul_ps(CovarianceGB, AxisBlue)) };
+            const __m128 NextBlue { _mm_add_ps(_mm_add_ps(_mm_mul_ps(CovarianceRB, AxisRed), _mm_mul_ps(CovarianceGB, AxisGreen)), _mm_mul_ps(CovarianceBB, AxisBlue)) };
+            const __m128 Magnitude { _mm_max_ps(_mm_max_ps(_mm_max_ps(NextRed, _mm_sub_ps(_mm_setzero_ps(), NextRed)), _mm_max_ps(NextGreen, _mm_sub_ps(_mm_setzero_ps(), NextGreen))), _mm_max_ps(NextBlue, _mm_sub_ps(_mm_setzero_ps(), NextBlue))) };
+            const __m128 Valid { _mm_cmpgt_ps(Magnitude, _mm_set1_ps(1.0e-6f)) };
+            const __m128 InverseMagnitude { _mm_div_ps(One, _mm_max_ps(Magnitude, _mm_set1_ps(1.0e-6f))) };
+            AxisRed = Select(Valid, _mm_mul_ps(NextRed, InverseMagnitude), AxisRed);
+            AxisGreen = Select(Valid, _mm_mul_ps(NextGreen, InverseMagnitude), AxisGreen);
+            AxisBlue = Select(Valid, _mm_mul_ps(NextBlue, InverseMagnitude), AxisBlue);
+        }
+        const __m128 LengthSquared { _mm_add_ps(_mm_add_ps(Square(AxisRed), Square(AxisGreen)), Square(AxisBlue)) };
+        const __m128 Degenerate { _mm_cmple_ps(LengthSquared, _mm_set1_ps(1.0e-12f)) };
+        const __m128 InverseLength { _mm_div_ps(One, _mm_sqrt_ps(_mm_max_ps(LengthSquared, _mm_set1_ps(1.0e-12f)))) };
+        AxisRed = Select(Degenerate, _mm_set1_ps(0.57735f), _mm_mul_ps(AxisRed, InverseLength));
+        AxisGreen = Select(Degenerate, _mm_set1_ps(0.57735f), _mm_mul_ps(AxisGreen, InverseLength));
+        AxisBlue = Select(Degenerate, _mm_set1_ps(0.57735f), _mm_mul_ps(AxisBlue, InverseLength));
+
+        __m128 MinProjection { _mm_set1_ps(LargeError) };
+        __m128 MaxProjection { _mm_set1_ps(-LargeError) };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Projection { _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[0][Pixel]), MeanRed), _mm_mul_ps(AxisRed, ScaleRed)), _mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[1][Pixel]), MeanGreen), _mm_mul_ps(AxisGreen, ScaleGreen))), _mm_mul_ps(_mm_sub_ps(_mm_load_ps(Group.Texels[2][Pixel]), MeanBlue), _mm_mul_ps(AxisBlue, ScaleBlue))) };
+            MinProjection = Select(Transparent[Pixel], MinProjection, _mm_min_ps(MinProjection, Projection));
+            MaxProjection = Select(Transparent[Pixel], MaxProjection, _mm_max_ps(MaxProjection, Projection));
+        }
+        const __m128 Empty { _mm_cmple_ps(Count, _mm_setzero_ps()) };
+        MinProjection = _mm_andnot_ps(Empty, MinProjection);
+        MaxProjection = _mm_andnot_ps(Empty, MaxProjection);
+        AxisRed = _mm_div_ps(AxisRed, ScaleRed);
+        AxisGreen = _mm_div_ps(AxisGreen, ScaleGreen);
+        AxisBlue = _mm_div_ps(AxisBlue, ScaleBlue);
+        QuantizeColorEndpoints(_mm_add_ps(MeanRed, _mm_mul_ps(AxisRed, MaxProjection)), _mm_add_ps(MeanGreen, _mm_mul_ps(AxisGreen, MaxProjection)), _mm_add_ps(MeanBlue, _mm_mul_ps(AxisBlue, MaxProjection)),
+            _mm_add_ps(MeanRed, _mm_mul_ps(AxisRed, MinProjection)), _mm_add_ps(MeanGreen, _mm_mul_ps(AxisGreen, MinProjection)), _mm_add_ps(MeanBlue, _mm_mul_ps(AxisBlue, MinProjection)), Candidate.Endpoints);
+    }
+
+    void RefitColorEndpoints(const BlockGroup& Group, const __m128* Transparent, __m128 ThreeColor, const ColorCandidate& Previous, ColorCandidate& Candidate) {
+        const __m128 One { _mm_set1_ps(1.0f) };
+        const __m128 ThirdWeight2 { Select(ThreeColor, _mm_set1_ps(0.5f), _mm_set1_ps(2.0f / 3.0f)) };
+        __m128 AlphaAlpha { _mm_setzero_ps() };
+        __m128 BetaBeta { _mm_setzero_ps() };
+        __m128 AlphaBeta { _mm_setzero_ps() };
+        __m128 AlphaRed { _mm_setzero_ps() };
+        __m128 AlphaGreen { _mm_setzero_ps() };
+        __m128 AlphaBlue { _mm_setzero_ps() };
+        __m128 BetaRed { _mm_setzero_ps() };
+        __m128 BetaGreen { _mm_setzero_ps() };
+        __m128 BetaBlue { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128i Index { Previous.Indices[Pixel] };
+            const __m128 Is0 { _mm_castsi128_ps(_mm_cmpeq_epi32(Index, _mm_setzero_si128())) };
+            const __m128 Is2 { _mm_castsi128_ps(_mm_cmpeq_epi32(Index, _mm_set1_epi32(2))) };
+            const __m128 Is3 { _mm_castsi128_ps(_mm_cmpeq_epi32(Index, _mm_set1_epi32(3))) };
+            const __m128 Alpha { _mm_or_ps(_mm_or_ps(_mm_and_ps(Is0, One), _mm_and_ps(Is2, ThirdWeight2)), _mm_and_ps(Is3, _mm_set1_ps(1.0f / 3.0f))) };
+            const __m128 Weight { _mm_andnot_ps(Transparent[Pixel], One) };
+            const __m128 WeightedAlpha { _mm_mul_ps(Alpha, Weight) };
+            const __m128 WeightedBeta { _mm_mul_ps(_mm_sub_ps(One, Alpha), Weight) };
+            const __m128 Red { _mm_load_ps(Group.Texels[0][Pixel]) };
+            const __m128 Green { _mm_load_ps(Group.Texels[1][Pixel]) };
+            const __m128 Blue { _mm_load_ps(Group.Texels[2][Pixel]) };
+            AlphaAlpha = _mm_add_ps(AlphaAlpha, _mm_mul_ps(WeightedAlpha, Alpha));
+            BetaBeta = _mm_add_ps(BetaBeta, _mm_mul_ps(WeightedBeta, _mm_sub_ps(One, Alpha)));
+            AlphaBeta = _mm_add_ps(AlphaBeta, _mm_mul_ps(WeightedAlpha, _mm_sub_ps(One, Alpha)));
+            AlphaRed = _mm_add_ps(AlphaRed, _mm_mul_ps(WeightedAlpha, Red));
+            AlphaGreen = _mm_add_ps(AlphaGreen, _mm_mul_ps(WeightedAlpha, Green));
+            AlphaBlue = _mm_add_ps(AlphaBlue, _mm_mul_ps(WeightedAlpha, Blue));
+            BetaRed = _mm_add_ps(BetaRed, _mm_mul_ps(WeightedBeta, Red));
+            BetaGreen = _mm_add_ps(BetaGreen, _mm_mul_ps(WeightedBeta, Green));
+            BetaBlue = _mm_add_ps(BetaBlue, _mm_mul_ps(WeightedBeta, Blue));
+        }
+        const __m128 Determinant { _mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaBeta), _mm_mul_ps(AlphaBeta, AlphaBeta)) };
+        const __m128 Solvable { _mm_cmpgt_ps(Determinant, _mm_set1_ps(1.0e-4f)) };
+        const __m128 InverseDeterminant { _mm_div_ps(One, _mm_max_ps(Determinant, _mm_set1_ps(1.0e-4f))) };
+        const ColorEndpoints& Ends { Previous.Endpoints };
+        const __m128 Red0 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaBeta, AlphaRed), _mm_mul_ps(AlphaBeta, BetaRed)), InverseDeterminant), Ends.Red0) };
+        const __m128 Green0 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaBeta, AlphaGreen), _mm_mul_ps(AlphaBeta, BetaGreen)), InverseDeterminant), Ends.Green0) };
+        const __m128 Blue0 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaBeta, AlphaBlue), _mm_mul_ps(AlphaBeta, BetaBlue)), InverseDeterminant), Ends.Blue0) };
+        const __m128 Red1 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaRed), _mm_mul_ps(AlphaBeta, AlphaRed)), InverseDeterminant), Ends.Red1) };
+        const __m128 Green1 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaGreen), _mm_mul_ps(AlphaBeta, AlphaGreen)), InverseDeterminant), Ends.Green1) };
+        const __m128 Blue1 { Select(Solvable, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaBlue), _mm_mul_ps(AlphaBeta, AlphaBlue)), InverseDeterminant), Ends.Blue1) };
+        QuantizeColorEndpoints(Red0, Green0, Blue0, Red1, Green1, Blue1, Candidate.Endpoints);
+    }
+
+    void KeepBetterColorCandidate(const ColorCandidate& Candidate, ColorCandidate& Best) {
+        const __m128 Better { _mm_cmplt_ps(Candidate.Error, Best.Error) };
+        const __m128i BetterMask { _mm_castps_si128(Better) };
+        Best.Error = _mm_min_ps(Candidate.Error, Best.Error);
+        Best.Endpoints.Red0 = Select(Better, Candidate.Endpoints.Red0, Best.Endpoints.Red0);
+        Best.Endpoints.Green0 = Select(Better, Candidate.Endpoints.Green0, Best.Endpoints.Green0);
+        Best.Endpoints.Blue0 = Select(Better, Candidate.Endpoints.Blue0, Best.Endpoints.Blue0);
+        Best.Endpoints.Red1 = Select(Better, Candidate.Endpoints.Red1, Best.Endpoints.Red1);
+        Best.Endpoints.Green1 = Select(Better, Candidate.Endpoints.Green1, Best.Endpoints.Green1);
+        Best.Endpoints.Blue1 = Select(Better, Candidate.Endpoints.Blue1, Best.Endpoints.Blue1);
+        Best.Endpoints.Packed0 = Select(BetterMask, Candidate.Endpoints.Packed0, Best.Endpoints.Packed0);
+        Best.Endpoints.Packed1 = Select(BetterMask, Candidate.Endpoints.Packed1, Best.Endpoints.Packed1);
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            Best.Indices[Pixel] = Select(BetterMask, Candidate.Indices[Pixel], Best.Indices[Pixel]);
+        }
+    }
+
+    void EncodeColorBlocks(const BlockGroup& Group, bool AllowTransparency, float AlphaThreshold, const ColorWeights& Weights, uint32_t RefinementPasses, EncodedBlockGroup& Output, size_t ByteOffset) {
+        __m128 Transparent[BlockPixelCount] {};
+        __m128 ThreeColor { _mm_setzero_ps() };
+        if (AllowTransparency) {
+            const __m128 Threshold { _mm_set1_ps(AlphaThreshold * 255.0f) };
+            for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+                Transparent[Pixel] = _mm_cmplt_ps(_mm_load_ps(Group.Texels[3][Pixel]), Threshold);
+                ThreeColor = _mm_or_ps(ThreeColor, Transparent[Pixel]);
+            }
+        }
+
+        ColorCandidate Best {};
+        FitColorEndpoints(Group, Transparent, Weights, Best);
+        EvaluateColorEndpoints(Group, Transparent, ThreeColor, Weights, Best);
+        ColorCandidate Previous { Best };
+        for (uint32_t Pass { 0 }; Pass < RefinementPasses; ++Pass) {
+            ColorCandidate Candidate {};
+            RefitColorEndpoints(Group, Transparent, ThreeColor, Previous, Candidate);
+            EvaluateColorEndpoints(Group, Transparent, ThreeColor, Weights, Candidate);
+            KeepBetterColorCandidate(Candidate, Best);
+            Previous = Candidate;
+        }
+
+        alignas(16) int32_t Packed0[LaneCount] {};
+        alignas(16) int32_t Packed1[LaneCount] {};
+        alignas(16) int32_t Indices[BlockPixelCount][LaneCount] {};
+        alignas(16) int32_t ThreeColorLanes[LaneCount] {};
+        _mm_store_si128(reinterpret_cast<__m128i*>(Packed0), Best.Endpoints.Packed0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(Packed1), Best.Endpoints.Packed1);
+        _mm_store_si128(reinterpret_cast<__m128i*>(ThreeColorLanes), _mm_castps_si128(ThreeColor));
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(Indices[Pixel]), Best.Indices[Pixel]);
+        }
+
+        for (size_t Lane { 0 }; Lane < LaneCount; ++Lane) {
+            uint16_t Color0 { static_cast<uint16_t>(Packed0[Lane]) };
+            uint16_t Color1 { static_cast<uint16_t>(Packed1[Lane]) };
+            const bool IsThreeColor { ThreeColorLanes[Lane] != 0 };
+            const bool Swap { IsThreeColor ? Color0 > Color1 : Color0 < Color1 };
+            const bool Flat { !IsThreeColor && Color0 == Color1 };
+            if (Swap) {
+                std::swap(Color0, Color1);
+            }
+            uint32_t IndexBits { 0 };
+            for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+                uint32_t Index { static_cast<uint32_t>(Indices[Pixel][Lane]) };
+                if (Flat) {
+                    Index = 0;
+                } else if (Swap && (!IsThreeColor || Index < 2)) {
+                    Index ^= 1;
+                }
+                IndexBits |= Index << (Pixel * 2);
+            }
+            uint8_t* Block { Output.Bytes[Lane] + ByteOffset };
+            memcpy(Block, &Color0, sizeof(Color0));
+            memcpy(Block + 2, &Color1, sizeof(Color1));
+            memcpy(Block + 4, &IndexBits, sizeof(IndexBits));
+        }
+    }
+
+    void EvaluateAlphaEndpoints(const BlockGroup& Group, size_t Channel, AlphaCandidate& Candidate) {
+        const __m128 Range { _mm_sub_ps(Candidate.High, Candidate.Low) };
+        const __m128 Positive { _mm_cmpgt_ps(Range, _mm_setzero_ps()) };
+        const __m128 Scale { _mm_and_ps(Positive, _mm_div_ps(_mm_set1_ps(7.0f), _mm_max_ps(Range, _mm_set1_ps(1.0f)))) };
+        const __m128 Step { _mm_mul_ps(Range, _mm_set1_ps(1.0f / 7.0f)) };
+        __m128 Error { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Value { _mm_load_ps(Group.Texels[Channel][Pixel]) };
+            const __m128i Steps { _mm_cvtps_epi32(Clamp(_mm_mul_ps(_mm_sub_ps(Value, Candidate.Low), Scale), 0.0f, 7.0f)) };
+            const __m128 Reconstructed { _mm_add_ps(Candidate.Low, _mm_mul_ps(_mm_cvtepi32_ps(Steps), Step)) };
+            Candidate.Steps[Pixel] = Steps;
+            Error = _mm_add_ps(Error, Square(_mm_sub_ps(Value, Reconstructed)));
+        }
+        Candidate.Error = Error;
+    }
+
+    void RefitAlphaEndpoints(const BlockGroup& Group, size_t Channel, const AlphaCandidate& Previous, AlphaCandidate& Candidate) {
+        const __m128 One { _mm_set1_ps(1.0f) };
+        __m128 AlphaAlpha { _mm_setzero_ps() };
+        __m128 BetaBeta { _mm_setzero_ps() };
+        __m128 AlphaBeta { _mm_setzero_ps() };
+        __m128 AlphaValue { _mm_setzero_ps() };
+        __m128 BetaValue { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Alpha { _mm_mul_ps(_mm_cvtepi32_ps(Previous.Steps[Pixel]), _mm_set1_ps(1.0f / 7.0f)) };
+            const __m128 Beta { _mm_sub_ps(One, Alpha) };
+            const __m128 Value { _mm_load_ps(Group.Texels[Channel][Pixel]) };
+            AlphaAlpha = _mm_add_ps(AlphaAlpha, _mm_mul_ps(Alpha, Alpha));
+            BetaBeta = _mm_add_ps(BetaBeta, _mm_mul_ps(Beta, Beta));
+            AlphaBeta = _mm_add_ps(AlphaBeta, _mm_mul_ps(Alpha, Beta));
+            AlphaValue = _mm_add_ps(AlphaValue, _mm_mul_ps(Alpha, Value));
+            BetaValue = _mm_add_ps(BetaValue, _mm_mul_ps(Beta, Value));
+        }
+        const __m128 Determinant { _mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaBeta), _mm_mul_ps(AlphaBeta, AlphaBeta)) };
+        const __m128 Solvable { _mm_cmpgt_ps(Determinant, _mm_set1_ps(1.0e-4f)) };
+        const __m128 InverseDeterminant { _mm_div_ps(One, _mm_max_ps(Determinant, _mm_set1_ps(1.0e-4f))) };
+        const __m128 High { Round(Clamp(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(BetaBeta, AlphaValue), _mm_mul_ps(AlphaBeta, BetaValue)), InverseDeterminant), 0.0f, 255.0f)) };
+        const __m128 Low { Round(Clamp(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(AlphaAlpha, BetaValue), _mm_mul_ps(AlphaBeta, AlphaValue)), InverseDeterminant), 0.0f, 255.0f)) };
+        const __m128 Usable { _mm_and_ps(Solvable, _mm_cmpgt_ps(High, Low)) };
+        Candidate.High = Select(Usable, High, Previous.High);
+        Candidate.Low = Select(Usable, Low, Previous.Low);
+    }
+
+    void KeepBetterAlphaCandidate(const AlphaCandidate& Candidate, AlphaCandidate& Best) {
+        const __m128 Better { _mm_cmplt_ps(Candidate.Error, Best.Error) };
+        const __m128i BetterMask { _mm_castps_si128(Better) };
+        Best.Error = _mm_min_ps(Candidate.Error, Best.Error);
+        Best.High = Select(Better, Candidate.High, Best.High);
+        Best.Low = Select(Better, Candidate.Low, Best.Low);
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            Best.Steps[Pixel] = Select(BetterMask, Candidate.Steps[Pixel], Best.Steps[Pixel]);
+        }
+    }
+
+    void EncodeAlphaBlocks(const BlockGroup& Group, size_t Channel, uint32_t RefinementPasses, EncodedBlockGroup& Output, size_t ByteOffset) {
+        __m128 Minimum { _mm_set1_ps(255.0f) };
+        __m128 Maximum { _mm_setzero_ps() };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const __m128 Value { _mm_load_ps(Group.Texels[Channel][Pixel]) };
+            Minimum = _mm_min_ps(Minimum, Value);
+            Maximum = _mm_max_ps(Maximum, Value);
+        }
+
+        AlphaCandidate Best {};
+        Best.High = Round(Maximum);
+        Best.Low = Round(Minimum);
+        EvaluateAlphaEndpoints(Group, Channel, Best);
+        AlphaCandidate Previous { Best };
+        for (uint32_t Pass { 0 }; Pass < RefinementPasses; ++Pass) {
+            AlphaCandidate Candidate {};
+            RefitAlphaEndpoints(Group, Channel, Previous, Candidate);
+            EvaluateAlphaEndpoints(Group, Channel, Candidate);
+            KeepBetterAlphaCandidate(Candidate, Best);
+            Previous = Candidate;
+        }
+
+        alignas(16) int32_t High[LaneCount] {};
+        alignas(16) int32_t Low[LaneCount] {};
+        alignas(16) int32_t Steps[BlockPixelCount][LaneCount] {};
+        _mm_store_si128(reinterpret_cast<__m128i*>(High), _mm_cvtps_epi32(Best.High));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Low), _mm_cvtps_epi32(Best.Low));
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(Steps[Pixel]), Best.Steps[Pixel]);
+        }
+
+        for (size_t Lane { 0 }; Lane < LaneCount; ++Lane) {
+            uint64_t IndexBits { 0 };
+            for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+                const int32_t Step { Steps[Pixel][Lane] };
+                const uint64_t Index { Step == 7 ? 0u : Step == 0 ? 1u : static_cast<uint64_t>(8 - Step) };
+                IndexBits |= Index << (Pixel * 3);
+            }
+            uint8_t* Block { Output.Bytes[Lane] + ByteOffset };
+            Block[0] = static_cast<uint8_t>(High[Lane]);
+            Block[1] = static_cast<uint8_t>(Low[Lane]);
+            for (size_t Byte { 0 }; Byte < 6; ++Byte) {
+                Block[2 + Byte] = static_cast<uint8_t>(IndexBits >> (Byte * 8));
+            }
+        }
+    }
+
+    ColorWeights ResolveColorWeights(const CompressOptions& Options) {
+        return (Options.flags & TEX_COMPRESS_UNIFORM) != 0 ? ColorWeights { 1.0f, 1.0f, 1.0f } : ColorWeights { 0.2125f / 0.7154f, 1.0f, 0.0721f / 0.7154f };
+    }
+
+    void EncodeBlockGroup(NativeBlockFormat Format, const BlockGroup& Group, const CompressOptions& Options, uint32_t RefinementPasses, EncodedBlockGroup& Output) {
+        const ColorWeights Weights { ResolveColorWeights(Options) };
+        switch (Format) {
+        case NativeBlockFormat::Bc1:
+            EncodeColorBlocks(Group, true, Options.threshold, Weights, RefinementPasses, Output, 0);
+            break;
+        case NativeBlockFormat::Bc3:
+            EncodeAlphaBlocks(Group, 3, RefinementPasses, Output, 0);
+            EncodeColorBlocks(Group, false, 0.0f, Weights, RefinementPasses, Output, 8);
+            break;
+        case NativeBlockFormat::Bc4:
+            EncodeAlphaBlocks(Group, 0, RefinementPasses, Output, 0);
+            break;
+        case NativeBlockFormat::Bc5:
+            EncodeAlphaBlocks(Group, 0, RefinementPasses, Output, 0);
+            EncodeAlphaBlocks(Group, 1, RefinementPasses, Output, 8);
+            break;
+        }
+    }
+
+    struct RdoBlockSource {
+        float Texels[4][BlockPixelCount];
+    };
+
+    struct RdoBlockLayout {
+        const RdoChunk* Chunks;
+        size_t ChunkCount;
+        size_t BlockBytes;
+    };
+
+    constexpr RdoChunk Bc1RdoChunks[] { { 0, 4 }, { 4, 4 } };
+    constexpr RdoChunk Bc3RdoChunks[] { { 0, 2 }, { 2, 6 }, { 8, 4 }, { 12, 4 } };
+    constexpr RdoChunk Bc4RdoChunks[] { { 0, 2 }, { 2, 6 } };
+    constexpr RdoChunk Bc5RdoChunks[] { { 0, 2 }, { 2, 6 }, { 8, 2 }, { 10, 6 } };
+
+    RdoBlockLayout GetRdoBlockLayout(NativeBlockFormat Format) {
+        switch (Format) {
+        case NativeBlockFormat::Bc1:
+            return RdoBlockLayout { Bc1RdoChunks, std::size(Bc1RdoChunks), 8 };
+        case NativeBlockFormat::Bc3:
+            return RdoBlockLayout { Bc3RdoChunks, std::size(Bc3RdoChunks), 16 };
+        case NativeBlockFormat::Bc4:
+            return RdoBlockLayout { Bc4RdoChunks, std::size(Bc4RdoChunks), 8 };
+        default:
+            return RdoBlockLayout { Bc5RdoChunks, std::size(Bc5RdoChunks), 16 };
+        }
+    }
+
+    void ExtractRdoBlockSource(const BlockGroup& Group, size_t Lane, RdoBlockSource& SourceOut) {
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+                SourceOut.Texels[Channel][Pixel] = Group.Texels[Channel][Pixel][Lane];
+            }
+        }
+    }
+
+    bool IsTransparentTexel(const RdoBlockSource& Source, size_t Pixel, bool AllowTransparency, float AlphaThreshold) {
+        return AllowTransparency && Source.Texels[3][Pixel] < AlphaThreshold * 255.0f;
+    }
+
+    bool DecodeColorPalette(const uint8_t* Block, bool AllowTransparency, float (&PaletteOut)[4][3]) {
+        uint16_t Colors[2] {};
+        memcpy(Colors, Block, sizeof(Colors));
+        const bool ThreeColor { AllowTransparency && Colors[0] <= Colors[1] };
+        for (size_t Endpoint { 0 }; Endpoint < 2; ++Endpoint) {
+            PaletteOut[Endpoint][0] = static_cast<float>((Colors[Endpoint] >> 11) & 31u) * (255.0f / 31.0f);
+            PaletteOut[Endpoint][1] = static_cast<float>((Colors[Endpoint] >> 5) & 63u) * (255.0f / 63.0f);
+            PaletteOut[Endpoint][2] = static_cast<float>(Colors[Endpoint] & 31u) * (255.0f / 31.0f);
+        }
+        for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+            const float Color0 { PaletteOut[0][Channel] };
+            const float Color1 { PaletteOut[1][Channel] };
+            PaletteOut[2][Channel] = ThreeColor ? (Color0 + Color1) * 0.5f : (Color0 + Color0 + Color1) * (1.0f / 3.0f);
+            PaletteOut[3][Channel] = ThreeColor ? 0.0f : (Color0 + Color1 + Color1) * (1.0f / 3.0f);
+        }
+        return ThreeColor;
+    }
+
+    float ColorPaletteDistance(const RdoBlockSource& Source, size_t Pixel, const float* Color, const ColorWeights& Weights) {
+        const float DeltaRed { Source.Texels[0][Pixel] - Color[0] };
+        const float DeltaGreen { Source.Texels[1][Pixel] - Color[1] };
+        const float DeltaBlue { Source.Texels[2][Pixel] - Color[2] };
+        return DeltaRed * DeltaRed * Weights.Red + DeltaGreen * DeltaGreen * Weights.Green + DeltaBlue * DeltaBlue * Weights.Blue;
+    }
+
+    float EvaluateColorSubBlock(const RdoBlockSource& Source, const uint8_t* Block, bool AllowTransparency, float AlphaThreshold, const ColorWeights& Weights) {
+        float Palette[4][3] {};
+        const bool ThreeColor { DecodeColorPalette(Block, AllowTransparency, Palette) };
+        uint32_t IndexBits { 0 };
+        memcpy(&IndexBits, Block + 4, sizeof(IndexBits));
+        float Error { 0.0f };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const uint32_t Index { (IndexBits >> (Pixel * 2)) & 3u };
+            const bool DecodesTransparent { ThreeColor && Index == 3 };
+            if (DecodesTransparent != IsTransparentTexel(Source, Pixel, AllowTransparency, AlphaThreshold)) {
+                return LargeError;
+            }
+            if (!DecodesTransparent) {
+                Error += ColorPaletteDistance(Source, Pixel, Palette[Index], Weights);
+            }
+        }
+        return Error;
+    }
+
+    bool SelectColorIndices(const RdoBlockSource& Source, uint8_t* Block, bool AllowTransparency, float AlphaThreshold, const ColorWeights& Weights) {
+        float Palette[4][3] {};
+        const bool ThreeColor { DecodeColorPalette(Block, AllowTransparency, Palette) };
+        const uint32_t OpaqueEntries { ThreeColor ? 3u : 4u };
+        uint32_t IndexBits { 0 };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            uint32_t BestIndex { 3 };
+            if (IsTransparentTexel(Source, Pixel, AllowTransparency, AlphaThreshold)) {
+                if (!ThreeColor) {
+                    return false;
+                }
+            } else {
+                float BestDistance { LargeError };
+                for (uint32_t Index { 0 }; Index < OpaqueEntries; ++Index) {
+                    const float Distance { ColorPaletteDistance(Source, Pixel, Palette[Index], Weights) };
+                    if (Distance < BestDistance) {
+                        BestDistance = Distance;
+                        BestIndex = Index;
+                    }
+                }
+            }
+            IndexBits |= BestIndex << (Pixel * 2);
+        }
+        memcpy(Block + 4, &IndexBits, sizeof(IndexBits));
+        return true;
+    }
+
+    bool RefitColorSubBlock(const RdoBlockSource& Source, uint8_t* Block, bool AllowTransparency, float AlphaThreshold) {
+        constexpr float EndpointWeights[4] { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        uint32_t IndexBits { 0 };
+        memcpy(&IndexBits, Block + 4, sizeof(IndexBits));
+        float AlphaAlpha { 0.0f };
+        float BetaBeta { 0.0f };
+        float AlphaBeta { 0.0f };
+        float AlphaColor[3] {};
+        float BetaColor[3] {};
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            if (IsTransparentTexel(Source, Pixel, AllowTransparency, AlphaThreshold)) {
+                return false;
+            }
+            const float Alpha { EndpointWeights[(IndexBits >> (Pixel * 2)) & 3u] };
+            const float Beta { 1.0f - Alpha };
+            AlphaAlpha += Alpha * Alpha;
+            BetaBeta += Beta * Beta;
+            AlphaBeta += Alpha * Beta;
+            for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+                AlphaColor[Channel] += Alpha * Source.Texels[Channel][Pixel];
+                BetaColor[Channel] += Beta * Source.Texels[Channel][Pixel];
+            }
+        }
+        const float Determinant { AlphaAlpha * BetaBeta - AlphaBeta * AlphaBeta };
+        if (Determinant <= 1.0e-4f) {
+            return false;
+        }
+        constexpr uint32_t ChannelMaximum[3] { 31, 63, 31 };
+        constexpr uint32_t ChannelShift[3] { 11, 5, 0 };
+        uint16_t Colors[2] {};
+        for (size_t Channel { 0 }; Channel < 3; ++Channel) {
+            const float Scale { static_cast<float>(ChannelMaximum[Channel]) / 255.0f };
+            const float Value0 { (BetaBeta * AlphaColor[Channel] - AlphaBeta * BetaColor[Channel]) / Determinant };
+            const float Value1 { (AlphaAlpha * BetaColor[Channel] - AlphaBeta * AlphaColor[Channel]) / Determinant };
+            const uint32_t Quantized0 { static_cast<uint32_t>(std::lround(std::clamp(Value0, 0.0f, 255.0f) * Scale)) };
+            const uint32_t Quantized1 { static_cast<uint32_t>(std::lround(std::clamp(Value1, 0.0f, 255.0f) * Scale)) };
+            Colors[0] = static_cast<uint16_t>(Colors[0] | (Quantized0 << ChannelShift[Channel]));
+            Colors[1] = static_cast<uint16_t>(Colors[1] | (Quantized1 << ChannelShift[Channel]));
+        }
+        if (AllowTransparency && Colors[0] <= Colors[1]) {
+            return false;
+        }
+        memcpy(Block, Colors, sizeof(Colors));
+        return true;
+    }
+
+    void DecodeAlphaPalette(const uint8_t* Block, float (&PaletteOut)[8]) {
+        const float Alpha0 { static_cast<float>(Block[0]) };
+        const float Alpha1 { static_cast<float>(Block[1]) };
+        PaletteOut[0] = Alpha0;
+        PaletteOut[1] = Alpha1;
+        if (Block[0] > Block[1]) {
+            for (uint32_t Code { 2 }; Code < 8; ++Code) {
+                PaletteOut[Code] = (static_cast<float>(8 - Code) * Alpha0 + static_cast<float>(Code - 1) * Alpha1) * (1.0f / 7.0f);
+            }
+            return;
+        }
+        for (uint32_t Code { 2 }; Code < 6; ++Code) {
+            PaletteOut[Code] = (static_cast<float>(6 - Code) * Alpha0 + static_cast<float>(Code - 1) * Alpha1) * (1.0f / 5.0f);
+        }
+        PaletteOut[6] = 0.0f;
+        PaletteOut[7] = 255.0f;
+    }
+
+    uint64_t ReadAlphaIndexBits(const uint8_t* Block) {
+        uint64_t IndexBits { 0 };
+        for (size_t Byte { 0 }; Byte < 6; ++Byte) {
+            IndexBits |= static_cast<uint64_t>(Block[2 + Byte]) << (Byte * 8);
+        }
+        return IndexBits;
+    }
+
+    float EvaluateAlphaSubBlock(const RdoBlockSource& Source, size_t Channel, const uint8_t* Block) {
+        float Palette[8] {};
+        DecodeAlphaPalette(Block, Palette);
+        const uint64_t IndexBits { ReadAlphaIndexBits(Block) };
+        float Error { 0.0f };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            const float Delta { Source.Texels[Channel][Pixel] - Palette[(IndexBits >> (Pixel * 3)) & 7u] };
+            Error += Delta * Delta;
+        }
+        return Error;
+    }
+
+    void SelectAlphaIndices(const RdoBlockSource& Source, size_t Channel, uint8_t* Block) {
+        float Palette[8] {};
+        DecodeAlphaPalette(Block, Palette);
+        uint64_t IndexBits { 0 };
+        for (size_t Pixel { 0 }; Pixel < BlockPixelCount; ++Pixel) {
+            uint64_t BestIndex { 0 };
+            float BestDistance { LargeError };
+            for (uint64_t Index { 0 }; Index < 8; ++Index) {
+                const float Delta { Source.Texels[Channel][Pixel] - Palette[Index] };
+                if (Delta * Delta < BestDistance) {
+                    BestDistance = Delta * Delta;
+                    BestIndex = Index;
+                }
+            }
+            IndexBits |= BestIndex << (Pixel * 3);
+        }
+        for (size_t Byte { 0 }; Byte < 6; ++Byte) {
+            Block[2 + Byte] = static_cast<uint8_t>(IndexBits >> (Byte * 8));
+        }
+    }
+
+    void ConsiderRdoCandidate(const RdoBlockHistory& History, const RdoBlockLayout& Layout, float Lambda, float Distortion, const uint8_t* Candidate, float& BestCost, uint8_t* Best) {
+        if (Distortion + Lambda * EstimateRdoMinimumRateBits(History) >= BestCost) {
+            return;
+        }
+        const float Cost { Distortion + Lambda * EstimateRdoRateBits(History, Candidate, Layout.Chunks, Layout.ChunkCount) };
+        if (Cost < BestCost) {
+            BestCost = Cost;
+            memcpy(Best, Candidate, Layout.BlockBytes);
+        }
+    }
+
+    bool InsertUniqueKey(uint64_t* Keys, size_t& Count, uint64_t Key) {
+        if (std::find(Keys, Keys + Count, Key) != Keys + Count) {
+            return false;
+        }
+        Keys[Count++] = Key;
+        return true;
+    }
+
+    uint64_t ReadRdoKey(const uint8_t* Bytes, size_t Size) {
+        uint64_t Key { 0 };
+        memcpy(&Key, Bytes, Size);
+        return Key;
+    }
+
+    void OptimizeColorSubBlock(const RdoBlockSource& Source, const RdoBlockHistory& History, const RdoBlockLayout& Layout, float Lambda, size_t Offset, bool AllowTransparency, float AlphaThreshold, const ColorWeights& Weights, uint8_t* Block) {
+        uint8_t Best[16] {};
+        uint8_t Candidate[16] {};
+        uint64_t EndpointKeys[RdoHistoryCapacity] {};
+        uint64_t SelectorKeys[RdoHistoryCapacity] {};
+        size_t EndpointKeyCount { 0 };
+        size_t SelectorKeyCount { 0 };
+        memcpy(Best, Block, Layout.BlockBytes);
+        float BestCost { LargeError };
+        ConsiderRdoCandidate(History, Layout, Lambda, EvaluateColorSubBlock(Source, Block + Offset, AllowTransparency, AlphaThreshold, Weights), Block, BestCost, Best);
+        for (size_t Age { 0 }; Age < History.Count; ++Age) {
+            const uint8_t* Previous { GetRdoHistoryBlock(History, Age) };
+            const bool NewEndpoints { InsertUniqueKey(EndpointKeys, EndpointKeyCount, ReadRdoKey(Previous + Offset, 4)) };
+            const bool NewSelectors { InsertUniqueKey(SelectorKeys, SelectorKeyCount, ReadRdoKey(Previous + Offset + 4, 4)) };
+            if (NewEndpoints) {
+                memcpy(Candidate, Block, Layout.BlockBytes);
+                memcpy(Candidate + Offset, Previous + Offset, 8);
+                ConsiderRdoCandidate(History, Layout, Lambda, EvaluateColorSubBlock(Source, Candidate + Offset, AllowTransparency, AlphaThreshold, Weights), Candidate, BestCost, Best);
+                if (SelectColorIndices(Source, Candidate + Offset, AllowTransparency, AlphaThreshold, Weights)) {
+                    ConsiderRdoCandidate(History, Layout, Lambda, EvaluateColorSubBlock(Source, Candidate + Offset, AllowTransparency, AlphaThreshold, Weights), Candidate, BestCost, Best);
+                }
+            }
+            if (NewSelectors) {
+                memcpy(Candidate, Block, Layout.BlockBytes);
+                memcpy(Candidate + Offset + 4, Previous + Offset + 4, 4);
+                ConsiderRdoCandidate(History, Layout, Lambda, EvaluateColorSubBlock(Source, Candidate + Offset, AllowTransparency, AlphaThreshold, Weights), Candidate, BestCost, Best);
+                if (RefitColorSubBlock(Source, Candidate + Offset, AllowTransparency, AlphaThreshold)) {
+                    ConsiderRdoCandidate(History, Layout, Lambda, EvaluateColorSubBlock(Source, Candidate + Offset, AllowTransparency, AlphaThreshold, Weights), Candidate, BestCost, Best);
+                }
+            }
+        }
+        memcpy(Block, Best, Layout.BlockBytes);
+    }
+
+    void OptimizeAlphaSubBlock(const RdoBlockSource& Source, const RdoBlockHistory& History, const RdoBlockLayout& Layout, float Lambda, size_t Offset, size_t Channel, uint8_t* Block) {
+        uint8_t Best[16] {};
+        uint8_t Candidate[16] {};
+        uint64_t EndpointKeys[RdoHistoryCapacity] {};
+        uint64_t IndexKeys[RdoHistoryCapacity] {};
+        size_t EndpointKeyCount { 0 };
+        size_t IndexKeyCount { 0 };
+        memcpy(Best, Block, Layout.BlockBytes);
+        float BestCost { LargeError };
+        ConsiderRdoCandidate(History, Layout, Lambda, EvaluateAlphaSubBlock(Source, Channel, Block + Offset), Block, BestCost, Best);
+        for (size_t Age { 0 }; Age < History.Count; ++Age) {
+            const uint8_t* Previous { GetRdoHistoryBlock(History, Age) };
+            const bool NewEndpoints { InsertUniqueKey(EndpointKeys, EndpointKeyCount, ReadRdoKey(Previous + Offset, 2)) };
+            const bool NewIndices { InsertUniqueKey(IndexKeys, IndexKeyCount, ReadRdoKey(Previous + Offset + 2, 6)) };
+            if (NewEndpoints) {
+                memcpy(Candidate, Block, Layout.BlockBytes);
+                memcpy(Candidate + Offset, Previous + Offset, 8);
+                ConsiderRdoCandidate(History, Layout, Lambda, EvaluateAlphaSubBlock(Source, Channel, Candidate + Offset), Candidate, BestCost, Best);
+                SelectAlphaIndices(Source, Channel, Candidate + Offset);
+                ConsiderRdoCandidate(History, Layout, Lambda, EvaluateAlphaSubBlock(Source, Channel, Candidate + Offset), Candidate, BestCost, Best);
+            }
+            if (NewIndices) {
+                memcpy(Candidate, Block, Layout.BlockBytes);
+                memcpy(Candidate + Offset + 2, Previous + Offset + 2, 6);
+                ConsiderRdoCandidate(History, Layout, Lambda, EvaluateAlphaSubBlock(Source, Channel, Candidate + Offset), Candidate, BestCost, Best);
+            }
+        }
+        memcpy(Block, Best, Layout.BlockBytes);
+    }
+
+    void OptimizeBlockRateDistortion(NativeBlockFormat Format, const RdoBlockSource& Source, const CompressOptions& Options, float Lambda, const RdoBlockHistory& History, uint8_t* Block) {
+        const RdoBlockLayout Layout { GetRdoBlockLayout(Format) };
+        switch (Format) {
+        case NativeBlockFormat::Bc1:
+            OptimizeColorSubBlock(Source, History, Layout, Lambda, 0, true, Options.threshold, ResolveColorWeights(Options), Block);
+            break;
+        case NativeBlockFormat::Bc3:
+            OptimizeAlphaSubBlock(Source, History, Layout, Lambda, 0, 3, Block);
+            OptimizeColorSubBlock(Source, History, Layout, Lambda, 8, false, 0.0f, ResolveColorWeights(Options), Block);
+            break;
+        case NativeBlockFormat::Bc4:
+            OptimizeAlphaSubBlock(Source, History, Layout, Lambda, 0, 0, Block);
+            break;
+        case NativeBlockFormat::Bc5:
+            OptimizeAlphaSubBlock(Source, History, Layout, Lambda, 0, 0, Block);
+            OptimizeAlphaSubBlock(Source, History, Layout, Lambda, 8, 1, Block);
+            break;
+        }
+    }
+#endif
+
+    bool SupportsNativeFormat(DXGI_FORMAT Format) {
+#if NATIVE_BLOCK_ENCODER_X86
+        NativeBlockFormat BlockFormat {};
+        return GetNativeBlockFormat(Format, BlockFormat);
+#else
+        (void)Format;
+        return false;
+#endif
+    }
+
+    bool EncodeNativeImage(const Image& Source, const Image& Destination, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda) {
+#if NATIVE_BLOCK_ENCODER_X86
+        NativeBlockFormat BlockFormat {};
+        if (!GetNativeBlockFormat(Destination.format, BlockFormat) || Source.pixels == nullptr || Destination.pixels == nullptr || Source.width == 0 || Source.height == 0) {
+            return false;
+        }
+
+        const DXGI_FORMAT WorkingFormat { IsSRGB(Destination.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM };
+        ScratchImage Converted {};
+        const Image* Working { &Source };
+        if (Source.format != WorkingFormat) {
+            const HRESULT ConvertHr { Convert(Source, WorkingFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Converted) };
+            if (FAILED(ConvertHr)) {
+                return false;
+            }
+            Working = Converted.GetImage(0, 0, 0);
+            if (Working == nullptr) {
+                return false;
+            }
+        }
+
+        const size_t BlockBytes { BlockFormat == NativeBlockFormat::Bc1 || BlockFormat == NativeBlockFormat::Bc4 ? size_t { 8 } : size_t { 16 } };
+        const size_t BlockColumns { (Working->width + BlockDimension - 1) / BlockDimension };
+        const size_t BlockRows { (Working->height + BlockDimension - 1) / BlockDimension };
+        BlockGroup Group {};
+        EncodedBlockGroup Encoded {};
+        RdoBlockSource RdoSource {};
+        RdoBlockHistory History {};
+        ResetRdoHistory(History, BlockBytes);
+        for (size_t BlockRow { 0 }; BlockRow < BlockRows; ++BlockRow) {
+            uint8_t* DestinationRow { Destination.pixels + BlockRow * Destination.rowPitch };
+            for (size_t BlockColumn { 0 }; BlockColumn < BlockColumns; BlockColumn += LaneCount) {
+                GatherBlockGroup(*Working, BlockColumn, BlockRow, BlockColumns, Group);
+                EncodeBlockGroup(BlockFormat, Group, Options, RefinementPasses, Encoded);
+                const size_t ValidLanes { std::min(LaneCount, BlockColumns - BlockColumn) };
+                for (size_t Lane { 0 }; Lane < ValidLanes; ++Lane) {
+                    if (RdoLambda > 0.0f) {
+                        ExtractRdoBlockSource(Group, Lane, RdoSource);
+                        OptimizeBlockRateDistortion(BlockFormat, RdoSource, Options, RdoLambda, History, Encoded.Bytes[Lane]);
+                        PushRdoHistory(History, Encoded.Bytes[Lane]);
+                    }
+                    memcpy(DestinationRow + (BlockColumn + Lane) * BlockBytes, Encoded.Bytes[Lane], BlockBytes);
+                }
+            }
+        }
+        return true;
+#else
+        (void)Source;
+        (void)Destination;
+        (void)Options;
+        (void)RefinementPasses;
+        (void)RdoLambda;
+        return false;
+#endif
+    }
+}
+
+const BlockEncoder& GetNativeBlockEncoder() {
+    static const BlockEncoder Encoder { BlockEncoderBackend::Native, "Native SIMD", SupportsNativeFormat, EncodeNativeImage };
+    return Encoder;
+}
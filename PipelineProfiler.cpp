@@ -0,0 +1,171 @@
+#include "PipelineProfiler.h"
+
+#include <algorithm>
+
+PipelineProfiler::PipelineProfiler() :
+    mMutex {},
+    mStages {} {
+}
+
+PipelineProfiler::~PipelineProfiler() {
+}
+
+PipelineProfiler::PipelineProfiler(const PipelineProfiler& Other) :
+    mMutex {},
+    mStages {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mStages = Other.mStages;
+}
+
+PipelineProfiler& PipelineProfiler::operator=(const PipelineProfiler& Other) {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mStages = Other.mStages;
+    }
+    return *this;
+}
+
+PipelineProfiler::PipelineProfiler(PipelineProfiler&& Other) noexcept :
+    mMutex {},
+    mStages {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mStages = Other.mStages;
+    Other.mStages = {};
+}
+
+PipelineProfiler& PipelineProfiler::operator=(PipelineProfiler&& Other) noexcept {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mStages = Other.mStages;
+        Other.mStages = {};
+    }
+    return *this;
+}
+
+void PipelineProfiler::Record(PipelineStage Stage, double Milliseconds, uint64_t Pixels, uint64_t Bytes) {
+    if (Stage >= PipelineStage::Count) {
+        return;
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    PipelineStageStatistics& Statistics { mStages[static_cast<size_t>(Stage)] };
+    ++Statistics.SampleCount;
+    Statistics.TotalMilliseconds += Milliseconds;
+    Statistics.LastMilliseconds = Milliseconds;
+    Statistics.PeakMilliseconds = std::max(Statistics.PeakMilliseconds, Milliseconds);
+    Statistics.TotalPixels += Pixels;
+    Statistics.TotalBytes += Bytes;
+    Statistics.LastPixels = Pixels;
+    Statistics.LastBytes = Bytes;
+}
+
+PipelineStageStatistics PipelineProfiler::GetStatistics(PipelineStage Stage) const {
+    if (Stage >= PipelineStage::Count) {
+        return {};
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mStages[static_cast<size_t>(Stage)];
+}
+
+void PipelineProfiler::Reset() {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mStages = {};
+}
+
+PipelineProfiler& PipelineProfiler::GetInstance() {
+    static PipelineProfiler Instance {};
+    return Instance;
+}
+
+ScopedStageTimer::ScopedStageTimer(PipelineStage Stage) :
+    mStage { Stage },
+    mStart { std::chrono::steady_clock::now() },
+    mPixels { 0 },
+    mBytes { 0 },
+    mIsCompleted { false } {
+}
+
+ScopedStageTimer::~ScopedStageTimer() {
+    if (mIsCompleted) {
+        PipelineProfiler::GetInstance().Record(mStage, GetElapsedMilliseconds(), mPixels, mBytes);
+    }
+}
+
+ScopedStageTimer::ScopedStageTimer(const ScopedStageTimer& Other) :
+    mStage { Other.mStage },
+    mStart { Other.mStart },
+    mPixels { Other.mPixels },
+    mBytes { Other.mBytes },
+    mIsCompleted { false } {
+}
+
+ScopedStageTimer& ScopedStageTimer::operator=(const ScopedStageTimer& Other) {
+    if (this != &Other) {
+        mStage = Other.mStage;
+        mStart = Other.mStart;
+        mPixels = Other.mPixels;
+        mBytes = Other.mBytes;
+        mIsCompleted = false;
+    }
+    return *this;
+}
+
+ScopedStageTimer::ScopedStageTimer(ScopedStageTimer&& Other) noexcept :
+    mStage { Other.mStage },
+    mStart { Other.mStart },
+    mPixels { Other.mPixels },
+    mBytes { Other.mBytes },
+    mIsCompleted { Other.mIsCompleted } {
+    Other.mIsCompleted = false;
+}
+
+ScopedStageTimer& ScopedStageTimer::operator=(ScopedStageTimer&& Other) noexcept {
+    if (this != &Other) {
+        mStage = Other.mStage;
+        mStart = Other.mStart;
+        mPixels = Other.mPixels;
+        mBytes = Other.mBytes;
+        mIsCompleted = Other.mIsCompleted;
+        Other.mIsCompleted = false;
+    }
+    return *this;
+}
+
+void ScopedStageTimer::MarkCompleted(uint64_t Pixels, uint64_t Bytes) {
+    mPixels = Pixels;
+    mBytes = Bytes;
+    mIsCompleted = true;
+}
+
+double ScopedStageTimer::GetElapsedMilliseconds() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mStart).count();
+}
+
+const char* GetPipelineStageName(PipelineStage Stage) {
+    switch (Stage) {
+    case PipelineStage::Load:
+        return "load";
+    case PipelineStage::Decode:
+        return "decode";
+    case PipelineStage::MipGeneration:
+        return "mips";
+    case PipelineStage::Compress:
+        return "compress";
+    case PipelineStage::DiskCacheLoad:
+        return "disk_cache_load";
+    case PipelineStage::Upload:
+        return "upload";
+    case PipelineStage::Save:
+        return "save";
+    case PipelineStage::QualityMetrics:
+        return "quality";
+    default:
+        return "unknown";
+    }
+}
+
+double ComputeMegapixelsPerSecond(uint64_t Pixels, double Milliseconds) {
+    if (Milliseconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(Pixels) / (Milliseconds * 1000.0);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+enum class PipelineStage {
+    Load,
+    Decode,
+    MipGeneration,
+    Compress,
+    DiskCacheLoad,
+    Upload,
+    Save,
+    QualityMetrics,
+    Count
+};
+
+struct PipelineStageStatistics {
+    uint64_t SampleCount;
+    double TotalMilliseconds;
+    double LastMilliseconds;
+    double PeakMilliseconds;
+    uint64_t TotalPixels;
+    uint64_t TotalBytes;
+    uint64_t LastPixels;
+    uint64_t LastBytes;
+};
+
+class PipelineProfiler {
+public:
+    PipelineProfiler();
+    ~PipelineProfiler();
+    PipelineProfiler(const PipelineProfiler& Other);
+    PipelineProfiler& operator=(const PipelineProfiler& Other);
+    PipelineProfiler(PipelineProfiler&& Other) noexcept;
+    PipelineProfiler& operator=(PipelineProfiler&& Other) noexcept;
+
+public:
+    void Record(PipelineStage Stage, double Milliseconds, uint64_t Pixels, uint64_t Bytes);
+    PipelineStageStatistics GetStatistics(PipelineStage Stage) const;
+    void Reset();
+
+    static PipelineProfiler& GetInstance();
+
+private:
+    using StageArray = std::array<PipelineStageStatistics, static_cast<size_t>(PipelineStage::Count)>;
+
+    mutable std::mutex mMutex;
+    StageArray mStages;
+};
+
+class ScopedStageTimer {
+public:
+    explicit ScopedStageTimer(PipelineStage Stage);
+    ~ScopedStageTimer();
+    ScopedStageTimer(const ScopedStageTimer& Other);
+    ScopedStageTimer& operator=(const ScopedStageTimer& Other);
+    ScopedStageTimer(ScopedStageTimer&& Other) noexcept;
+    ScopedStageTimer& operator=(ScopedStageTimer&& Other) noexcept;
+
+public:
+    void MarkCompleted(uint64_t Pixels, uint64_t Bytes);
+    double GetElapsedMilliseconds() const;
+
+private:
+    PipelineStage mStage;
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t mPixels;
+    uint64_t mBytes;
+    bool mIsCompleted;
+};
+
+const char* GetPipelineStageName(PipelineStage Stage);
+double ComputeMegapixelsPerSecond(uint64_t Pixels, double Milliseconds);
@@ -1,180 +1,680 @@
 #include "TextureArtifactAnalyzer.h"
 
 #include <algorithm>
-#include <array>
+#include <cmath>
 #include <cstring>
 
 using namespace DirectX;
 using namespace Microsoft::WRL;
 
-TextureDocument::TextureDocument() :
-    mSourceImage {},
-    mMetadata {},
-    mPath {} {
+namespace {
+    constexpr size_t DefaultDiskCacheBudget { 2048ull * 1024ull * 1024ull };
+
+    std::shared_ptr<DiskResultCache> OpenDefaultDiskCache() {
+        std::error_code Error {};
+        const std::filesystem::path TemporaryDirectory { std::filesystem::temp_directory_path(Error) };
+        if (Error) {
+            return nullptr;
+        }
+        std::shared_ptr<DiskResultCache> DiskCache { std::make_shared<DiskResultCache>() };
+        if (!DiskCache->Open(TemporaryDirectory / "DDSViewer" / "CompressedCache", DefaultDiskCacheBudget)) {
+            return nullptr;
+        }
+        return DiskCache;
+    }
+
+    bool ContainsRegion(const PreviewRegion& Outer, const PreviewRegion& Inner) {
+        return Inner.Left >= Outer.Left && Inner.Top >= Outer.Top && Inner.Right <= Outer.Right && Inner.Bottom <= Outer.Bottom;
+    }
+
+    bool IsSameRegion(const PreviewRegion& Left, const PreviewRegion& Right) {
+        return Left.Left == Right.Left && Left.Top == Right.Top && Left.Right == Right.Right && Left.Bottom == Right.Bottom;
+    }
 }
 
-TextureDocument::~TextureDocument() {
+BackgroundCompressor::BackgroundCompressor() :
+    mWorker {},
+    mMutex {},
+    mWakeCondition {},
+    mWorkerCache {},
+    mDiskCache {},
+    mPendingDocument {},
+    mPendingSettings {},
+    mPendingRegion {},
+    mPendingJob {},
+    mActiveJob {},
+    mPublishedResult {},
+    mCacheStatistics {},
+    mLastTimings {},
+    mAutoFormatResult {},
+    mAutoFormatKey { 0 },
+    mNextJobId { 1 },
+    mSupersededCount { 0 },
+    mHasPendingJob { false },
+    mHasPublishedResult { false },
+    mIsBusy { false },
+    mStopRequested { false } {
 }
 
-TextureDocument::TextureDocument(const TextureDocument& Other) :
-    mSourceImage {},
-    mMetadata { Other.mMetadata },
-    mPath { Other.mPath } {
-    if (Other.mSourceImage.GetPixels() != nullptr) {
-        const HRESULT Hr { mSourceImage.InitializeFromImage(*Other.mSourceImage.GetImage(0, 0, 0), false) };
-        if (FAILED(Hr)) {
-            mSourceImage.Release();
-        }
+BackgroundCompressor::~BackgroundCompressor() {
+    StopWorker();
+}
+
+BackgroundCompressor::BackgroundCompressor(const BackgroundCompressor& Other) :
+    BackgroundCompressor {} {
+    (void)Other;
+}
+
+BackgroundCompressor& BackgroundCompressor::operator=(const BackgroundCompressor& Other) {
+    if (this != &Other) {
+        CancelAll();
     }
+    return *this;
+}
+
+BackgroundCompressor::BackgroundCompressor(BackgroundCompressor&& Other) noexcept :
+    BackgroundCompressor {} {
+    Other.CancelAll();
 }
 
-TextureDocument& TextureDocument::operator=(const TextureDocument& Other) {
+BackgroundCompressor& BackgroundCompressor::operator=(BackgroundCompressor&& Other) noexcept {
     if (this != &Other) {
-        mSourceImage.Release();
-        mMetadata = Other.mMetadata;
-        mPath = Other.mPath;
-        if (Other.mSourceImage.GetPixels() != nullptr) {
-            const HRESULT Hr { mSourceImage.InitializeFromImage(*Other.mSourceImage.GetImage(0, 0, 0), false) };
-            if (FAILED(Hr)) {
-                mSourceImage.Release();
+        CancelAll();
+        Other.CancelAll();
+    }
+    return *this;
+}
+
+CompressionJobHandle BackgroundCompressor::Submit(std::shared_ptr<const TextureDocument> Document, const AnalyzerSettings& Settings, const PreviewRegion& Region) {
+    EnsureWorker();
+    std::lock_guard<std::mutex> Lock { mMutex };
+    if (mHasPendingJob) {
+        ++mSupersededCount;
+    }
+    if (mIsBusy && !mActiveJob.IsCancelled()) {
+        ++mSupersededCount;
+    }
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mPendingJob = CompressionJobHandle { mNextJobId++ };
+    mPendingDocument = std::move(Document);
+    mPendingSettings = Settings;
+    mPendingRegion = Region;
+    mHasPendingJob = true;
+    mWakeCondition.notify_one();
+    return mPendingJob;
+}
+
+void BackgroundCompressor::SetDiskCache(std::shared_ptr<DiskResultCache> DiskCache) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mDiskCache = std::move(DiskCache);
+}
+
+bool BackgroundCompressor::TryTakeResult(CompressedPreviewResult& ResultOut) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    if (!mHasPublishedResult) {
+        return false;
+    }
+    ResultOut = std::move(mPublishedResult);
+    mPublishedResult = CompressedPreviewResult {};
+    mHasPublishedResult = false;
+    return true;
+}
+
+void BackgroundCompressor::CancelAll() {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mPendingDocument.reset();
+    mHasPendingJob = false;
+    mPublishedResult = CompressedPreviewResult {};
+    mHasPublishedResult = false;
+    mAutoFormatResult = AutoFormatSearchResult {};
+    mAutoFormatKey = 0;
+}
+
+bool BackgroundCompressor::IsBusy() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mIsBusy || mHasPendingJob;
+}
+
+uint64_t BackgroundCompressor::GetSupersededCount() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mSupersededCount;
+}
+
+ResultCacheStatistics BackgroundCompressor::GetCacheStatistics() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mCacheStatistics;
+}
+
+CompressionTimings BackgroundCompressor::GetLastTimings() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mLastTimings;
+}
+
+AutoFormatSearchResult BackgroundCompressor::GetAutoFormatResult() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mAutoFormatResult;
+}
+
+void BackgroundCompressor::EnsureWorker() {
+    if (mWorker.joinable()) {
+        return;
+    }
+    mStopRequested = false;
+    mWorker = std::thread { &BackgroundCompressor::WorkerLoop, this };
+}
+
+void BackgroundCompressor::StopWorker() {
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        mStopRequested = true;
+        mActiveJob.Cancel();
+        mPendingJob.Cancel();
+    }
+    mWakeCondition.notify_all();
+    if (mWorker.joinable()) {
+        mWorker.join();
+    }
+}
+
+void BackgroundCompressor::WorkerLoop() {
+    std::unique_lock<std::mutex> Lock { mMutex };
+    while (true) {
+        mWakeCondition.wait(Lock, [this] { return mStopRequested || mHasPendingJob; });
+        if (mStopRequested) {
+            return;
+        }
+
+        const std::shared_ptr<const TextureDocument> Document { std::move(mPendingDocument) };
+        const AnalyzerSettings RequestedSettings { mPendingSettings };
+        const PreviewRegion Region { mPendingRegion };
+        const CompressionJobHandle Job { mPendingJob };
+        const std::shared_ptr<DiskResultCache> DiskCache { mDiskCache };
+        mHasPendingJob = false;
+        mActiveJob = Job;
+        mIsBusy = true;
+        Lock.unlock();
+
+        mWorkerCache.SetDiskCache(DiskCache);
+        AnalyzerSettings Settings { RequestedSettings };
+        const bool IsResolved { Document != nullptr && (!RequestedSettings.AutoFormat || ResolveAutoFormat(*Document, RequestedSettings, Job, Settings)) };
+        const bool NeedsPreliminary { IsResolved && !mWorkerCache.HasCachedResult(*Document, Settings) };
+        const PreviewRegion FullRegion { 0, 0, Document != nullptr ? Document->GetMetadata().width : 0, Document != nullptr ? Document->GetMetadata().height : 0 };
+        bool PublishedRegion { false };
+        if (NeedsPreliminary && mWorkerCache.RebuildRegion(*Document, Settings, Region, Job)) {
+            PublishResult(Job, PreviewResultKind::Region, Region, Settings);
+            PublishedRegion = true;
+        }
+        AnalyzerSettings PreliminarySettings {};
+        if (NeedsPreliminary && !PublishedRegion && ResolvePreliminarySettings(Settings, PreliminarySettings)) {
+            if (mWorkerCache.Rebuild(*Document, PreliminarySettings, Job)) {
+                PublishResult(Job, PreviewResultKind::Preliminary, FullRegion, PreliminarySettings);
             }
         }
+
+        const bool Built { IsResolved && !Job.IsCancelled() && mWorkerCache.Rebuild(*Document, Settings, Job) };
+        if (Built) {
+            PublishResult(Job, PreviewResultKind::Final, FullRegion, Settings);
+        }
+
+        Lock.lock();
+        mIsBusy = false;
+        mActiveJob = CompressionJobHandle {};
+        mCacheStatistics = mWorkerCache.GetResultCacheStatistics();
+    }
+}
+
+bool BackgroundCompressor::ResolveAutoFormat(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job, AnalyzerSettings& ResolvedOut) {
+    const uint64_t Key { ComputePreviewCacheKey(Document.GetIdentity(), Settings) };
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        if (mAutoFormatKey == Key) {
+            ResolvedOut = ResolveAutoFormatSettings(Settings, mAutoFormatResult);
+            return true;
+        }
+    }
+    AutoFormatSearchResult Result {};
+    if (!SearchAutoFormat(Document, Settings, Job, Result)) {
+        return false;
+    }
+    ResolvedOut = ResolveAutoFormatSettings(Settings, Result);
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mAutoFormatResult = std::move(Result);
+    mAutoFormatKey = Key;
+    return true;
+}
+
+void BackgroundCompressor::PublishResult(const CompressionJobHandle& Job, PreviewResultKind Kind, const PreviewRegion& Region, const AnalyzerSettings& Settings) {
+    const ResultCacheStatistics Statistics { mWorkerCache.GetResultCacheStatistics() };
+    const size_t PackagedBytes { Kind != PreviewResultKind::Final || Job.IsCancelled() ? 0 : mWorkerCache.MeasurePackagedBytes() };
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mCacheStatistics = Statistics;
+    if (Job.IsCancelled()) {
+        return;
+    }
+    mPublishedResult = CompressedPreviewResult { mWorkerCache.GetCompressedSnapshot(), Region, PackagedBytes, Kind, Settings };
+    mLastTimings = mWorkerCache.GetLastTimings();
+    mHasPublishedResult = true;
+}
+
+BackgroundQualityEvaluator::BackgroundQualityEvaluator() :
+    mWorker {},
+    mMutex {},
+    mWakeCondition {},
+    mPendingDocument {},
+    mPendingCompressed {},
+    mPendingMipFilter { TEX_FILTER_DEFAULT },
+    mPendingJob {},
+    mActiveJob {},
+    mPublishedReport {},
+    mNextJobId { 1 },
+    mHasPendingJob { false },
+    mHasPublishedReport { false },
+    mIsBusy { false },
+    mStopRequested { false } {
+}
+
+BackgroundQualityEvaluator::~BackgroundQualityEvaluator() {
+    StopWorker();
+}
+
+BackgroundQualityEvaluator::BackgroundQualityEvaluator(const BackgroundQualityEvaluator& Other) :
+    BackgroundQualityEvaluator {} {
+    (void)Other;
+}
+
+BackgroundQualityEvaluator& BackgroundQualityEvaluator::operator=(const BackgroundQualityEvaluator& Other) {
+    if (this != &Other) {
+        CancelAll();
     }
     return *this;
 }
 
-TextureDocument::TextureDocument(TextureDocument&& Other) noexcept :
-    mSourceImage { std::move(Other.mSourceImage) },
-    mMetadata { Other.mMetadata },
-    mPath { std::move(Other.mPath) } {
+BackgroundQualityEvaluator::BackgroundQualityEvaluator(BackgroundQualityEvaluator&& Other) noexcept :
+    BackgroundQualityEvaluator {} {
+    Other.CancelAll();
 }
 
-TextureDocument& TextureDocument::operator=(TextureDocument&& Other) noexcept {
+BackgroundQualityEvaluator& BackgroundQualityEvaluator::operator=(BackgroundQualityEvaluator&& Other) noexcept {
     if (this != &Other) {
-        mSourceImage = std::move(Other.mSourceImage);
-        mMetadata = Other.mMetadata;
-        mPath = std::move(Other.mPath);
+        CancelAll();
+        Other.CancelAll();
     }
     return *this;
 }
 
-bool TextureDocument::LoadFromFile(const std::filesystem::path& FilePath) {
-    mPath = FilePath;
-    mSourceImage.Release();
-    mMetadata = {};
-    const HRESULT Hr { LoadFromWICFile(FilePath.c_str(), WIC_FLAGS_FORCE_RGB, &mMetadata, mSourceImage) };
-    return SUCCEEDED(Hr);
+void BackgroundQualityEvaluator::Submit(std::shared_ptr<const TextureDocument> Document, std::shared_ptr<const ScratchImage> Compressed, TEX_FILTER_FLAGS MipFilter) {
+    EnsureWorker();
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mPendingJob = CompressionJobHandle { mNextJobId++ };
+    mPendingDocument = std::move(Document);
+    mPendingCompressed = std::move(Compressed);
+    mPendingMipFilter = MipFilter;
+    mHasPendingJob = true;
+    mWakeCondition.notify_one();
 }
 
-const ScratchImage& TextureDocument::GetSourceImage() const {
-    return mSourceImage;
+bool BackgroundQualityEvaluator::TryTakeReport(TextureQualityReport& ReportOut) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    if (!mHasPublishedReport) {
+        return false;
+    }
+    ReportOut = std::move(mPublishedReport);
+    mPublishedReport = TextureQualityReport {};
+    mHasPublishedReport = false;
+    return true;
 }
 
-const TexMetadata& TextureDocument::GetMetadata() const {
-    return mMetadata;
+void BackgroundQualityEvaluator::CancelAll() {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mPendingDocument.reset();
+    mPendingCompressed.reset();
+    mHasPendingJob = false;
+    mPublishedReport = TextureQualityReport {};
+    mHasPublishedReport = false;
 }
 
-const std::filesystem::path& TextureDocument::GetPath() const {
-    return mPath;
+bool BackgroundQualityEvaluator::IsBusy() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mIsBusy || mHasPendingJob;
 }
 
-CompressionPreviewCache::CompressionPreviewCache() :
-    mCompressedImage {} {
+void BackgroundQualityEvaluator::EnsureWorker() {
+    if (mWorker.joinable()) {
+        return;
+    }
+    mStopRequested = false;
+    mWorker = std::thread { &BackgroundQualityEvaluator::WorkerLoop, this };
 }
 
-CompressionPreviewCache::~CompressionPreviewCache() {
+void BackgroundQualityEvaluator::StopWorker() {
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        mStopRequested = true;
+        mActiveJob.Cancel();
+        mPendingJob.Cancel();
+    }
+    mWakeCondition.notify_all();
+    if (mWorker.joinable()) {
+        mWorker.join();
+    }
 }
 
-CompressionPreviewCache::CompressionPreviewCache(const CompressionPreviewCache& Other) :
-    mCompressedImage {} {
-    if (Other.mCompressedImage.GetPixels() != nullptr) {
-        const HRESULT Hr { mCompressedImage.InitializeFromImage(*Other.mCompressedImage.GetImage(0, 0, 0), false) };
-        if (FAILED(Hr)) {
-            mCompressedImage.Release();
+void BackgroundQualityEvaluator::WorkerLoop() {
+    std::unique_lock<std::mutex> Lock { mMutex };
+    while (true) {
+        mWakeCondition.wait(Lock, [this] { return mStopRequested || mHasPendingJob; });
+        if (mStopRequested) {
+            return;
+        }
+
+        const std::shared_ptr<const TextureDocument> Document { std::move(mPendingDocument) };
+        const std::shared_ptr<const ScratchImage> Compressed { std::move(mPendingCompressed) };
+        const TEX_FILTER_FLAGS MipFilter { mPendingMipFilter };
+        const CompressionJobHandle Job { mPendingJob };
+        mHasPendingJob = false;
+        mActiveJob = Job;
+        mIsBusy = true;
+        Lock.unlock();
+
+        TextureQualityReport Report {};
+        const bool Computed { Document != nullptr && Compressed != nullptr &&
+            ComputeTextureQualityReport(Document->GetSourceImage(), TextureImageView { Compressed->GetImages(), Compressed->GetImageCount(), Compressed->GetMetadata() }, MipFilter, Job, Report) };
+
+        Lock.lock();
+        mIsBusy = false;
+        mActiveJob = CompressionJobHandle {};
+        if (Computed && !Job.IsCancelled()) {
+            mPublishedReport = std::move(Report);
+            mHasPublishedReport = true;
         }
     }
 }
 
-CompressionPreviewCache& CompressionPreviewCache::operator=(const CompressionPreviewCache& Other) {
+BackgroundDifferenceBuilder::BackgroundDifferenceBuilder() :
+    mWorker {},
+    mMutex {},
+    mWakeCondition {},
+    mPendingDocument {},
+    mPendingCompressed {},
+    mPendingRegion {},
+    mPendingGain { DefaultDifferenceGain },
+    mPendingJob {},
+    mActiveJob {},
+    mPreparedDocument {},
+    mPreparedCompressed {},
+    mPreparedImages {},
+    mBuiltHeatmap {},
+    mBuiltCompressed {},
+    mBuiltRegion {},
+    mBuiltGain { DefaultDifferenceGain },
+    mPublishedHeatmap {},
+    mNextJobId { 1 },
+    mHasPendingJob { false },
+    mHasPublishedHeatmap { false },
+    mIsBusy { false },
+    mStopRequested { false } {
+}
+
+BackgroundDifferenceBuilder::~BackgroundDifferenceBuilder() {
+    StopWorker();
+}
+
+BackgroundDifferenceBuilder::BackgroundDifferenceBuilder(const BackgroundDifferenceBuilder& Other) :
+    BackgroundDifferenceBuilder {} {
+    (void)Other;
+}
+
+BackgroundDifferenceBuilder& BackgroundDifferenceBuilder::operator=(const BackgroundDifferenceBuilder& Other) {
     if (this != &Other) {
-        mCompressedImage.Release();
-        if (Other.mCompressedImage.GetPixels() != nullptr) {
-            const HRESULT Hr { mCompressedImage.InitializeFromImage(*Other.mCompressedImage.GetImage(0, 0, 0), false) };
-            if (FAILED(Hr)) {
-                mCompressedImage.Release();
-            }
-        }
+        CancelAll();
     }
     return *this;
 }
 
-CompressionPreviewCache::CompressionPreviewCache(CompressionPreviewCache&& Other) noexcept :
-    mCompressedImage { std::move(Other.mCompressedImage) } {
+BackgroundDifferenceBuilder::BackgroundDifferenceBuilder(BackgroundDifferenceBuilder&& Other) noexcept :
+    BackgroundDifferenceBuilder {} {
+    Other.CancelAll();
 }
 
-CompressionPreviewCache& CompressionPreviewCache::operator=(CompressionPreviewCache&& Other) noexcept {
+BackgroundDifferenceBuilder& BackgroundDifferenceBuilder::operator=(BackgroundDifferenceBuilder&& Other) noexcept {
     if (this != &Other) {
-        mCompressedImage = std::move(Other.mCompressedImage);
+        CancelAll();
+        Other.CancelAll();
     }
     return *this;
 }
 
-bool CompressionPreviewCache::Rebuild(const TextureDocument& Document, const AnalyzerSettings& Settings) {
-    if (Document.GetSourceImage().GetPixels() == nullptr) {
+void BackgroundDifferenceBuilder::Submit(std::shared_ptr<const TextureDocument> Document, std::shared_ptr<const ScratchImage> Compressed, const PreviewRegion& Region, float Gain) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mHasPendingJob = false;
+    if (mBuiltHeatmap != nullptr && mBuiltCompressed == Compressed && mPreparedDocument == Document && IsSameRegion(mBuiltRegion, Region) && mBuiltGain == Gain) {
+        mPublishedHeatmap = mBuiltHeatmap;
+        mHasPublishedHeatmap = true;
+        return;
+    }
+    EnsureWorker();
+    mPendingJob = CompressionJobHandle { mNextJobId++ };
+    mPendingDocument = std::move(Document);
+    mPendingCompressed = std::move(Compressed);
+    mPendingRegion = Region;
+    mPendingGain = Gain;
+    mHasPendingJob = true;
+    mWakeCondition.notify_one();
+}
+
+bool BackgroundDifferenceBuilder::TryTakeHeatmap(std::shared_ptr<const ScratchImage>& HeatmapOut) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    if (!mHasPublishedHeatmap) {
         return false;
     }
+    HeatmapOut = std::move(mPublishedHeatmap);
+    mPublishedHeatmap.reset();
+    mHasPublishedHeatmap = false;
+    return true;
+}
+
+void BackgroundDifferenceBuilder::CancelAll() {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mActiveJob.Cancel();
+    mPendingJob.Cancel();
+    mPendingDocument.reset();
+    mPendingCompressed.reset();
+    mHasPendingJob = false;
+    mPreparedDocument.reset();
+    mPreparedCompressed.reset();
+    mPreparedImages.reset();
+    mBuiltHeatmap.reset();
+    mBuiltCompressed.reset();
+    mPublishedHeatmap.reset();
+    mHasPublishedHeatmap = false;
+}
+
+bool BackgroundDifferenceBuilder::IsBusy() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mIsBusy || mHasPendingJob;
+}
+
+void BackgroundDifferenceBuilder::EnsureWorker() {
+    if (mWorker.joinable()) {
+        return;
+    }
+    mStopRequested = false;
+    mWorker = std::thread { &BackgroundDifferenceBuilder::WorkerLoop, this };
+}
+
+void BackgroundDifferenceBuilder::StopWorker() {
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        mStopRequested = true;
+        mActiveJob.Cancel();
+        mPendingJob.Cancel();
+    }
+    mWakeCondition.notify_all();
+    if (mWorker.joinable()) {
+        mWorker.join();
+    }
+}
 
-    ScratchImage WorkingImage {};
-    const TexMetadata SourceMetadata { Document.GetMetadata() };
-    if (Settings.GenerateMipmaps) {
-        const HRESULT MipHr { GenerateMipMaps(Document.GetSourceImage().GetImages(), Document.GetSourceImage().GetImageCount(), SourceMetadata, Settings.MipFilter, 0, WorkingImage) };
-        if (FAILED(MipHr)) {
-            return false;
+void BackgroundDifferenceBuilder::WorkerLoop() {
+    std::unique_lock<std::mutex> Lock { mMutex };
+    while (true) {
+        mWakeCondition.wait(Lock, [this] { return mStopRequested || mHasPendingJob; });
+        if (mStopRequested) {
+            return;
         }
-    } else {
-        const HRESULT CloneHr { WorkingImage.InitializeFromImage(*Document.GetSourceImage().GetImage(0, 0, 0), false) };
-        if (FAILED(CloneHr)) {
-            return false;
+
+        std::shared_ptr<const TextureDocument> Document { std::move(mPendingDocument) };
+        std::shared_ptr<const ScratchImage> Compressed { std::move(mPendingCompressed) };
+        const PreviewRegion Region { mPendingRegion };
+        const float Gain { mPendingGain };
+        const CompressionJobHandle Job { mPendingJob };
+        std::shared_ptr<const DifferenceMetricImages> Prepared { mPreparedDocument == Document && mPreparedCompressed == Compressed ? mPreparedImages : nullptr };
+        mHasPendingJob = false;
+        mActiveJob = Job;
+        mIsBusy = true;
+        Lock.unlock();
+
+        if (Prepared == nullptr && Document != nullptr && Compressed != nullptr && Compressed->GetImageCount() > 0) {
+            const TextureImageView Source { Document->GetSourceImage() };
+            std::shared_ptr<DifferenceMetricImages> Images { std::make_shared<DifferenceMetricImages>() };
+            if (Source.Images != nullptr && Source.ImageCount > 0 && PrepareDifferenceImages(Source.Images[0], *Compressed->GetImage(0, 0, 0), *Images)) {
+                Prepared = std::move(Images);
+            }
+        }
+        std::shared_ptr<ScratchImage> Heatmap { std::make_shared<ScratchImage>() };
+        const bool Built { Prepared != nullptr && !Job.IsCancelled() && ComputeDifferenceHeatmap(*Prepared, Gain, Region, *Heatmap) };
+
+        Lock.lock();
+        mIsBusy = false;
+        mActiveJob = CompressionJobHandle {};
+        if (Prepared != nullptr) {
+            mPreparedDocument = Document;
+            mPreparedCompressed = Compressed;
+            mPreparedImages = Prepared;
+        }
+        if (Built) {
+            mBuiltHeatmap = Heatmap;
+            mBuiltCompressed = Compressed;
+            mBuiltRegion = Region;
+            mBuiltGain = Gain;
+            if (!Job.IsCancelled()) {
+                mPublishedHeatmap = std::move(Heatmap);
+                mHasPublishedHeatmap = true;
+            }
         }
     }
+}
 
-    const DXGI_FORMAT TargetFormat { ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) };
-    ScratchImage Compressed {};
-    const TEX_COMPRESS_FLAGS Flags { BuildCompressFlags(Settings) };
-    const HRESULT CompressHr { Compress(WorkingImage.GetImages(), WorkingImage.GetImageCount(), WorkingImage.GetMetadata(), TargetFormat, Flags, Settings.AlphaWeight, Compressed) };
-    if (FAILED(CompressHr)) {
-        return false;
+SettingsChangeScheduler::SettingsChangeScheduler() :
+    mPendingSettings {},
+    mFirstRequestTime {},
+    mLastRequestTime {},
+    mDebounceInterval { 80 },
+    mMaxLatency { 250 },
+    mCoalescedCount { 0 },
+    mHasPending { false } {
+}
+
+SettingsChangeScheduler::~SettingsChangeScheduler() {
+}
+
+SettingsChangeScheduler::SettingsChangeScheduler(const SettingsChangeScheduler& Other) :
+    mPendingSettings { Other.mPendingSettings },
+    mFirstRequestTime { Other.mFirstRequestTime },
+    mLastRequestTime { Other.mLastRequestTime },
+    mDebounceInterval { Other.mDebounceInterval },
+    mMaxLatency { Other.mMaxLatency },
+    mCoalescedCount { Other.mCoalescedCount },
+    mHasPending { Other.mHasPending } {
+}
+
+SettingsChangeScheduler& SettingsChangeScheduler::operator=(const SettingsChangeScheduler& Other) {
+    if (this != &Other) {
+        mPendingSettings = Other.mPendingSettings;
+        mFirstRequestTime = Other.mFirstRequestTime;
+        mLastRequestTime = Other.mLastRequestTime;
+        mDebounceInterval = Other.mDebounceInterval;
+        mMaxLatency = Other.mMaxLatency;
+        mCoalescedCount = Other.mCoalescedCount;
+        mHasPending = Other.mHasPending;
     }
+    return *this;
+}
 
-    mCompressedImage = std::move(Compressed);
-    return true;
+SettingsChangeScheduler::SettingsChangeScheduler(SettingsChangeScheduler&& Other) noexcept :
+    mPendingSettings { Other.mPendingSettings },
+    mFirstRequestTime { Other.mFirstRequestTime },
+    mLastRequestTime { Other.mLastRequestTime },
+    mDebounceInterval { Other.mDebounceInterval },
+    mMaxLatency { Other.mMaxLatency },
+    mCoalescedCount { Other.mCoalescedCount },
+    mHasPending { Other.mHasPending } {
+    Other.mHasPending = false;
 }
 
-bool CompressionPreviewCache::SaveAsDds(const std::filesystem::path& OutputPath) const {
-    if (mCompressedImage.GetPixels() == nullptr) {
-        return false;
+SettingsChangeScheduler& SettingsChangeScheduler::operator=(SettingsChangeScheduler&& Other) noexcept {
+    if (this != &Other) {
+        mPendingSettings = Other.mPendingSettings;
+        mFirstRequestTime = Other.mFirstRequestTime;
+        mLastRequestTime = Other.mLastRequestTime;
+        mDebounceInterval = Other.mDebounceInterval;
+        mMaxLatency = Other.mMaxLatency;
+        mCoalescedCount = Other.mCoalescedCount;
+        mHasPending = Other.mHasPending;
+        Other.mHasPending = false;
     }
-    const HRESULT Hr { SaveToDDSFile(mCompressedImage.GetImages(), mCompressedImage.GetImageCount(), mCompressedImage.GetMetadata(), DDS_FLAGS_NONE, OutputPath.c_str()) };
-    return SUCCEEDED(Hr);
+    return *this;
 }
 
-TextureMemoryMetrics CompressionPreviewCache::BuildMetrics(const TexMetadata& SourceMetadata) const {
-    TextureMemoryMetrics Metrics { 0, 0, 0.0 };
-    Metrics.SourceBytes = static_cast<size_t>(SourceMetadata.width) * static_cast<size_t>(SourceMetadata.height) * 4;
-    if (mCompressedImage.GetPixels() == nullptr) {
-        return Metrics;
+void SettingsChangeScheduler::Request(const AnalyzerSettings& Settings, Clock::time_point Now) {
+    if (mHasPending) {
+        ++mCoalescedCount;
+    } else {
+        mFirstRequestTime = Now;
     }
-    const Image* FirstImage { mCompressedImage.GetImage(0, 0, 0) };
-    if (FirstImage == nullptr) {
-        return Metrics;
+    mPendingSettings = Settings;
+    mLastRequestTime = Now;
+    mHasPending = true;
+}
+
+bool SettingsChangeScheduler::TryDequeue(Clock::time_point Now, AnalyzerSettings& SettingsOut) {
+    if (!mHasPending) {
+        return false;
     }
-    Metrics.CompressedBytes = FirstImage->slicePitch;
-    Metrics.CompressionRatio = Metrics.CompressedBytes == 0 ? 0.0 : static_cast<double>(Metrics.SourceBytes) / static_cast<double>(Metrics.CompressedBytes);
-    return Metrics;
+    const bool IsQuiet { Now - mLastRequestTime >= mDebounceInterval };
+    const bool IsOverdue { Now - mFirstRequestTime >= mMaxLatency };
+    if (!IsQuiet && !IsOverdue) {
+        return false;
+    }
+    SettingsOut = mPendingSettings;
+    mHasPending = false;
+    return true;
+}
+
+void SettingsChangeScheduler::Reset() {
+    mHasPending = false;
+}
+
+bool SettingsChangeScheduler::HasPending() const {
+    return mHasPending;
 }
 
-const ScratchImage& CompressionPreviewCache::GetCompressedImage() const {
-    return mCompressedImage;
+uint64_t SettingsChangeScheduler::GetCoalescedCount() const {
+    return mCoalescedCount;
+}
+
+void SettingsChangeScheduler::SetTiming(std::chrono::milliseconds DebounceInterval, std::chrono::milliseconds MaxLatency) {
+    mDebounceInterval = DebounceInterval;
+    mMaxLatency = std::max(MaxLatency, DebounceInterval);
 }
 
 Dx12TextureUploader::Dx12TextureUploader() {
@@ -206,11 +706,15 @@ size_t Dx12TextureUploader::ComputeSubresourceCount(const TexMetadata& Metadata)
 }
 
 bool Dx12TextureUploader::CreateTextureAndUpload(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, const ScratchImage& Image, ComPtr<ID3D12Resource>& TextureOut, ComPtr<ID3D12Resource>& UploadOut) {
-    if (Device == nullptr || CommandList == nullptr || Image.GetPixels() == nullptr) {
+    return CreateTextureAndUpload(Device, CommandList, Image.GetImages(), Image.GetImageCount(), Image.GetMetadata(), TextureOut, UploadOut);
+}
+
+bool Dx12TextureUploader::CreateTextureAndUpload(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, const DirectX::Image* Images, size_t ImageCount, const TexMetadata& Metadata, ComPtr<ID3D12Resource>& TextureOut, ComPtr<ID3D12Resource>& UploadOut) {
+    if (Device == nullptr || CommandList == nullptr || Images == nullptr || ImageCount < ComputeSubresourceCount(Metadata)) {
         return false;
     }
+    ScopedStageTimer Timer { PipelineStage::Upload };
 
-    const TexMetadata Metadata { Image.GetMetadata() };
     const D3D12_RESOURCE_DESC TextureDesc { D3D12_RESOURCE_DIMENSION_TEXTURE2D, 0, Metadata.width, static_cast<UINT>(Metadata.height), static_cast<UINT16>(Metadata.arraySize), static_cast<UINT16>(Metadata.mipLevels), Metadata.format, { 1, 0 }, D3D12_TEXTURE_LAYOUT_UNKNOWN, D3D12_RESOURCE_FLAG_NONE };
     const D3D12_HEAP_PROPERTIES DefaultHeap { D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 0, 0 };
     const HRESULT TextureHr { Device->CreateCommittedResource(&DefaultHeap, D3D12_HEAP_FLAG_NONE, &TextureDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(TextureOut.ReleaseAndGetAddressOf())) };
@@ -238,7 +742,6 @@ bool Dx12TextureUploader::CreateTextureAndUpload(ID3D12Device* Device, ID3D12Gra
         return false;
     }
 
-    const DirectX::Image* Images { Image.GetImages() };
     for (UINT Index { 0 }; Index < SubresourceCount; ++Index) {
         const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Footprint { Footprints[Index] };
         uint8_t* DestBase { Mapped + Footprint.Offset };
@@ -267,14 +770,29 @@ bool Dx12TextureUploader::CreateTextureAndUpload(ID3D12Device* Device, ID3D12Gra
 
     const D3D12_RESOURCE_BARRIER Barrier { D3D12_RESOURCE_BARRIER_TYPE_TRANSITION, D3D12_RESOURCE_BARRIER_FLAG_NONE, { TextureOut.Get(), D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE } };
     CommandList->ResourceBarrier(1, &Barrier);
+    Timer.MarkCompleted(CountImagePixels(Images, SubresourceCount), static_cast<size_t>(UploadBytes));
     return true;
 }
 
 TextureArtifactAnalyzer::TextureArtifactAnalyzer() :
-    mDocument {},
+    mDocument { std::make_shared<TextureDocument>() },
+    mDiskCache { OpenDefaultDiskCache() },
     mPreviewCache {},
-    mCurrentSettings { DXGI_FORMAT_BC7_UNORM, TEX_FILTER_DEFAULT, true, false, false, false, CompressionQualityLevel::Normal, ChannelViewMode::Rgba, 1.0f },
-    mViewport { 1.0f, XMFLOAT2 { 0.0f, 0.0f }, XMFLOAT2 { 0.0f, 0.0f }, false } {
+    mCompressor {},
+    mQualityEvaluator {},
+    mDifferenceBuilder {},
+    mQualityReport {},
+    mScheduler {},
+    mCurrentSettings { DXGI_FORMAT_BC7_UNORM, TEX_FILTER_DEFAULT, true, false, false, false, CompressionQualityLevel::Normal, BlockEncoderBackend::DirectXTex, ChannelViewMode::Rgba, 1.0f, CompressionThreadingMode::Auto, 0, true, true, true, 0.0f, false, DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim },
+    mViewport { 1.0f, XMFLOAT2 { 0.0f, 0.0f }, XMFLOAT2 { 0.0f, 0.0f }, false, XMFLOAT2 { 1.0f, 1.0f } },
+    mDisplayImage {},
+    mDisplayRegion {},
+    mRequestedRegion {},
+    mDifferenceImage {},
+    mDifferenceGain { DefaultDifferenceGain },
+    mIsPreviewRefining { false },
+    mIsDifferenceStale { true } {
+    mCompressor.SetDiskCache(mDiskCache);
 }
 
 TextureArtifactAnalyzer::~TextureArtifactAnalyzer() {
@@ -282,53 +800,188 @@ TextureArtifactAnalyzer::~TextureArtifactAnalyzer() {
 
 TextureArtifactAnalyzer::TextureArtifactAnalyzer(const TextureArtifactAnalyzer& Other) :
     mDocument { Other.mDocument },
+    mDiskCache { Other.mDiskCache },
     mPreviewCache { Other.mPreviewCache },
+    mCompressor { Other.mCompressor },
+    mQualityEvaluator { Other.mQualityEvaluator },
+    mDifferenceBuilder { Other.mDifferenceBuilder },
+    mQualityReport { Other.mQualityReport },
+    mScheduler { Other.mScheduler },
     mCurrentSettings { Other.mCurrentSettings },
-    mViewport { Other.mViewport } {
+    mViewport { Other.mViewport },
+    mDisplayImage { Other.mDisplayImage },
+    mDisplayRegion { Other.mDisplayRegion },
+    mRequestedRegion { Other.mRequestedRegion },
+    mDifferenceImage { Other.mDifferenceImage },
+    mDifferenceGain { Other.mDifferenceGain },
+    mIsPreviewRefining { false },
+    mIsDifferenceStale { true } {
+    mCompressor.SetDiskCache(mDiskCache);
 }
 
 TextureArtifactAnalyzer& TextureArtifactAnalyzer::operator=(const TextureArtifactAnalyzer& Other) {
     if (this != &Other) {
         mDocument = Other.mDocument;
+        mDiskCache = Other.mDiskCache;
         mPreviewCache = Other.mPreviewCache;
+        mCompressor = Other.mCompressor;
+        mCompressor.SetDiskCache(mDiskCache);
+        mQualityEvaluator = Other.mQualityEvaluator;
+        mDifferenceBuilder = Other.mDifferenceBuilder;
+        mQualityReport = Other.mQualityReport;
+        mScheduler = Other.mScheduler;
         mCurrentSettings = Other.mCurrentSettings;
         mViewport = Other.mViewport;
+        mDisplayImage = Other.mDisplayImage;
+        mDisplayRegion = Other.mDisplayRegion;
+        mRequestedRegion = Other.mRequestedRegion;
+        mDifferenceImage = Other.mDifferenceImage;
+        mDifferenceGain = Other.mDifferenceGain;
+        mIsPreviewRefining = false;
+        mIsDifferenceStale = true;
     }
     return *this;
 }
 
 TextureArtifactAnalyzer::TextureArtifactAnalyzer(TextureArtifactAnalyzer&& Other) noexcept :
     mDocument { std::move(Other.mDocument) },
+    mDiskCache { std::move(Other.mDiskCache) },
     mPreviewCache { std::move(Other.mPreviewCache) },
+    mCompressor { std::move(Other.mCompressor) },
+    mQualityEvaluator { std::move(Other.mQualityEvaluator) },
+    mDifferenceBuilder { std::move(Other.mDifferenceBuilder) },
+    mQualityReport { std::move(Other.mQualityReport) },
+    mScheduler { std::move(Other.mScheduler) },
     mCurrentSettings { Other.mCurrentSettings },
-    mViewport { Other.mViewport } {
+    mViewport { Other.mViewport },
+    mDisplayImage { std::move(Other.mDisplayImage) },
+    mDisplayRegion { Other.mDisplayRegion },
+    mRequestedRegion { Other.mRequestedRegion },
+    mDifferenceImage { std::move(Other.mDifferenceImage) },
+    mDifferenceGain { Other.mDifferenceGain },
+    mIsPreviewRefining { false },
+    mIsDifferenceStale { true } {
+    mCompressor.SetDiskCache(mDiskCache);
 }
 
 TextureArtifactAnalyzer& TextureArtifactAnalyzer::operator=(TextureArtifactAnalyzer&& Other) noexcept {
     if (this != &Other) {
         mDocument = std::move(Other.mDocument);
+        mDiskCache = std::move(Other.mDiskCache);
         mPreviewCache = std::move(Other.mPreviewCache);
+        mCompressor = std::move(Other.mCompressor);
+        mCompressor.SetDiskCache(mDiskCache);
+        mQualityEvaluator = std::move(Other.mQualityEvaluator);
+        mDifferenceBuilder = std::move(Other.mDifferenceBuilder);
+        mQualityReport = std::move(Other.mQualityReport);
+        mScheduler = std::move(Other.mScheduler);
         mCurrentSettings = Other.mCurrentSettings;
         mViewport = Other.mViewport;
+        mDisplayImage = std::move(Other.mDisplayImage);
+        mDisplayRegion = Other.mDisplayRegion;
+        mRequestedRegion = Other.mRequestedRegion;
+        mDifferenceImage = std::move(Other.mDifferenceImage);
+        mDifferenceGain = Other.mDifferenceGain;
+        mIsPreviewRefining = false;
+        mIsDifferenceStale = true;
     }
     return *this;
 }
 
 bool TextureArtifactAnalyzer::LoadTexture(const std::filesystem::path& FilePath) {
-    const bool Loaded { mDocument.LoadFromFile(FilePath) };
+    std::shared_ptr<TextureDocument> Document { std::make_shared<TextureDocument>() };
+    const bool Loaded { (ShouldOpenLazily(FilePath) && Document->OpenLazy(FilePath)) || Document->LoadFromFile(FilePath) };
     if (!Loaded) {
         return false;
     }
-    return mPreviewCache.Rebuild(mDocument, mCurrentSettings);
+    mDocument = std::move(Document);
+    mScheduler.Reset();
+    mCompressor.CancelAll();
+    mQualityEvaluator.CancelAll();
+    mDifferenceBuilder.CancelAll();
+    mQualityReport = TextureQualityReport {};
+    mPreviewCache.Publish(nullptr, 0);
+    mDisplayImage.reset();
+    mDisplayRegion = GetFullRegion();
+    mDifferenceImage.reset();
+    mIsPreviewRefining = false;
+    mIsDifferenceStale = true;
+    SubmitCompression(mCurrentSettings);
+    return true;
 }
 
 bool TextureArtifactAnalyzer::ApplySettings(const AnalyzerSettings& Settings) {
     mCurrentSettings = Settings;
-    return mPreviewCache.Rebuild(mDocument, mCurrentSettings);
+    if (mDocument->GetSourceImage().ImageCount == 0) {
+        return false;
+    }
+    mScheduler.Request(mCurrentSettings, SettingsChangeScheduler::Clock::now());
+    return true;
+}
+
+bool TextureArtifactAnalyzer::PollCompressedPreview() {
+    const SettingsChangeScheduler::Clock::time_point Now { SettingsChangeScheduler::Clock::now() };
+    AnalyzerSettings ReadySettings {};
+    if (mScheduler.TryDequeue(Now, ReadySettings)) {
+        SubmitCompression(ReadySettings);
+    } else if (mCurrentSettings.RegionOfInterestPreview && !mScheduler.HasPending() && mCompressor.IsBusy() && !ContainsRegion(mRequestedRegion, GetVisibleRegion())) {
+        mScheduler.Request(mCurrentSettings, Now);
+    }
+    mQualityEvaluator.TryTakeReport(mQualityReport);
+
+    CompressedPreviewResult Result {};
+    if (!mCompressor.TryTakeResult(Result)) {
+        return false;
+    }
+    mDisplayImage = Result.Image;
+    mDisplayRegion = Result.Region;
+    mIsPreviewRefining = Result.Kind != PreviewResultKind::Final;
+    mIsDifferenceStale = true;
+    if (Result.Kind == PreviewResultKind::Final) {
+        mPreviewCache.Publish(std::move(Result.Image), Result.PackagedBytes);
+        mQualityEvaluator.Submit(mDocument, mPreviewCache.GetCompressedSnapshot(), ResolveMipFilter(Result.Settings));
+    }
+    return true;
+}
+
+bool TextureArtifactAnalyzer::IsCompressionPending() const {
+    return mScheduler.HasPending() || mCompressor.IsBusy();
+}
+
+bool TextureArtifactAnalyzer::IsPreviewRefining() const {
+    return mIsPreviewRefining && mCompressor.IsBusy();
+}
+
+uint64_t TextureArtifactAnalyzer::GetSkippedRebuildCount() const {
+    return mScheduler.GetCoalescedCount() + mCompressor.GetSupersededCount();
+}
+
+ResultCacheStatistics TextureArtifactAnalyzer::GetResultCacheStatistics() const {
+    return mCompressor.GetCacheStatistics();
+}
+
+ResultCacheStatistics TextureArtifactAnalyzer::GetDiskCacheStatistics() const {
+    return mDiskCache != nullptr ? mDiskCache->GetStatistics() : ResultCacheStatistics {};
+}
+
+CompressionTimings TextureArtifactAnalyzer::GetLastCompressionTimings() const {
+    return mCompressor.GetLastTimings();
+}
+
+AutoFormatSearchResult TextureArtifactAnalyzer::GetAutoFormatResult() const {
+    return mCompressor.GetAutoFormatResult();
+}
+
+const TextureQualityReport& TextureArtifactAnalyzer::GetQualityReport() const {
+    return mQualityReport;
+}
+
+bool TextureArtifactAnalyzer::IsQualityPending() const {
+    return mQualityEvaluator.IsBusy();
 }
 
 bool TextureArtifactAnalyzer::SaveCurrentAsDds() const {
-    const std::filesystem::path SourcePath { mDocument.GetPath() };
+    const std::filesystem::path SourcePath { mDocument->GetPath() };
     if (SourcePath.empty()) {
         return false;
     }
@@ -338,21 +991,82 @@ bool TextureArtifactAnalyzer::SaveCurrentAsDds() const {
 }
 
 TextureMemoryMetrics TextureArtifactAnalyzer::GetMetrics() const {
-    return mPreviewCache.BuildMetrics(mDocument.GetMetadata());
+    return mPreviewCache.BuildMetrics(mDocument->GetMetadata());
 }
 
 const SyncViewportState& TextureArtifactAnalyzer::GetViewportState() const {
     return mViewport;
 }
 
-const ScratchImage& TextureArtifactAnalyzer::GetSourceImage() const {
-    return mDocument.GetSourceImage();
+TextureImageView TextureArtifactAnalyzer::GetSourceImage() const {
+    return mDocument->GetSourceImage();
+}
+
+bool TextureArtifactAnalyzer::IsSourceLazy() const {
+    return mDocument->IsLazy();
+}
+
+const TexMetadata& TextureArtifactAnalyzer::GetSourceFileMetadata() const {
+    return mDocument->GetFileMetadata();
+}
+
+ResultCacheStatistics TextureArtifactAnalyzer::GetSourcePageStatistics() const {
+    return mDocument->GetPageStatistics();
+}
+
+bool TextureArtifactAnalyzer::SelectSourceSubresource(size_t Mip, size_t Item) {
+    if (!mDocument->IsLazy()) {
+        return false;
+    }
+    std::shared_ptr<TextureDocument> Selected { std::make_shared<TextureDocument>(*mDocument) };
+    if (Selected->GetIdentity() == 0 || !Selected->SelectSubresource(Mip, Item)) {
+        return false;
+    }
+    mDocument = std::move(Selected);
+    mScheduler.Reset();
+    mCompressor.CancelAll();
+    mQualityEvaluator.CancelAll();
+    mDifferenceBuilder.CancelAll();
+    mQualityReport = TextureQualityReport {};
+    mPreviewCache.Publish(nullptr, 0);
+    mDisplayImage.reset();
+    mDisplayRegion = GetFullRegion();
+    mDifferenceImage.reset();
+    mIsPreviewRefining = false;
+    mIsDifferenceStale = true;
+    SubmitCompression(mCurrentSettings);
+    return true;
 }
 
 const ScratchImage& TextureArtifactAnalyzer::GetCompressedImage() const {
     return mPreviewCache.GetCompressedImage();
 }
 
+bool TextureArtifactAnalyzer::SetDifferenceGain(float Gain) {
+    if (Gain == mDifferenceGain) {
+        return false;
+    }
+    mDifferenceGain = Gain;
+    mIsDifferenceStale = true;
+    return true;
+}
+
+bool TextureArtifactAnalyzer::PollDifferenceHeatmap() {
+    if (mIsDifferenceStale) {
+        mIsDifferenceStale = false;
+        std::shared_ptr<const ScratchImage> Compressed { mDisplayImage != nullptr ? mDisplayImage : mPreviewCache.GetCompressedSnapshot() };
+        if (Compressed != nullptr && Compressed->GetImageCount() > 0) {
+            mDifferenceBuilder.Submit(mDocument, std::move(Compressed), mDisplayRegion, mDifferenceGain);
+        }
+    }
+    std::shared_ptr<const ScratchImage> Heatmap {};
+    if (!mDifferenceBuilder.TryTakeHeatmap(Heatmap)) {
+        return false;
+    }
+    mDifferenceImage = std::move(Heatmap);
+    return true;
+}
+
 void TextureArtifactAnalyzer::HandleZoom(float WheelStep, const XMFLOAT2& MousePos) {
     const float PrevZoom { mViewport.Zoom };
     const float NextZoom { std::clamp(PrevZoom + WheelStep * 0.1f, 1.0f, 64.0f) };
@@ -360,6 +1074,7 @@ void TextureArtifactAnalyzer::HandleZoom(float WheelStep, const XMFLOAT2& MouseP
     mViewport.Pan.x = (mViewport.Pan.x - MousePos.x) * ZoomScale + MousePos.x;
     mViewport.Pan.y = (mViewport.Pan.y - MousePos.y) * ZoomScale + MousePos.y;
     mViewport.Zoom = NextZoom;
+    ClampViewportPan();
 }
 
 void TextureArtifactAnalyzer::BeginPan(const XMFLOAT2& MousePos) {
@@ -376,91 +1091,69 @@ void TextureArtifactAnalyzer::UpdatePan(const XMFLOAT2& MousePos) {
     mViewport.Pan.x += DeltaX;
     mViewport.Pan.y += DeltaY;
     mViewport.LastMousePos = MousePos;
+    ClampViewportPan();
 }
 
 void TextureArtifactAnalyzer::EndPan() {
     mViewport.IsPanning = false;
 }
 
+void TextureArtifactAnalyzer::SetViewportPanelSize(const XMFLOAT2& PanelSize) {
+    mViewport.PanelSize = XMFLOAT2 { std::max(1.0f, PanelSize.x), std::max(1.0f, PanelSize.y) };
+    ClampViewportPan();
+}
+
+void TextureArtifactAnalyzer::ClampViewportPan() {
+    mViewport.Pan.x = std::clamp(mViewport.Pan.x, mViewport.PanelSize.x * (1.0f - mViewport.Zoom), 0.0f);
+    mViewport.Pan.y = std::clamp(mViewport.Pan.y, mViewport.PanelSize.y * (1.0f - mViewport.Zoom), 0.0f);
+}
+
+PreviewRegion TextureArtifactAnalyzer::GetVisibleRegion() const {
+    const TexMetadata& Metadata { mDocument->GetMetadata() };
+    return ComputeVisibleTextureRegion(mViewport, Metadata.width, Metadata.height);
+}
+
+PreviewRegion TextureArtifactAnalyzer::GetFullRegion() const {
+    const TexMetadata& Metadata { mDocument->GetMetadata() };
+    return PreviewRegion { 0, 0, Metadata.width, Metadata.height };
+}
+
+void TextureArtifactAnalyzer::SubmitCompression(const AnalyzerSettings& Settings) {
+    mRequestedRegion = Settings.RegionOfInterestPreview ? GetVisibleRegion() : GetFullRegion();
+    mCompressor.Submit(mDocument, Settings, mRequestedRegion);
+}
+
 bool TextureArtifactAnalyzer::UpdateSourceGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, ComPtr<ID3D12Resource>& LeftTextureOut, ComPtr<ID3D12Resource>& UploadOut) {
-    return Uploader.CreateTextureAndUpload(Device, CommandList, mDocument.GetSourceImage(), LeftTextureOut, UploadOut);
+    const TextureImageView Source { mDocument->GetSourceImage() };
+    return Uploader.CreateTextureAndUpload(Device, CommandList, Source.Images, Source.ImageCount, Source.Metadata, LeftTextureOut, UploadOut);
 }
 
 bool TextureArtifactAnalyzer::UpdatePreviewGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, ComPtr<ID3D12Resource>& RightTextureOut, ComPtr<ID3D12Resource>& UploadOut) {
-    return Uploader.CreateTextureAndUpload(Device, CommandList, mPreviewCache.GetCompressedImage(), RightTextureOut, UploadOut);
-}
-
-std::vector<FormatOption> BuildCompressionCandidateFormats() {
-    std::vector<FormatOption> Formats {
-        { DXGI_FORMAT_R8_UNORM, "R8_UNORM" },
-        { DXGI_FORMAT_R8_SNORM, "R8_SNORM" },
-        { DXGI_FORMAT_R8G8_UNORM, "R8G8_UNORM" },
-        { DXGI_FORMAT_R8G8_SNORM, "R8G8_SNORM" },
-        { DXGI_FORMAT_R8G8B8A8_UNORM, "R8G8B8A8_UNORM" },
-        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, "R8G8B8A8_UNORM_SRGB" },
-        { DXGI_FORMAT_B8G8R8A8_UNORM, "B8G8R8A8_UNORM" },
-        { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, "B8G8R8A8_UNORM_SRGB" },
-        { DXGI_FORMAT_R10G10B10A2_UNORM, "R10G10B10A2_UNORM" },
-        { DXGI_FORMAT_R11G11B10_FLOAT, "R11G11B10_FLOAT" },
-        { DXGI_FORMAT_R16_FLOAT, "R16_FLOAT" },
-        { DXGI_FORMAT_R16G16_FLOAT, "R16G16_FLOAT" },
-        { DXGI_FORMAT_R16G16B16A16_FLOAT, "R16G16B16A16_FLOAT" },
-        { DXGI_FORMAT_R32_FLOAT, "R32_FLOAT" },
-        { DXGI_FORMAT_R32G32_FLOAT, "R32G32_FLOAT" },
-        { DXGI_FORMAT_R32G32B32A32_FLOAT, "R32G32B32A32_FLOAT" },
-        { DXGI_FORMAT_BC1_UNORM, "BC1_UNORM" },
-        { DXGI_FORMAT_BC1_UNORM_SRGB, "BC1_UNORM_SRGB" },
-        { DXGI_FORMAT_BC2_UNORM, "BC2_UNORM" },
-        { DXGI_FORMAT_BC2_UNORM_SRGB, "BC2_UNORM_SRGB" },
-        { DXGI_FORMAT_BC3_UNORM, "BC3_UNORM" },
-        { DXGI_FORMAT_BC3_UNORM_SRGB, "BC3_UNORM_SRGB" },
-        { DXGI_FORMAT_BC4_UNORM, "BC4_UNORM" },
-        { DXGI_FORMAT_BC4_SNORM, "BC4_SNORM" },
-        { DXGI_FORMAT_BC5_UNORM, "BC5_UNORM" },
-        { DXGI_FORMAT_BC5_SNORM, "BC5_SNORM" },
-        { DXGI_FORMAT_BC6H_UF16, "BC6H_UF16" },
-        { DXGI_FORMAT_BC6H_SF16, "BC6H_SF16" },
-        { DXGI_FORMAT_BC7_UNORM, "BC7_UNORM" },
-        { DXGI_FORMAT_BC7_UNORM_SRGB, "BC7_UNORM_SRGB" }
-    };
-    return Formats;
-}
-
-DXGI_FORMAT ResolveSrgbVariant(DXGI_FORMAT Format, bool IsSrgb) {
-    if (!IsSrgb) {
-        return Format;
-    }
-    if (Format == DXGI_FORMAT_BC1_UNORM) {
-        return DXGI_FORMAT_BC1_UNORM_SRGB;
-    }
-    if (Format == DXGI_FORMAT_BC2_UNORM) {
-        return DXGI_FORMAT_BC2_UNORM_SRGB;
-    }
-    if (Format == DXGI_FORMAT_BC3_UNORM) {
-        return DXGI_FORMAT_BC3_UNORM_SRGB;
-    }
-    if (Format == DXGI_FORMAT_BC7_UNORM) {
-        return DXGI_FORMAT_BC7_UNORM_SRGB;
-    }
-    if (Format == DXGI_FORMAT_R8G8B8A8_UNORM) {
-        return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-    }
-    if (Format == DXGI_FORMAT_B8G8R8A8_UNORM) {
-        return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
-    }
-    return Format;
-}
-
-TEX_COMPRESS_FLAGS BuildCompressFlags(const AnalyzerSettings& Settings) {
-    TEX_COMPRESS_FLAGS Flags { TEX_COMPRESS_DEFAULT };
-    if (Settings.CompressionQuality == CompressionQualityLevel::Fast) {
-        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_BC7_QUICK);
-    }
-    if (Settings.CompressionQuality == CompressionQualityLevel::Best) {
-        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_BC7_USE_3SUBSETS);
-    }
-    if (Settings.IsNormalMap) {
-        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_UNIFORM);
-    }
-    return Flags;
+    return Uploader.CreateTextureAndUpload(Device, CommandList, mDisplayImage != nullptr ? *mDisplayImage : mPreviewCache.GetCompressedImage(), RightTextureOut, UploadOut);
+}
+
+bool TextureArtifactAnalyzer::UpdateDifferenceGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, ComPtr<ID3D12Resource>& DifferenceTextureOut, ComPtr<ID3D12Resource>& UploadOut) {
+    if (mDifferenceImage == nullptr) {
+        return false;
+    }
+    return Uploader.CreateTextureAndUpload(Device, CommandList, *mDifferenceImage, DifferenceTextureOut, UploadOut);
+}
+
+ViewportUvRect ComputeViewportUvRect(const SyncViewportState& Viewport) {
+    const float Zoom { std::max(1.0f, Viewport.Zoom) };
+    const float PanelWidth { std::max(1.0f, Viewport.PanelSize.x) };
+    const float PanelHeight { std::max(1.0f, Viewport.PanelSize.y) };
+    const float Extent { 1.0f / Zoom };
+    const float MinU { std::clamp(-Viewport.Pan.x / (PanelWidth * Zoom), 0.0f, 1.0f - Extent) };
+    const float MinV { std::clamp(-Viewport.Pan.y / (PanelHeight * Zoom), 0.0f, 1.0f - Extent) };
+    return ViewportUvRect { XMFLOAT2 { MinU, MinV }, XMFLOAT2 { MinU + Extent, MinV + Extent } };
+}
+
+PreviewRegion ComputeVisibleTextureRegion(const SyncViewportState& Viewport, size_t Width, size_t Height) {
+    const ViewportUvRect UvRect { ComputeViewportUvRect(Viewport) };
+    const size_t Left { static_cast<size_t>(std::floor(UvRect.Min.x * static_cast<float>(Width))) & ~static_cast<size_t>(3) };
+    const size_t Top { static_cast<size_t>(std::floor(UvRect.Min.y * static_cast<float>(Height))) & ~static_cast<size_t>(3) };
+    const size_t Right { std::min(Width, (static_cast<size_t>(std::ceil(UvRect.Max.x * static_cast<float>(Width))) + 3) & ~static_cast<size_t>(3)) };
+    const size_t Bottom { std::min(Height, (static_cast<size_t>(std::ceil(UvRect.Max.y * static_cast<float>(Height))) + 3) & ~static_cast<size_t>(3)) };
+    return PreviewRegion { std::min(Left, Right), std::min(Top, Bottom), Right, Bottom };
 }
@@ -1,15 +1,21 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <filesystem>
-#include <string>
-#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <wrl/client.h>
 #include <dxgiformat.h>
 #include <d3d12.h>
-#include <DirectXTex.h>
 #include <DirectXMath.h>
 
+#include "AutoFormatSearch.h"
+#include "TextureCompressionCore.h"
+#include "TextureQualityMetrics.h"
+
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -19,94 +25,197 @@
 #pragma comment(lib, "d3dcompiler.lib")
 #pragma comment(lib, "dxcompiler.lib")
 
-#pragma comment(lib, "DirectXTex.lib")
-
-using namespace DirectX;
 
+constexpr float DefaultDifferenceGain { 8.0f };
 
-enum class CompressionQualityLevel {
-    Fast,
-    Normal,
-    Best
+struct SyncViewportState {
+    float Zoom;
+    DirectX::XMFLOAT2 Pan;
+    DirectX::XMFLOAT2 LastMousePos;
+    bool IsPanning;
+    DirectX::XMFLOAT2 PanelSize;
 };
 
-enum class ChannelViewMode {
-    Rgba,
-    Red,
-    Green,
-    Blue,
-    Alpha,
-    Diff
+struct ViewportUvRect {
+    DirectX::XMFLOAT2 Min;
+    DirectX::XMFLOAT2 Max;
 };
 
-struct AnalyzerSettings {
-    DXGI_FORMAT Format;
-    TEX_FILTER_FLAGS MipFilter;
-    bool GenerateMipmaps;
-    bool IsSrgb;
-    bool IsNormalMap;
-    bool ReconstructZ;
-    CompressionQualityLevel CompressionQuality;
-    ChannelViewMode ChannelView;
-    float AlphaWeight;
+enum class PreviewResultKind {
+    Final,
+    Preliminary,
+    Region
 };
 
-struct TextureMemoryMetrics {
-    size_t SourceBytes;
-    size_t CompressedBytes;
-    double CompressionRatio;
+struct CompressedPreviewResult {
+    std::shared_ptr<const DirectX::ScratchImage> Image;
+    PreviewRegion Region;
+    size_t PackagedBytes;
+    PreviewResultKind Kind;
+    AnalyzerSettings Settings;
 };
 
-struct SyncViewportState {
-    float Zoom;
-    DirectX::XMFLOAT2 Pan;
-    DirectX::XMFLOAT2 LastMousePos;
-    bool IsPanning;
+class BackgroundCompressor {
+public:
+    BackgroundCompressor();
+    ~BackgroundCompressor();
+    BackgroundCompressor(const BackgroundCompressor& Other);
+    BackgroundCompressor& operator=(const BackgroundCompressor& Other);
+    BackgroundCompressor(BackgroundCompressor&& Other) noexcept;
+    BackgroundCompressor& operator=(BackgroundCompressor&& Other) noexcept;
+
+public:
+    CompressionJobHandle Submit(std::shared_ptr<const TextureDocument> Document, const AnalyzerSettings& Settings, const PreviewRegion& Region);
+    void SetDiskCache(std::shared_ptr<DiskResultCache> DiskCache);
+    bool TryTakeResult(CompressedPreviewResult& ResultOut);
+    void CancelAll();
+    bool IsBusy() const;
+    uint64_t GetSupersededCount() const;
+    ResultCacheStatistics GetCacheStatistics() const;
+    CompressionTimings GetLastTimings() const;
+    AutoFormatSearchResult GetAutoFormatResult() const;
+
+private:
+    void EnsureWorker();
+    void StopWorker();
+    void WorkerLoop();
+    bool ResolveAutoFormat(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job, AnalyzerSettings& ResolvedOut);
+    void PublishResult(const CompressionJobHandle& Job, PreviewResultKind Kind, const PreviewRegion& Region, const AnalyzerSettings& Settings);
+
+private:
+    std::thread mWorker;
+    mutable std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    CompressionPreviewCache mWorkerCache;
+    std::shared_ptr<DiskResultCache> mDiskCache;
+    std::shared_ptr<const TextureDocument> mPendingDocument;
+    AnalyzerSettings mPendingSettings;
+    PreviewRegion mPendingRegion;
+    CompressionJobHandle mPendingJob;
+    CompressionJobHandle mActiveJob;
+    CompressedPreviewResult mPublishedResult;
+    ResultCacheStatistics mCacheStatistics;
+    CompressionTimings mLastTimings;
+    AutoFormatSearchResult mAutoFormatResult;
+    uint64_t mAutoFormatKey;
+    uint64_t mNextJobId;
+    uint64_t mSupersededCount;
+    bool mHasPendingJob;
+    bool mHasPublishedResult;
+    bool mIsBusy;
+    bool mStopRequested;
 };
 
-struct FormatOption {
-    DXGI_FORMAT Format;
-    std::string Name;
+class BackgroundQualityEvaluator {
+public:
+    BackgroundQualityEvaluator();
+    ~BackgroundQualityEvaluator();
+    BackgroundQualityEvaluator(const BackgroundQualityEvaluator& Other);
+    BackgroundQualityEvaluator& operator=(const BackgroundQualityEvaluator& Other);
+    BackgroundQualityEvaluator(BackgroundQualityEvaluator&& Other) noexcept;
+    BackgroundQualityEvaluator& operator=(BackgroundQualityEvaluator&& Other) noexcept;
+
+public:
+    void Submit(std::shared_ptr<const TextureDocument> Document, std::shared_ptr<const DirectX::ScratchImage> Compressed, TEX_FILTER_FLAGS MipFilter);
+    bool TryTakeReport(TextureQualityReport& ReportOut);
+    void CancelAll();
+    bool IsBusy() const;
+
+private:
+    void EnsureWorker();
+    void StopWorker();
+    void WorkerLoop();
+
+private:
+    std::thread mWorker;
+    mutable std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::shared_ptr<const TextureDocument> mPendingDocument;
+    std::shared_ptr<const DirectX::ScratchImage> mPendingCompressed;
+    TEX_FILTER_FLAGS mPendingMipFilter;
+    CompressionJobHandle mPendingJob;
+    CompressionJobHandle mActiveJob;
+    TextureQualityReport mPublishedReport;
+    uint64_t mNextJobId;
+    bool mHasPendingJob;
+    bool mHasPublishedReport;
+    bool mIsBusy;
+    bool mStopRequested;
 };
 
-class TextureDocument {
+class BackgroundDifferenceBuilder {
 public:
-    TextureDocument();
-    ~TextureDocument();
-    TextureDocument(const TextureDocument& Other);
-    TextureDocument& operator=(const TextureDocument& Other);
-    TextureDocument(TextureDocument&& Other) noexcept;
-    TextureDocument& operator=(TextureDocument&& Other) noexcept;
+    BackgroundDifferenceBuilder();
+    ~BackgroundDifferenceBuilder();
+    BackgroundDifferenceBuilder(const BackgroundDifferenceBuilder& Other);
+    BackgroundDifferenceBuilder& operator=(const BackgroundDifferenceBuilder& Other);
+    BackgroundDifferenceBuilder(BackgroundDifferenceBuilder&& Other) noexcept;
+    BackgroundDifferenceBuilder& operator=(BackgroundDifferenceBuilder&& Other) noexcept;
 
 public:
-    bool LoadFromFile(const std::filesystem::path& FilePath);
-    const DirectX::ScratchImage& GetSourceImage() const;
-    const DirectX::TexMetadata& GetMetadata() const;
-    const std::filesystem::path& GetPath() const;
+    void Submit(std::shared_ptr<const TextureDocument> Document, std::shared_ptr<const DirectX::ScratchImage> Compressed, const PreviewRegion& Region, float Gain);
+    bool TryTakeHeatmap(std::shared_ptr<const DirectX::ScratchImage>& HeatmapOut);
+    void CancelAll();
+    bool IsBusy() const;
+
+private:
+    void EnsureWorker();
+    void StopWorker();
+    void WorkerLoop();
 
 private:
-    DirectX::ScratchImage mSourceImage;
-    DirectX::TexMetadata mMetadata;
-    std::filesystem::path mPath;
+    std::thread mWorker;
+    mutable std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::shared_ptr<const TextureDocument> mPendingDocument;
+    std::shared_ptr<const DirectX::ScratchImage> mPendingCompressed;
+    PreviewRegion mPendingRegion;
+    float mPendingGain;
+    CompressionJobHandle mPendingJob;
+    CompressionJobHandle mActiveJob;
+    std::shared_ptr<const TextureDocument> mPreparedDocument;
+    std::shared_ptr<const DirectX::ScratchImage> mPreparedCompressed;
+    std::shared_ptr<const DifferenceMetricImages> mPreparedImages;
+    std::shared_ptr<const DirectX::ScratchImage> mBuiltHeatmap;
+    std::shared_ptr<const DirectX::ScratchImage> mBuiltCompressed;
+    PreviewRegion mBuiltRegion;
+    float mBuiltGain;
+    std::shared_ptr<const DirectX::ScratchImage> mPublishedHeatmap;
+    uint64_t mNextJobId;
+    bool mHasPendingJob;
+    bool mHasPublishedHeatmap;
+    bool mIsBusy;
+    bool mStopRequested;
 };
 
-class CompressionPreviewCache {
+class SettingsChangeScheduler {
 public:
-    CompressionPreviewCache();
-    ~CompressionPreviewCache();
-    CompressionPreviewCache(const CompressionPreviewCache& Other);
-    CompressionPreviewCache& operator=(const CompressionPreviewCache& Other);
-    CompressionPreviewCache(CompressionPreviewCache&& Other) noexcept;
-    CompressionPreviewCache& operator=(CompressionPreviewCache&& Other) noexcept;
+    using Clock = std::chrono::steady_clock;
 
 public:
-    bool Rebuild(const TextureDocument& Document, const AnalyzerSettings& Settings);
-    bool SaveAsDds(const std::filesystem::path& OutputPath) const;
-    TextureMemoryMetrics BuildMetrics(const DirectX::TexMetadata& SourceMetadata) const;
-    const DirectX::ScratchImage& GetCompressedImage() const;
+    SettingsChangeScheduler();
+    ~SettingsChangeScheduler();
+    SettingsChangeScheduler(const SettingsChangeScheduler& Other);
+    SettingsChangeScheduler& operator=(const SettingsChangeScheduler& Other);
+    SettingsChangeScheduler(SettingsChangeScheduler&& Other) noexcept;
+    SettingsChangeScheduler& operator=(SettingsChangeScheduler&& Other) noexcept;
+
+public:
+    void Request(const AnalyzerSettings& Settings, Clock::time_point Now);
+    bool TryDequeue(Clock::time_point Now, AnalyzerSettings& SettingsOut);
+    void Reset();
+    bool HasPending() const;
+    uint64_t GetCoalescedCount() const;
+    void SetTiming(std::chrono::milliseconds DebounceInterval, std::chrono::milliseconds MaxLatency);
 
 private:
-    DirectX::ScratchImage mCompressedImage;
+    AnalyzerSettings mPendingSettings;
+    Clock::time_point mFirstRequestTime;
+    Clock::time_point mLastRequestTime;
+    std::chrono::milliseconds mDebounceInterval;
+    std::chrono::milliseconds mMaxLatency;
+    uint64_t mCoalescedCount;
+    bool mHasPending;
 };
 
 class Dx12TextureUploader {
@@ -120,6 +229,7 @@ public:
 
 public:
     bool CreateTextureAndUpload(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, const DirectX::ScratchImage& Image, Microsoft::WRL::ComPtr<ID3D12Resource>& TextureOut, Microsoft::WRL::ComPtr<ID3D12Resource>& UploadOut);
+    bool CreateTextureAndUpload(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, const DirectX::Image* Images, size_t ImageCount, const DirectX::TexMetadata& Metadata, Microsoft::WRL::ComPtr<ID3D12Resource>& TextureOut, Microsoft::WRL::ComPtr<ID3D12Resource>& UploadOut);
 
 private:
     static size_t ComputeSubresourceCount(const DirectX::TexMetadata& Metadata);
@@ -137,27 +247,63 @@ public:
 public:
     bool LoadTexture(const std::filesystem::path& FilePath);
     bool ApplySettings(const AnalyzerSettings& Settings);
+    bool PollCompressedPreview();
+    bool IsCompressionPending() const;
+    bool IsPreviewRefining() const;
+    uint64_t GetSkippedRebuildCount() const;
+    ResultCacheStatistics GetResultCacheStatistics() const;
+    ResultCacheStatistics GetDiskCacheStatistics() const;
+    CompressionTimings GetLastCompressionTimings() const;
+    AutoFormatSearchResult GetAutoFormatResult() const;
+    const TextureQualityReport& GetQualityReport() const;
+    bool IsQualityPending() const;
     bool SaveCurrentAsDds() const;
     TextureMemoryMetrics GetMetrics() const;
     const SyncViewportState& GetViewportState() const;
-    const DirectX::ScratchImage& GetSourceImage() const;
+    TextureImageView GetSourceImage() const;
+    bool IsSourceLazy() const;
+    const DirectX::TexMetadata& GetSourceFileMetadata() const;
+    ResultCacheStatistics GetSourcePageStatistics() const;
+    bool SelectSourceSubresource(size_t Mip, size_t Item);
     const DirectX::ScratchImage& GetCompressedImage() const;
+    bool SetDifferenceGain(float Gain);
+    bool PollDifferenceHeatmap();
 
     void HandleZoom(float WheelStep, const DirectX::XMFLOAT2& MousePos);
     void BeginPan(const DirectX::XMFLOAT2& MousePos);
     void UpdatePan(const DirectX::XMFLOAT2& MousePos);
     void EndPan();
+    void SetViewportPanelSize(const DirectX::XMFLOAT2& PanelSize);
 
     bool UpdateSourceGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, Microsoft::WRL::ComPtr<ID3D12Resource>& LeftTextureOut, Microsoft::WRL::ComPtr<ID3D12Resource>& UploadOut);
     bool UpdatePreviewGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, Microsoft::WRL::ComPtr<ID3D12Resource>& RightTextureOut, Microsoft::WRL::ComPtr<ID3D12Resource>& UploadOut);
+    bool UpdateDifferenceGpuResources(ID3D12Device* Device, ID3D12GraphicsCommandList* CommandList, Dx12TextureUploader& Uploader, Microsoft::WRL::ComPtr<ID3D12Resource>& DifferenceTextureOut, Microsoft::WRL::ComPtr<ID3D12Resource>& UploadOut);
+
+private:
+    void ClampViewportPan();
+    PreviewRegion GetVisibleRegion() const;
+    PreviewRegion GetFullRegion() const;
+    void SubmitCompression(const AnalyzerSettings& Settings);
 
 private:
-    TextureDocument mDocument;
+    std::shared_ptr<const TextureDocument> mDocument;
+    std::shared_ptr<DiskResultCache> mDiskCache;
     CompressionPreviewCache mPreviewCache;
+    BackgroundCompressor mCompressor;
+    BackgroundQualityEvaluator mQualityEvaluator;
+    BackgroundDifferenceBuilder mDifferenceBuilder;
+    TextureQualityReport mQualityReport;
+    SettingsChangeScheduler mScheduler;
     AnalyzerSettings mCurrentSettings;
     SyncViewportState mViewport;
+    std::shared_ptr<const DirectX::ScratchImage> mDisplayImage;
+    PreviewRegion mDisplayRegion;
+    PreviewRegion mRequestedRegion;
+    std::shared_ptr<const DirectX::ScratchImage> mDifferenceImage;
+    float mDifferenceGain;
+    bool mIsPreviewRefining;
+    bool mIsDifferenceStale;
 };
 
-std::vector<FormatOption> BuildCompressionCandidateFormats();
-DXGI_FORMAT ResolveSrgbVariant(DXGI_FORMAT Format, bool IsSrgb);
-TEX_COMPRESS_FLAGS BuildCompressFlags(const AnalyzerSettings& Settings);
+ViewportUvRect ComputeViewportUvRect(const SyncViewportState& Viewport);
+PreviewRegion ComputeVisibleTextureRegion(const SyncViewportState& Viewport, size_t Width, size_t Height);
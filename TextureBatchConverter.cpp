@@ -0,0 +1,738 @@
+#include "TextureBatchConverter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <thread>
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t ToolVersion { 2 };
+    constexpr const char* DefaultManifestFileName { "TextureBatchManifest.txt" };
+    constexpr size_t DefaultDiskCacheBudget { 8192ull * 1024ull * 1024ull };
+
+    double ElapsedMilliseconds(const std::chrono::steady_clock::time_point& Start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    std::string ToLower(std::string Text) {
+        std::transform(Text.begin(), Text.end(), Text.begin(), [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+        return Text;
+    }
+
+    std::string Trim(const std::string& Text) {
+        const size_t Begin { Text.find_first_not_of(" \t\r\n") };
+        if (Begin == std::string::npos) {
+            return {};
+        }
+        const size_t End { Text.find_last_not_of(" \t\r\n") };
+        return Text.substr(Begin, End - Begin + 1);
+    }
+
+    bool ParseBool(const std::string& Value, bool& ValueOut) {
+        const std::string Lower { ToLower(Value) };
+        if (Lower == "1" || Lower == "true" || Lower == "yes" || Lower == "on") {
+            ValueOut = true;
+            return true;
+        }
+        if (Lower == "0" || Lower == "false" || Lower == "no" || Lower == "off") {
+            ValueOut = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseUnsigned(const std::string& Value, uint32_t& ValueOut) {
+        uint64_t Parsed { 0 };
+        const char* const End { Value.data() + Value.size() };
+        const std::from_chars_result Result { std::from_chars(Value.data(), End, Parsed) };
+        if (Value.empty() || Result.ec != std::errc {} || Result.ptr != End || Parsed > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+        ValueOut = static_cast<uint32_t>(Parsed);
+        return true;
+    }
+
+    bool IsSupportedExtension(const std::filesystem::path& FilePath) {
+        const std::string Extension { ToLower(FilePath.extension().string()) };
+        if (Extension == ".dds" || Extension == ".tga" || Extension == ".hdr") {
+            return true;
+        }
+#ifdef _WIN32
+        return Extension == ".png" || Extension == ".jpg" || Extension == ".jpeg" || Extension == ".bmp" || Extension == ".tif" || Extension == ".tiff";
+#else
+        return false;
+#endif
+    }
+
+    std::string EscapeJson(std::string_view Text) {
+        std::string Escaped {};
+        Escaped.reserve(Text.size());
+        for (const char Character : Text) {
+            switch (Character) {
+            case '"':
+                Escaped += "\\\"";
+                break;
+            case '\\':
+                Escaped += "\\\\";
+                break;
+            case '\n':
+                Escaped += "\\n";
+                break;
+            case '\t':
+                Escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(Character) < 0x20) {
+                    char Buffer[8] {};
+                    std::snprintf(Buffer, sizeof(Buffer), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(Character)));
+                    Escaped += Buffer;
+                }
+                else {
+                    Escaped += Character;
+                }
+                break;
+            }
+        }
+        return Escaped;
+    }
+}
+
+TextureBatchConverter::TextureBatchConverter() :
+    mSettings { DXGI_FORMAT_BC7_UNORM, TEX_FILTER_FANT, true, false, false, false, CompressionQualityLevel::Normal, BlockEncoderBackend::DirectXTex, ChannelViewMode::Rgba, 1.0f, CompressionThreadingMode::Off, 0, false, false, false, 0.0f, false, DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim },
+    mOutputDirectory {},
+    mManifestPath {},
+    mLogPath {},
+    mLogStream {},
+    mManifest {},
+    mDiskCache {},
+    mWorkerCount { std::max(1u, std::thread::hardware_concurrency()) },
+    mForceRebuild { false },
+    mComputeQuality { false },
+    mFiles {},
+    mNextFileIndex { 0 },
+    mFailedCount { 0 },
+    mSkippedCount { 0 },
+    mReportMutex {} {
+}
+
+TextureBatchConverter::~TextureBatchConverter() {
+}
+
+TextureBatchConverter::TextureBatchConverter(const TextureBatchConverter& Other) :
+    mSettings { Other.mSettings },
+    mOutputDirectory { Other.mOutputDirectory },
+    mManifestPath { Other.mManifestPath },
+    mLogPath { Other.mLogPath },
+    mLogStream {},
+    mManifest { Other.mManifest },
+    mDiskCache { Other.mDiskCache },
+    mWorkerCount { Other.mWorkerCount },
+    mForceRebuild { Other.mForceRebuild },
+    mComputeQuality { Other.mComputeQuality },
+    mFiles { Other.mFiles },
+    mNextFileIndex { 0 },
+    mFailedCount { 0 },
+    mSkippedCount { 0 },
+    mReportMutex {} {
+}
+
+TextureBatchConverter& TextureBatchConverter::operator=(const TextureBatchConverter& Other) {
+    if (this != &Other) {
+        mSettings = Other.mSettings;
+        mOutputDirectory = Other.mOutputDirectory;
+        mManifestPath = Other.mManifestPath;
+        mLogPath = Other.mLogPath;
+        mLogStream = std::ofstream {};
+        mManifest = Other.mManifest;
+        mDiskCache = Other.mDiskCache;
+        mWorkerCount = Other.mWorkerCount;
+        mForceRebuild = Other.mForceRebuild;
+        mComputeQuality = Other.mComputeQuality;
+        mFiles = Other.mFiles;
+        mNextFileIndex = 0;
+        mFailedCount = 0;
+        mSkippedCount = 0;
+    }
+    return *this;
+}
+
+TextureBatchConverter::TextureBatchConverter(TextureBatchConverter&& Other) noexcept :
+    mSettings { Other.mSettings },
+    mOutputDirectory { std::move(Other.mOutputDirectory) },
+    mManifestPath { std::move(Other.mManifestPath) },
+    mLogPath { std::move(Other.mLogPath) },
+    mLogStream { std::move(Other.mLogStream) },
+    mManifest { std::move(Other.mManifest) },
+    mDiskCache { std::move(Other.mDiskCache) },
+    mWorkerCount { Other.mWorkerCount },
+    mForceRebuild { Other.mForceRebuild },
+    mComputeQuality { Other.mComputeQuality },
+    mFiles { std::move(Other.mFiles) },
+    mNextFileIndex { 0 },
+    mFailedCount { 0 },
+    mSkippedCount { 0 },
+    mReportMutex {} {
+}
+
+TextureBatchConverter& TextureBatchConverter::operator=(TextureBatchConverter&& Other) noexcept {
+    if (this != &Other) {
+        mSettings = Other.mSettings;
+        mOutputDirectory = std::move(Other.mOutputDirectory);
+        mManifestPath = std::move(Other.mManifestPath);
+        mLogPath = std::move(Other.mLogPath);
+        mLogStream = std::move(Other.mLogStream);
+        mManifest = std::move(Other.mManifest);
+        mDiskCache = std::move(Other.mDiskCache);
+        mWorkerCount = Other.mWorkerCount;
+        mForceRebuild = Other.mForceRebuild;
+        mComputeQuality = Other.mComputeQuality;
+        mFiles = std::move(Other.mFiles);
+        mNextFileIndex = 0;
+        mFailedCount = 0;
+        mSkippedCount = 0;
+    }
+    return *this;
+}
+
+bool TextureBatchConverter::ParseCommandLine(int ArgumentCount, char** Arguments) {
+    std::vector<std::string> Inputs {};
+    for (int Index { 1 }; Index < ArgumentCount; ++Index) {
+        const std::string Argument { Arguments[Index] };
+        const bool HasValue { Index + 1 < ArgumentCount };
+        if ((Argument == "-s" || Argument == "--settings") && HasValue) {
+            if (!LoadSettingsFile(Arguments[++Index])) {
+                return false;
+            }
+        }
+        else if ((Argument == "-o" || Argument == "--output") && HasValue) {
+            mOutputDirectory = Arguments[++Index];
+        }
+        else if ((Argument == "-m" || Argument == "--manifest") && HasValue) {
+            mManifestPath = Arguments[++Index];
+        }
+        else if ((Argument == "-l" || Argument == "--log") && HasValue) {
+            mLogPath = Arguments[++Index];
+        }
+        else if ((Argument == "-c" || Argument == "--cache") && HasValue) {
+            mDiskCache = std::make_shared<DiskResultCache>();
+            if (!mDiskCache->Open(Arguments[++Index], DefaultDiskCacheBudget)) {
+                std::fprintf(stderr, "Cannot open cache directory: %s\n", Arguments[Index]);
+                return false;
+            }
+        }
+        else if (Argument == "-f" || Argument == "--force") {
+            mForceRebuild = true;
+        }
+        else if (Argument == "-q" || Argument == "--quality") {
+            mComputeQuality = true;
+        }
+        else if ((Argument == "-j" || Argument == "--jobs") && HasValue) {
+            uint32_t WorkerCount { 0 };
+            if (!ParseUnsigned(Arguments[++Index], WorkerCount) || WorkerCount == 0) {
+                std::fprintf(stderr, "Invalid job count: %s\n", Arguments[Index]);
+                return false;
+            }
+            mWorkerCount = WorkerCount;
+        }
+        else if (Argument.size() > 1 && Argument[0] == '-') {
+            std::fprintf(stderr, "Unknown option: %s\n", Argument.c_str());
+            return false;
+        }
+        else {
+            Inputs.push_back(Argument);
+        }
+    }
+    if (Inputs.empty()) {
+        return false;
+    }
+    if (!CollectInputs(Inputs)) {
+        return false;
+    }
+    if (mManifestPath.empty()) {
+        mManifestPath = (mOutputDirectory.empty() ? mFiles.front().OutputPath.parent_path() : mOutputDirectory) / DefaultManifestFileName;
+    }
+    return true;
+}
+
+int TextureBatchConverter::Run() {
+    mNextFileIndex = 0;
+    mFailedCount = 0;
+    mSkippedCount = 0;
+    mManifest.Load(mManifestPath);
+    PipelineProfiler::GetInstance().Reset();
+    if (!mLogPath.empty()) {
+        mLogStream = std::ofstream { mLogPath, std::ios::trunc };
+        if (!mLogStream) {
+            std::fprintf(stderr, "Cannot open log file: %s\n", mLogPath.string().c_str());
+            return 1;
+        }
+    }
+    const uint32_t WorkerCount { static_cast<uint32_t>(std::min<size_t>(mWorkerCount, std::max<size_t>(mFiles.size(), 1))) };
+    const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+    std::vector<std::thread> Workers {};
+    Workers.reserve(WorkerCount > 0 ? WorkerCount - 1 : 0);
+    for (uint32_t WorkerIndex { 1 }; WorkerIndex < WorkerCount; ++WorkerIndex) {
+        Workers.emplace_back(&TextureBatchConverter::WorkerLoop, this, WorkerIndex);
+    }
+    WorkerLoop(0);
+    for (std::thread& Worker : Workers) {
+        Worker.join();
+    }
+    if (!mManifest.Save(mManifestPath)) {
+        std::fprintf(stderr, "Cannot write manifest: %s\n", mManifestPath.string().c_str());
+    }
+    const double TotalMilliseconds { ElapsedMilliseconds(Start) };
+    const size_t SucceededCount { mFiles.size() - mFailedCount.load() };
+    std::printf("Converted %zu of %zu files (%zu up to date) with %u workers in %.1f ms\n", SucceededCount - mSkippedCount.load(), mFiles.size(), mSkippedCount.load(), WorkerCount, TotalMilliseconds);
+    WriteLogSummary(WorkerCount, TotalMilliseconds);
+    return mFailedCount.load() == 0 ? 0 : 1;
+}
+
+void TextureBatchConverter::PrintUsage() {
+    std::printf(
+        "Usage: TextureBatchConverter [options] <file|directory|@listfile>...\n"
+        "  -s, --settings <file>  key=value settings (format, mip_filter, generate_mipmaps, srgb, normal_map,\n"
+        "                         reconstruct_z, quality, alpha_weight, threading, thread_count, tile_scheduler,\n"
+        "                         encoder=directxtex|native, rdo_lambda; format=auto picks the smallest format\n"
+        "                         meeting auto_psnr (dB, default 40) and auto_ssim (default 0.97))\n"
+        "  -o, --output <dir>     output directory (default: next to each source)\n"
+        "  -j, --jobs <count>     number of files converted in parallel (default: hardware threads)\n"
+        "  -m, --manifest <file>  incremental build manifest (default: TextureBatchManifest.txt in the output directory, or beside the first output)\n"
+        "  -f, --force            rebuild every input regardless of the manifest\n"
+        "  -c, --cache <dir>      shared on-disk compressed result cache (8 GiB LRU)\n"
+        "  -l, --log <file>       per-file and per-stage timing log as JSON lines\n"
+        "  -q, --quality          report per-mip, per-channel MSE/PSNR/SSIM of each converted file\n");
+}
+
+bool TextureBatchConverter::LoadSettingsFile(const std::filesystem::path& SettingsPath) {
+    std::ifstream Stream { SettingsPath };
+    if (!Stream) {
+        std::fprintf(stderr, "Cannot open settings file: %s\n", SettingsPath.string().c_str());
+        return false;
+    }
+    std::string Line {};
+    size_t LineNumber { 0 };
+    while (std::getline(Stream, Line)) {
+        ++LineNumber;
+        const std::string Content { Trim(Line.substr(0, Line.find('#'))) };
+        if (Content.empty()) {
+            continue;
+        }
+        const size_t Separator { Content.find('=') };
+        if (Separator == std::string::npos || !ApplySetting(ToLower(Trim(Content.substr(0, Separator))), Trim(Content.substr(Separator + 1)))) {
+            std::fprintf(stderr, "%s:%zu: invalid setting '%s'\n", SettingsPath.string().c_str(), LineNumber, Content.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TextureBatchConverter::ApplySetting(const std::string& Key, const std::string& Value) {
+    const std::string LowerValue { ToLower(Value) };
+    if (Key == "format") {
+        mSettings.AutoFormat = LowerValue == "auto";
+        if (mSettings.AutoFormat) {
+            return true;
+        }
+        for (const FormatOption& Option : BuildCompressionCandidateFormats()) {
+            if (ToLower(Option.Name) == LowerValue) {
+                mSettings.Format = Option.Format;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (Key == "mip_filter") {
+        if (LowerValue == "point") {
+            mSettings.MipFilter = TEX_FILTER_POINT;
+        }
+        else if (LowerValue == "linear") {
+            mSettings.MipFilter = TEX_FILTER_LINEAR;
+        }
+        else if (LowerValue == "cubic") {
+            mSettings.MipFilter = TEX_FILTER_CUBIC;
+        }
+        else if (LowerValue == "fant" || LowerValue == "box") {
+            mSettings.MipFilter = TEX_FILTER_FANT;
+        }
+        else if (LowerValue == "triangle") {
+            mSettings.MipFilter = TEX_FILTER_TRIANGLE;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+    if (Key == "quality") {
+        if (LowerValue == "fast") {
+            mSettings.CompressionQuality = CompressionQualityLevel::Fast;
+        }
+        else if (LowerValue == "normal") {
+            mSettings.CompressionQuality = CompressionQualityLevel::Normal;
+        }
+        else if (LowerValue == "best" || LowerValue == "high") {
+            mSettings.CompressionQuality = CompressionQualityLevel::Best;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+    if (Key == "threading") {
+        if (LowerValue == "off") {
+            mSettings.Threading = CompressionThreadingMode::Off;
+        }
+        else if (LowerValue == "auto") {
+            mSettings.Threading = CompressionThreadingMode::Auto;
+        }
+        else if (LowerValue == "explicit") {
+            mSettings.Threading = CompressionThreadingMode::Explicit;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+    if (Key == "alpha_weight") {
+        char* End { nullptr };
+        const float Weight { std::strtof(Value.c_str(), &End) };
+        if (End == Value.c_str() || *End != '\0' || Weight < 0.0f) {
+            return false;
+        }
+        mSettings.AlphaWeight = Weight;
+        return true;
+    }
+    if (Key == "auto_psnr") {
+        char* End { nullptr };
+        const float Psnr { std::strtof(Value.c_str(), &End) };
+        if (End == Value.c_str() || *End != '\0' || Psnr < 0.0f) {
+            return false;
+        }
+        mSettings.AutoFormatMinimumPsnr = Psnr;
+        return true;
+    }
+    if (Key == "auto_ssim") {
+        char* End { nullptr };
+        const float Ssim { std::strtof(Value.c_str(), &End) };
+        if (End == Value.c_str() || *End != '\0' || Ssim < 0.0f || Ssim > 1.0f) {
+            return false;
+        }
+        mSettings.AutoFormatMinimumSsim = Ssim;
+        return true;
+    }
+    if (Key == "rdo_lambda") {
+        char* End { nullptr };
+        const float Lambda { std::strtof(Value.c_str(), &End) };
+        if (End == Value.c_str() || *End != '\0' || Lambda < 0.0f) {
+            return false;
+        }
+        mSettings.RdoLambda = Lambda;
+        return true;
+    }
+    if (Key == "thread_count") {
+        return ParseUnsigned(Value, mSettings.ThreadCount);
+    }
+    if (Key == "generate_mipmaps") {
+        return ParseBool(Value, mSettings.GenerateMipmaps);
+    }
+    if (Key == "srgb") {
+        return ParseBool(Value, mSettings.IsSrgb);
+    }
+    if (Key == "normal_map") {
+        return ParseBool(Value, mSettings.IsNormalMap);
+    }
+    if (Key == "reconstruct_z") {
+        return ParseBool(Value, mSettings.ReconstructZ);
+    }
+    if (Key == "tile_scheduler") {
+        return ParseBool(Value, mSettings.UseTileScheduler);
+    }
+    if (Key == "encoder") {
+        return ParseBlockEncoderBackend(LowerValue.c_str(), mSettings.EncoderBackend);
+    }
+    return false;
+}
+
+bool TextureBatchConverter::CollectInputs(const std::vector<std::string>& Inputs) {
+    for (const std::string& Input : Inputs) {
+        if (Input.size() > 1 && Input[0] == '@') {
+            std::ifstream Stream { std::filesystem::path { Input.substr(1) } };
+            if (!Stream) {
+                std::fprintf(stderr, "Cannot open file list: %s\n", Input.c_str() + 1);
+                return false;
+            }
+            std::string Line {};
+            while (std::getline(Stream, Line)) {
+                const std::string Entry { Trim(Line) };
+                if (!Entry.empty() && Entry[0] != '#' && !AddInputPath(Entry)) {
+                    return false;
+                }
+            }
+        }
+        else if (!AddInputPath(Input)) {
+            return false;
+        }
+    }
+    if (mFiles.empty()) {
+        std::fprintf(stderr, "No supported input files found\n");
+        return false;
+    }
+    return true;
+}
+
+bool TextureBatchConverter::AddInputPath(const std::filesystem::path& InputPath) {
+    std::error_code Error {};
+    if (std::filesystem::is_directory(InputPath, Error)) {
+        std::vector<std::filesystem::path> Found {};
+        for (std::filesystem::recursive_directory_iterator Iterator { InputPath, std::filesystem::directory_options::skip_permission_denied, Error }, End {}; !Error && Iterator != End; Iterator.increment(Error)) {
+            if (Iterator->is_regular_file(Error) && IsSupportedExtension(Iterator->path())) {
+                Found.push_back(Iterator->path());
+            }
+        }
+        if (Error) {
+            std::fprintf(stderr, "Cannot scan directory %s: %s\n", InputPath.string().c_str(), Error.message().c_str());
+            return false;
+        }
+        std::sort(Found.begin(), Found.end());
+        for (const std::filesystem::path& SourcePath : Found) {
+            mFiles.push_back(BatchInputFile { SourcePath, ResolveOutputPath(SourcePath, InputPath) });
+        }
+        return true;
+    }
+    if (!std::filesystem::is_regular_file(InputPath, Error)) {
+        std::fprintf(stderr, "Input not found: %s\n", InputPath.string().c_str());
+        return false;
+    }
+    mFiles.push_back(BatchInputFile { InputPath, ResolveOutputPath(InputPath, InputPath.parent_path()) });
+    return true;
+}
+
+std::filesystem::path TextureBatchConverter::ResolveOutputPath(const std::filesystem::path& SourcePath, const std::filesystem::path& InputRoot) const {
+    if (!mOutputDirectory.empty()) {
+        std::filesystem::path Relative { SourcePath.lexically_relative(InputRoot) };
+        if (Relative.empty() || *Relative.begin() == "..") {
+            Relative = SourcePath.filename();
+        }
+        return (mOutputDirectory / Relative).replace_extension(".dds");
+    }
+    std::filesystem::path OutputPath { SourcePath };
+    if (ToLower(SourcePath.extension().string()) == ".dds") {
+        OutputPath.replace_filename(SourcePath.stem().string() + "_converted.dds");
+        return OutputPath;
+    }
+    return OutputPath.replace_extension(".dds");
+}
+
+void TextureBatchConverter::WorkerLoop(uint32_t WorkerIndex) {
+    CompressionPreviewCache Cache {};
+    Cache.SetResultCacheBudget(0);
+    Cache.SetDiskCache(mDiskCache);
+    for (size_t FileIndex { mNextFileIndex.fetch_add(1) }; FileIndex < mFiles.size(); FileIndex = mNextFileIndex.fetch_add(1)) {
+        const uint64_t JobId { (static_cast<uint64_t>(WorkerIndex) << 32) | static_cast<uint64_t>(FileIndex + 1) };
+        ReportResult(ConvertFile(mFiles[FileIndex], Cache, JobId));
+    }
+}
+
+bool TextureBatchConverter::BuildManifestEntry(const BatchInputFile& File, ManifestEntry& EntryOut, ManifestEntry& PreviousOut, bool& HasPreviousOut) const {
+    std::error_code Error {};
+    const std::filesystem::path SourcePath { std::filesystem::absolute(File.SourcePath, Error).lexically_normal() };
+    const uintmax_t SourceSize { std::filesystem::file_size(File.SourcePath, Error) };
+    if (Error) {
+        return false;
+    }
+    const std::filesystem::file_time_type WriteTime { std::filesystem::last_write_time(File.SourcePath, Error) };
+    if (Error) {
+        return false;
+    }
+    EntryOut = ManifestEntry { SourcePath, SourceSize, static_cast<int64_t>(WriteTime.time_since_epoch().count()), 0, ComputeSettingsHash(mSettings), ToolVersion, std::filesystem::absolute(File.OutputPath, Error).lexically_normal() };
+    HasPreviousOut = !mForceRebuild && mManifest.TryGet(SourcePath, PreviousOut);
+    if (HasPreviousOut && PreviousOut.SourceSize == EntryOut.SourceSize && PreviousOut.SourceWriteTime == EntryOut.SourceWriteTime) {
+        EntryOut.ContentHash = PreviousOut.ContentHash;
+        return true;
+    }
+    return ComputeFileContentHash(File.SourcePath, EntryOut.ContentHash);
+}
+
+BatchFileResult TextureBatchConverter::ConvertFile(const BatchInputFile& File, CompressionPreviewCache& Cache, uint64_t JobId) {
+    BatchFileResult Result { File, false, false, {}, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, false, CompressionTimings {}, TextureQualityReport {}, AutoFormatSearchResult {} };
+    const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+
+    ManifestEntry Entry {};
+    ManifestEntry Previous {};
+    bool HasPrevious { false };
+    if (!BuildManifestEntry(File, Entry, Previous, HasPrevious)) {
+        Result.Error = "cannot read source";
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+    Result.HashMilliseconds = ElapsedMilliseconds(Start);
+    std::error_code Error {};
+    if (HasPrevious && Previous.ContentHash == Entry.ContentHash && Previous.SettingsHash == Entry.SettingsHash && Previous.ToolVersion == Entry.ToolVersion && Previous.OutputPath == Entry.OutputPath && std::filesystem::is_regular_file(File.OutputPath, Error)) {
+        mManifest.Update(Entry);
+        Result.Succeeded = true;
+        Result.Skipped = true;
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+
+    const std::chrono::steady_clock::time_point LoadStart { std::chrono::steady_clock::now() };
+    TextureDocument Document {};
+    if (!Document.LoadFromFile(File.SourcePath)) {
+        Result.Error = "load failed";
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+    Result.LoadMilliseconds = ElapsedMilliseconds(LoadStart);
+    const TextureImageView Source { Document.GetSourceImage() };
+    Result.SourcePixels = CountImagePixels(Source.Images, Source.ImageCount);
+    Result.SourceBytes = CountImageBytes(Source.Images, Source.ImageCount);
+
+    if (mSettings.AutoFormat && !SearchAutoFormat(Document, mSettings, CompressionJobHandle { JobId }, Result.AutoFormat)) {
+        Result.Error = "auto format search failed";
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+    const AnalyzerSettings Settings { mSettings.AutoFormat ? ResolveAutoFormatSettings(mSettings, Result.AutoFormat) : mSettings };
+    if (!Cache.Rebuild(Document, Settings, CompressionJobHandle { JobId })) {
+        Result.Error = "compression failed";
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+    Result.Timings = Cache.GetLastTimings();
+    Result.OutputBytes = Cache.GetCompressedImage().GetPixelsSize();
+    size_t PackagedBytes { 0 };
+    if (!mLogPath.empty() && MeasureDeflatedSize(Cache.GetCompressedImage().GetPixels(), Cache.GetCompressedImage().GetPixelsSize(), PackagedBytes)) {
+        Result.PackagedBytes = PackagedBytes;
+        Result.HasPackagedBytes = true;
+    }
+    if (mComputeQuality) {
+        const std::shared_ptr<const ScratchImage> Compressed { Cache.GetCompressedSnapshot() };
+        if (Compressed == nullptr || !ComputeTextureQualityReport(Source, TextureImageView { Compressed->GetImages(), Compressed->GetImageCount(), Compressed->GetMetadata() }, ResolveMipFilter(Settings), CompressionJobHandle { JobId }, Result.Quality)) {
+            Result.Error = "quality evaluation failed";
+            Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+            return Result;
+        }
+    }
+
+    const std::chrono::steady_clock::time_point SaveStart { std::chrono::steady_clock::now() };
+    if (File.OutputPath.has_parent_path()) {
+        std::filesystem::create_directories(File.OutputPath.parent_path(), Error);
+    }
+    if (Error || !Cache.SaveAsDds(File.OutputPath)) {
+        Result.Error = "save failed";
+        Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+        return Result;
+    }
+    Result.SaveMilliseconds = ElapsedMilliseconds(SaveStart);
+    mManifest.Update(Entry);
+    Result.TotalMilliseconds = ElapsedMilliseconds(Start);
+    Result.Succeeded = true;
+    return Result;
+}
+
+void TextureBatchConverter::ReportResult(const BatchFileResult& Result) {
+    std::lock_guard<std::mutex> Lock { mReportMutex };
+    WriteLogEntry(Result);
+    if (!Result.Succeeded) {
+        ++mFailedCount;
+        std::fprintf(stderr, "FAILED %s: %s\n", Result.File.SourcePath.string().c_str(), Result.Error.c_str());
+        return;
+    }
+    if (Result.Skipped) {
+        ++mSkippedCount;
+        std::printf("%s -> %s | up to date | hash %.1f ms\n", Result.File.SourcePath.string().c_str(), Result.File.OutputPath.string().c_str(), Result.HashMilliseconds);
+        return;
+    }
+    std::printf("%s -> %s | hash %.1f ms | load %.1f ms | decode %.1f ms | mip %.1f ms | compress %.1f ms | save %.1f ms | total %.1f ms\n",
+        Result.File.SourcePath.string().c_str(), Result.File.OutputPath.string().c_str(),
+        Result.HashMilliseconds, Result.LoadMilliseconds, Result.Timings.DecodeMilliseconds, Result.Timings.MipMilliseconds,
+        Result.Timings.CompressMilliseconds, Result.SaveMilliseconds, Result.TotalMilliseconds);
+    for (const MipQualityMetrics& Mip : Result.Quality.Mips) {
+        std::printf("    mip %zu %zux%zu | PSNR %.2f %.2f %.2f %.2f dB | SSIM %.4f %.4f %.4f %.4f | MSE %.3e %.3e %.3e %.3e\n",
+            Mip.MipLevel, Mip.Width, Mip.Height, Mip.Psnr[0], Mip.Psnr[1], Mip.Psnr[2], Mip.Psnr[3], Mip.Ssim[0], Mip.Ssim[1], Mip.Ssim[2], Mip.Ssim[3], Mip.Mse[0], Mip.Mse[1], Mip.Mse[2], Mip.Mse[3]);
+    }
+    if (!Result.AutoFormat.Candidates.empty()) {
+        std::printf("    auto %s%s | %zu candidates on %zux%zu probe | search %.1f ms\n", Result.AutoFormat.FormatName.c_str(), Result.AutoFormat.MeetsTarget ? "" : " (target not met)",
+            Result.AutoFormat.Candidates.size(), Result.AutoFormat.ProbeWidth, Result.AutoFormat.ProbeHeight, Result.AutoFormat.SearchMilliseconds);
+    }
+}
+
+void TextureBatchConverter::WriteLogEntry(const BatchFileResult& Result) {
+    if (!mLogStream.is_open()) {
+        return;
+    }
+    const char* Status { !Result.Succeeded ? "failed" : (Result.Skipped ? "up_to_date" : "converted") };
+    char PackagedBytes[32] { "null" };
+    if (Result.HasPackagedBytes) {
+        std::snprintf(PackagedBytes, sizeof(PackagedBytes), "%llu", static_cast<unsigned long long>(Result.PackagedBytes));
+    }
+    char Buffer[1024] {};
+    std::snprintf(Buffer, sizeof(Buffer),
+        "\"status\":\"%s\",\"pixels\":%llu,\"source_bytes\":%llu,\"output_bytes\":%llu,\"packaged_bytes\":%s,\"threads\":%u,\"result_cache_hit\":%s,\"disk_cache_hit\":%s,"
+        "\"hash_ms\":%.3f,\"load_ms\":%.3f,\"decode_ms\":%.3f,\"mips_ms\":%.3f,\"compress_ms\":%.3f,\"save_ms\":%.3f,\"total_ms\":%.3f,"
+        "\"load_mpix_s\":%.3f,\"compress_mpix_s\":%.3f,\"total_mpix_s\":%.3f",
+        Status, static_cast<unsigned long long>(Result.SourcePixels), static_cast<unsigned long long>(Result.SourceBytes), static_cast<unsigned long long>(Result.OutputBytes), PackagedBytes,
+        Result.Timings.ThreadCount, Result.Timings.ResultCacheHit ? "true" : "false", Result.Timings.DiskCacheHit ? "true" : "false",
+        Result.HashMilliseconds, Result.LoadMilliseconds, Result.Timings.DecodeMilliseconds, Result.Timings.MipMilliseconds, Result.Timings.CompressMilliseconds, Result.SaveMilliseconds, Result.TotalMilliseconds,
+        ComputeMegapixelsPerSecond(Result.SourcePixels, Result.LoadMilliseconds), ComputeMegapixelsPerSecond(Result.SourcePixels, Result.Timings.CompressMilliseconds), ComputeMegapixelsPerSecond(Result.SourcePixels, Result.TotalMilliseconds));
+    mLogStream << "{\"type\":\"file\",\"source\":\"" << EscapeJson(Result.File.SourcePath.generic_string()) << "\",\"output\":\"" << EscapeJson(Result.File.OutputPath.generic_string())
+        << "\",\"error\":\"" << EscapeJson(Result.Error) << "\"," << Buffer << ",\"quality\":[";
+    for (size_t Index { 0 }; Index < Result.Quality.Mips.size(); ++Index) {
+        const MipQualityMetrics& Mip { Result.Quality.Mips[Index] };
+        std::snprintf(Buffer, sizeof(Buffer), "%s{\"mip\":%zu,\"width\":%zu,\"height\":%zu,\"psnr\":[%.4f,%.4f,%.4f,%.4f],\"ssim\":[%.6f,%.6f,%.6f,%.6f],\"mse\":[%.6e,%.6e,%.6e,%.6e]}",
+            Index == 0 ? "" : ",", Mip.MipLevel, Mip.Width, Mip.Height, Mip.Psnr[0], Mip.Psnr[1], Mip.Psnr[2], Mip.Psnr[3], Mip.Ssim[0], Mip.Ssim[1], Mip.Ssim[2], Mip.Ssim[3], Mip.Mse[0], Mip.Mse[1], Mip.Mse[2], Mip.Mse[3]);
+        mLogStream << Buffer;
+    }
+    mLogStream << "]";
+    if (!Result.AutoFormat.Candidates.empty()) {
+        std::snprintf(Buffer, sizeof(Buffer), ",\"auto_format\":{\"format\":\"%s\",\"meets_target\":%s,\"probe_width\":%zu,\"probe_height\":%zu,\"search_ms\":%.3f,\"candidates\":[",
+            Result.AutoFormat.FormatName.c_str(), Result.AutoFormat.MeetsTarget ? "true" : "false", Result.AutoFormat.ProbeWidth, Result.AutoFormat.ProbeHeight, Result.AutoFormat.SearchMilliseconds);
+        mLogStream << Buffer;
+        for (size_t Index { 0 }; Index < Result.AutoFormat.Candidates.size(); ++Index) {
+            const AutoFormatCandidate& Candidate { Result.AutoFormat.Candidates[Index] };
+            std::snprintf(Buffer, sizeof(Buffer), "%s{\"format\":\"%s\",\"bits_per_pixel\":%zu,\"encoded\":%s,\"psnr\":%.4f,\"ssim\":%.6f,\"encode_ms\":%.3f}",
+                Index == 0 ? "" : ",", Candidate.Name.c_str(), Candidate.BitsPerPixel, Candidate.IsEncoded ? "true" : "false", Candidate.Psnr, Candidate.Ssim, Candidate.EncodeMilliseconds);
+            mLogStream << Buffer;
+        }
+        mLogStream << "]}";
+    }
+    mLogStream << "}\n";
+}
+
+void TextureBatchConverter::WriteLogSummary(uint32_t WorkerCount, double TotalMilliseconds) {
+    if (!mLogStream.is_open()) {
+        return;
+    }
+    char Buffer[512] {};
+    std::snprintf(Buffer, sizeof(Buffer), "{\"type\":\"summary\",\"files\":%zu,\"failed\":%zu,\"up_to_date\":%zu,\"workers\":%u,\"total_ms\":%.3f,\"stages\":[",
+        mFiles.size(), mFailedCount.load(), mSkippedCount.load(), WorkerCount, TotalMilliseconds);
+    mLogStream << Buffer;
+    const PipelineProfiler& Profiler { PipelineProfiler::GetInstance() };
+    for (size_t StageIndex { 0 }; StageIndex < static_cast<size_t>(PipelineStage::Count); ++StageIndex) {
+        const PipelineStage Stage { static_cast<PipelineStage>(StageIndex) };
+        const PipelineStageStatistics Statistics { Profiler.GetStatistics(Stage) };
+        std::snprintf(Buffer, sizeof(Buffer), "%s{\"stage\":\"%s\",\"samples\":%llu,\"total_ms\":%.3f,\"peak_ms\":%.3f,\"pixels\":%llu,\"bytes\":%llu,\"mpix_s\":%.3f}",
+            StageIndex == 0 ? "" : ",", GetPipelineStageName(Stage), static_cast<unsigned long long>(Statistics.SampleCount), Statistics.TotalMilliseconds, Statistics.PeakMilliseconds,
+            static_cast<unsigned long long>(Statistics.TotalPixels), static_cast<unsigned long long>(Statistics.TotalBytes), ComputeMegapixelsPerSecond(Statistics.TotalPixels, Statistics.TotalMilliseconds));
+        mLogStream << Buffer;
+    }
+    mLogStream << "]}\n";
+    mLogStream.flush();
+}
+
+int main(int ArgumentCount, char** Arguments) {
+    TextureBatchConverter Converter {};
+    if (!Converter.ParseCommandLine(ArgumentCount, Arguments)) {
+        TextureBatchConverter::PrintUsage();
+        return 2;
+    }
+    return Converter.Run();
+}
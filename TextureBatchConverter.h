@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "AutoFormatSearch.h"
+#include "ConversionManifest.h"
+#include "TextureCompressionCore.h"
+#include "TextureQualityMetrics.h"
+
+struct BatchInputFile {
+    std::filesystem::path SourcePath;
+    std::filesystem::path OutputPath;
+};
+
+struct BatchFileResult {
+    BatchInputFile File;
+    bool Succeeded;
+    bool Skipped;
+    std::string Error;
+    double HashMilliseconds;
+    double LoadMilliseconds;
+    double SaveMilliseconds;
+    double TotalMilliseconds;
+    uint64_t SourcePixels;
+    uint64_t SourceBytes;
+    uint64_t OutputBytes;
+    uint64_t PackagedBytes;
+    bool HasPackagedBytes;
+    CompressionTimings Timings;
+    TextureQualityReport Quality;
+    AutoFormatSearchResult AutoFormat;
+};
+
+class TextureBatchConverter {
+public:
+    TextureBatchConverter();
+    ~TextureBatchConverter();
+    TextureBatchConverter(const TextureBatchConverter& Other);
+    TextureBatchConverter& operator=(const TextureBatchConverter& Other);
+    TextureBatchConverter(TextureBatchConverter&& Other) noexcept;
+    TextureBatchConverter& operator=(TextureBatchConverter&& Other) noexcept;
+
+public:
+    bool ParseCommandLine(int ArgumentCount, char** Arguments);
+    int Run();
+    static void PrintUsage();
+
+private:
+    bool LoadSettingsFile(const std::filesystem::path& SettingsPath);
+    bool ApplySetting(const std::string& Key, const std::string& Value);
+    bool CollectInputs(const std::vector<std::string>& Inputs);
+    bool AddInputPath(const std::filesystem::path& InputPath);
+    std::filesystem::path ResolveOutputPath(const std::filesystem::path& SourcePath, const std::filesystem::path& InputRoot) const;
+    void WorkerLoop(uint32_t WorkerIndex);
+    bool BuildManifestEntry(const BatchInputFile& File, ManifestEntry& EntryOut, ManifestEntry& PreviousOut, bool& HasPreviousOut) const;
+    BatchFileResult ConvertFile(const BatchInputFile& File, CompressionPreviewCache& Cache, uint64_t JobId);
+    void ReportResult(const BatchFileResult& Result);
+    void WriteLogEntry(const BatchFileResult& Result);
+    void WriteLogSummary(uint32_t WorkerCount, double TotalMilliseconds);
+
+private:
+    AnalyzerSettings mSettings;
+    std::filesystem::path mOutputDirectory;
+    std::filesystem::path mManifestPath;
+    std::filesystem::path mLogPath;
+    std::ofstream mLogStream;
+    ConversionManifest mManifest;
+    std::shared_ptr<DiskResultCache> mDiskCache;
+    uint32_t mWorkerCount;
+    bool mForceRebuild;
+    bool mComputeQuality;
+    std::vector<BatchInputFile> mFiles;
+    std::atomic<size_t> mNextFileIndex;
+    std::atomic<size_t> mFailedCount;
+    std::atomic<size_t> mSkippedCount;
+    std::mutex mReportMutex;
+};
@@ -0,0 +1,949 @@
+#include "TextureCompressionBenchmark.h"
+#include "ErrorMetricKernels.h"
+#include "TextureQualityMetrics.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#endif
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t BenchmarkVersion { 4 };
+    constexpr uint32_t DefaultRepetitions { 3 };
+    constexpr size_t MinimumImageSize { 4 };
+    constexpr double VerificationMseTolerance { 1e-4 };
+    constexpr double VerificationSsimTolerance { 1e-3 };
+    constexpr double EncoderParityColorToleranceDb { 1.0 };
+    constexpr double EncoderParityChannelToleranceDb { 0.5 };
+    constexpr double EncoderParityHdrToleranceDb { 2.0 };
+
+#ifdef BENCHMARK_REFERENCE_DIRECTORY
+    constexpr const char* DefaultReferenceDirectory { BENCHMARK_REFERENCE_DIRECTORY };
+#else
+    constexpr const char* DefaultReferenceDirectory { "Benchmark/Reference" };
+#endif
+
+    double ElapsedMilliseconds(const std::chrono::steady_clock::time_point& Start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    std::string ToLower(std::string Text) {
+        std::transform(Text.begin(), Text.end(), Text.begin(), [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+        return Text;
+    }
+
+    std::vector<std::string> SplitList(const std::string& Text) {
+        std::vector<std::string> Items {};
+        std::istringstream Stream { Text };
+        std::string Item {};
+        while (std::getline(Stream, Item, ',')) {
+            if (!Item.empty()) {
+                Items.push_back(Item);
+            }
+        }
+        return Items;
+    }
+
+    bool ParseUnsigned(const std::string& Value, uint32_t& ValueOut) {
+        uint64_t Parsed { 0 };
+        const char* const End { Value.data() + Value.size() };
+        const std::from_chars_result Result { std::from_chars(Value.data(), End, Parsed) };
+        if (Value.empty() || Result.ec != std::errc {} || Result.ptr != End || Parsed > std::numeric_limits<uint32_t>::max()) {
+            return false;
+        }
+        ValueOut = static_cast<uint32_t>(Parsed);
+        return true;
+    }
+
+    bool ParseQuality(const std::string& Value, CompressionQualityLevel& QualityOut) {
+        const std::string Lower { ToLower(Value) };
+        if (Lower == "fast") {
+            QualityOut = CompressionQualityLevel::Fast;
+        }
+        else if (Lower == "normal") {
+            QualityOut = CompressionQualityLevel::Normal;
+        }
+        else if (Lower == "best" || Lower == "high") {
+            QualityOut = CompressionQualityLevel::Best;
+        }
+        else {
+            return false;
+        }
+        return true;
+    }
+
+    const char* GetQualityName(CompressionQualityLevel Quality) {
+        switch (Quality) {
+        case CompressionQualityLevel::Fast:
+            return "fast";
+        case CompressionQualityLevel::Best:
+            return "best";
+        default:
+            return "normal";
+        }
+    }
+
+    struct ReferenceImageExpectation {
+        const char* FileName;
+        size_t Width;
+        size_t Height;
+        DXGI_FORMAT Format;
+    };
+
+    constexpr ReferenceImageExpectation ReferenceImageExpectations[] {
+        { "albedo_128.tga", 128, 128, DXGI_FORMAT_R8G8B8A8_UNORM },
+        { "foliage_alpha_128.tga", 128, 128, DXGI_FORMAT_R8G8B8A8_UNORM },
+        { "normal_128.tga", 128, 128, DXGI_FORMAT_R8G8B8A8_UNORM },
+        { "skybox_hdr_128.hdr", 128, 64, DXGI_FORMAT_R32G32B32A32_FLOAT }
+    };
+
+    bool IsReferenceExtension(const std::filesystem::path& FilePath) {
+        const std::string Extension { ToLower(FilePath.extension().string()) };
+        return Extension == ".dds" || Extension == ".tga" || Extension == ".hdr";
+    }
+
+    uint8_t HashNoise(size_t X, size_t Y, uint32_t Seed) {
+        uint32_t Value { static_cast<uint32_t>(X) * 374761393u + static_cast<uint32_t>(Y) * 668265263u + Seed * 2246822519u };
+        Value = (Value ^ (Value >> 13)) * 1274126177u;
+        return static_cast<uint8_t>((Value ^ (Value >> 16)) & 0xFFu);
+    }
+
+    void ResetPeakMemory() {
+#ifndef _WIN32
+        std::ofstream Stream { "/proc/self/clear_refs" };
+        Stream << "5";
+#endif
+    }
+
+    uint64_t ReadPeakMemoryBytes() {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS Counters {};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters))) {
+            return 0;
+        }
+        return static_cast<uint64_t>(Counters.PeakWorkingSetSize);
+#else
+        std::ifstream Stream { "/proc/self/status" };
+        std::string Line {};
+        while (std::getline(Stream, Line)) {
+            if (Line.rfind("VmHWM:", 0) == 0) {
+                return std::stoull(Line.substr(6)) * 1024ull;
+            }
+        }
+        return 0;
+#endif
+    }
+
+    bool ConvertToVerificationFloat(const Image& Source, ScratchImage& Destination) {
+        Image Linear { Source };
+        Linear.format = MakeLinear(Source.format);
+        if (IsCompressed(Linear.format)) {
+            return SUCCEEDED(Decompress(Linear, DXGI_FORMAT_R32G32B32A32_FLOAT, Destination));
+        }
+        if (Linear.format == DXGI_FORMAT_R32G32B32A32_FLOAT) {
+            return SUCCEEDED(Destination.InitializeFromImage(Linear));
+        }
+        return SUCCEEDED(Convert(Linear, DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Destination));
+    }
+
+    void PerturbFloatImage(const Image& Target) {
+        for (size_t Y { 0 }; Y < Target.height; ++Y) {
+            float* Row { reinterpret_cast<float*>(Target.pixels + Y * Target.rowPitch) };
+            for (size_t X { 0 }; X < Target.width * 4; ++X) {
+                const float Offset { (static_cast<float>(HashNoise(X, Y, 7)) - 128.0f) / 2048.0f };
+                Row[X] = std::clamp(Row[X] + Offset, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    bool BuildVerificationImage(const ScratchImage& Float, ErrorMetricPixelFormat Format, ScratchImage& Storage, ErrorMetricImage& ImageOut) {
+        const Image* Source { Float.GetImage(0, 0, 0) };
+        const Image* Prepared { Source };
+        if (Format != ErrorMetricPixelFormat::Rgba32F) {
+            const DXGI_FORMAT Target { Format == ErrorMetricPixelFormat::Rgba8 ? DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_R16G16B16A16_FLOAT };
+            if (FAILED(Convert(*Source, Target, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Storage))) {
+                return false;
+            }
+            Prepared = Storage.GetImage(0, 0, 0);
+        }
+        ImageOut = ErrorMetricImage { Prepared->pixels, Prepared->rowPitch, Prepared->width, Prepared->height, Format };
+        return true;
+    }
+
+    const char* GetMetricPixelFormatName(ErrorMetricPixelFormat Format) {
+        switch (Format) {
+        case ErrorMetricPixelFormat::Rgba8:
+            return "rgba8";
+        case ErrorMetricPixelFormat::Rgba16F:
+            return "rgba16f";
+        default:
+            return "rgba32f";
+        }
+    }
+
+    bool MatchesReferenceMetrics(const ErrorMetricResult& Result, const ErrorMetricResult& Reference) {
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            if (std::fabs(Result.Mse[Channel] - Reference.Mse[Channel]) > VerificationMseTolerance * Reference.Mse[Channel] + 1e-12) {
+                return false;
+            }
+            if (std::fabs(Result.Ssim[Channel] - Reference.Ssim[Channel]) > VerificationSsimTolerance) {
+                return false;
+            }
+        }
+        return Result.Histograms == Reference.Histograms && Result.PixelCount == Reference.PixelCount;
+    }
+
+    struct EncoderParityCheck {
+        const char* Name;
+        size_t FirstChannel;
+        size_t ChannelCount;
+        double ToleranceDb;
+    };
+
+    std::vector<EncoderParityCheck> BuildEncoderParityChecks(DXGI_FORMAT Format) {
+        switch (Format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            return { { "rgb", 0, 3, EncoderParityColorToleranceDb } };
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return { { "rgb", 0, 3, EncoderParityColorToleranceDb }, { "a", 3, 1, EncoderParityChannelToleranceDb } };
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+            return { { "rgb", 0, 3, EncoderParityHdrToleranceDb } };
+        case DXGI_FORMAT_BC4_UNORM:
+            return { { "r", 0, 1, EncoderParityChannelToleranceDb } };
+        case DXGI_FORMAT_BC5_UNORM:
+            return { { "r", 0, 1, EncoderParityChannelToleranceDb }, { "g", 1, 1, EncoderParityChannelToleranceDb } };
+        default:
+            return {};
+        }
+    }
+
+    double ComputeParityPsnr(const MipQualityMetrics& Metrics, const EncoderParityCheck& Check) {
+        double Mse { 0.0 };
+        for (size_t Channel { Check.FirstChannel }; Channel < Check.FirstChannel + Check.ChannelCount; ++Channel) {
+            Mse += Metrics.Mse[Channel];
+        }
+        return ComputePsnrFromMse(Mse / static_cast<double>(Check.ChannelCount));
+    }
+}
+
+TextureCompressionBenchmark::TextureCompressionBenchmark() :
+    mReferenceDirectory { DefaultReferenceDirectory },
+    mWorkingDirectory { std::filesystem::temp_directory_path() / "TextureCompressionBenchmark" },
+    mOutputPath {},
+    mOutputFormat { BenchmarkOutputFormat::Csv },
+    mSizes { 256, 512, 1024 },
+    mThreadCounts {},
+    mQualities { CompressionQualityLevel::Fast, CompressionQualityLevel::Normal, CompressionQualityLevel::Best },
+    mEncoders { BlockEncoderBackend::DirectXTex },
+    mFormatFilters {},
+    mRepetitions { DefaultRepetitions },
+    mUseProcedural { true },
+    mUseReference { true },
+    mVerifyKernels { false },
+    mVerifyEncoders { false },
+    mVerifyReferences { false },
+    mImages {} {
+    const uint32_t HardwareThreads { std::max(1u, std::thread::hardware_concurrency()) };
+    mThreadCounts.push_back(1);
+    if (HardwareThreads > 1) {
+        mThreadCounts.push_back(HardwareThreads);
+    }
+}
+
+TextureCompressionBenchmark::~TextureCompressionBenchmark() {
+}
+
+TextureCompressionBenchmark::TextureCompressionBenchmark(const TextureCompressionBenchmark& Other) :
+    mReferenceDirectory { Other.mReferenceDirectory },
+    mWorkingDirectory { Other.mWorkingDirectory },
+    mOutputPath { Other.mOutputPath },
+    mOutputFormat { Other.mOutputFormat },
+    mSizes { Other.mSizes },
+    mThreadCounts { Other.mThreadCounts },
+    mQualities { Other.mQualities },
+    mEncoders { Other.mEncoders },
+    mFormatFilters { Other.mFormatFilters },
+    mRepetitions { Other.mRepetitions },
+    mUseProcedural { Other.mUseProcedural },
+    mUseReference { Other.mUseReference },
+    mVerifyKernels { Other.mVerifyKernels },
+    mVerifyEncoders { Other.mVerifyEncoders },
+    mVerifyReferences { Other.mVerifyReferences },
+    mImages { Other.mImages } {
+}
+
+TextureCompressionBenchmark& TextureCompressionBenchmark::operator=(const TextureCompressionBenchmark& Other) {
+    if (this != &Other) {
+        mReferenceDirectory = Other.mReferenceDirectory;
+        mWorkingDirectory = Other.mWorkingDirectory;
+        mOutputPath = Other.mOutputPath;
+        mOutputFormat = Other.mOutputFormat;
+        mSizes = Other.mSizes;
+        mThreadCounts = Other.mThreadCounts;
+        mQualities = Other.mQualities;
+        mEncoders = Other.mEncoders;
+        mFormatFilters = Other.mFormatFilters;
+        mRepetitions = Other.mRepetitions;
+        mUseProcedural = Other.mUseProcedural;
+        mUseReference = Other.mUseReference;
+        mVerifyKernels = Other.mVerifyKernels;
+        mVerifyEncoders = Other.mVerifyEncoders;
+        mVerifyReferences = Other.mVerifyReferences;
+        mImages = Other.mImages;
+    }
+    return *this;
+}
+
+TextureCompressionBenchmark::TextureCompressionBenchmark(TextureCompressionBenchmark&& Other) noexcept :
+    mReferenceDirectory { std::move(Other.mReferenceDirectory) },
+    mWorkingDirectory { std::move(Other.mWorkingDirectory) },
+    mOutputPath { std::move(Other.mOutputPath) },
+    mOutputFormat { Other.mOutputFormat },
+    mSizes { std::move(Other.mSizes) },
+    mThreadCounts { std::move(Other.mThreadCounts) },
+    mQualities { std::move(Other.mQualities) },
+    mEncoders { std::move(Other.mEncoders) },
+    mFormatFilters { std::move(Other.mFormatFilters) },
+    mRepetitions { Other.mRepetitions },
+    mUseProcedural { Other.mUseProcedural },
+    mUseReference { Other.mUseReference },
+    mVerifyKernels { Other.mVerifyKernels },
+    mVerifyEncoders { Other.mVerifyEncoders },
+    mVerifyReferences { Other.mVerifyReferences },
+    mImages { std::move(Other.mImages) } {
+}
+
+TextureCompressionBenchmark& TextureCompressionBenchmark::operator=(TextureCompressionBenchmark&& Other) noexcept {
+    if (this != &Other) {
+        mReferenceDirectory = std::move(Other.mReferenceDirectory);
+        mWorkingDirectory = std::move(Other.mWorkingDirectory);
+        mOutputPath = std::move(Other.mOutputPath);
+        mOutputFormat = Other.mOutputFormat;
+        mSizes = std::move(Other.mSizes);
+        mThreadCounts = std::move(Other.mThreadCounts);
+        mQualities = std::move(Other.mQualities);
+        mEncoders = std::move(Other.mEncoders);
+        mFormatFilters = std::move(Other.mFormatFilters);
+        mRepetitions = Other.mRepetitions;
+        mUseProcedural = Other.mUseProcedural;
+        mUseReference = Other.mUseReference;
+        mVerifyKernels = Other.mVerifyKernels;
+        mVerifyEncoders = Other.mVerifyEncoders;
+        mVerifyReferences = Other.mVerifyReferences;
+        mImages = std::move(Other.mImages);
+    }
+    return *this;
+}
+
+bool TextureCompressionBenchmark::ParseCommandLine(int ArgumentCount, char** Arguments) {
+    bool HasExplicitFormat { false };
+    for (int Index { 1 }; Index < ArgumentCount; ++Index) {
+        const std::string Argument { Arguments[Index] };
+        const bool HasValue { Index + 1 < ArgumentCount };
+        if ((Argument == "-o" || Argument == "--output") && HasValue) {
+            mOutputPath = Arguments[++Index];
+        }
+        else if (Argument == "--csv") {
+            mOutputFormat = BenchmarkOutputFormat::Csv;
+            HasExplicitFormat = true;
+        }
+        else if (Argument == "--json") {
+            mOutputFormat = BenchmarkOutputFormat::Json;
+            HasExplicitFormat = true;
+        }
+        else if ((Argument == "-r" || Argument == "--repetitions") && HasValue) {
+            if (!ParseUnsigned(Arguments[++Index], mRepetitions) || mRepetitions == 0) {
+                std::fprintf(stderr, "Invalid repetition count: %s\n", Arguments[Index]);
+                return false;
+            }
+        }
+        else if (Argument == "--sizes" && HasValue) {
+            mSizes.clear();
+            for (const std::string& Item : SplitList(Arguments[++Index])) {
+                uint32_t Size { 0 };
+                if (!ParseUnsigned(Item, Size) || Size < MinimumImageSize) {
+                    std::fprintf(stderr, "Invalid image size: %s\n", Item.c_str());
+                    return false;
+                }
+                mSizes.push_back(Size);
+            }
+        }
+        else if (Argument == "--threads" && HasValue) {
+            mThreadCounts.clear();
+            for (const std::string& Item : SplitList(Arguments[++Index])) {
+                uint32_t ThreadCount { 0 };
+                if (!ParseUnsigned(Item, ThreadCount) || ThreadCount == 0) {
+                    std::fprintf(stderr, "Invalid thread count: %s\n", Item.c_str());
+                    return false;
+                }
+                mThreadCounts.push_back(ThreadCount);
+            }
+        }
+        else if (Argument == "--qualities" && HasValue) {
+            mQualities.clear();
+            for (const std::string& Item : SplitList(Arguments[++Index])) {
+                CompressionQualityLevel Quality { CompressionQualityLevel::Normal };
+                if (!ParseQuality(Item, Quality)) {
+                    std::fprintf(stderr, "Invalid quality level: %s\n", Item.c_str());
+                    return false;
+                }
+                mQualities.push_back(Quality);
+            }
+        }
+        else if (Argument == "--encoders" && HasValue) {
+            mEncoders.clear();
+            for (const std::string& Item : SplitList(Arguments[++Index])) {
+                BlockEncoderBackend Encoder { BlockEncoderBackend::DirectXTex };
+                if (!ParseBlockEncoderBackend(ToLower(Item).c_str(), Encoder)) {
+                    std::fprintf(stderr, "Invalid encoder: %s\n", Item.c_str());
+                    return false;
+                }
+                mEncoders.push_back(Encoder);
+            }
+        }
+        else if (Argument == "--formats" && HasValue) {
+            for (const std::string& Item : SplitList(Arguments[++Index])) {
+                mFormatFilters.push_back(ToLower(Item));
+            }
+        }
+        else if (Argument == "--reference" && HasValue) {
+            mReferenceDirectory = Arguments[++Index];
+        }
+        else if (Argument == "--no-reference") {
+            mUseReference = false;
+        }
+        else if (Argument == "--no-procedural") {
+            mUseProcedural = false;
+        }
+        else if (Argument == "--verify-kernels") {
+            mVerifyKernels = true;
+        }
+        else if (Argument == "--verify-encoders") {
+            mVerifyEncoders = true;
+        }
+        else if (Argument == "--verify-references") {
+            mVerifyReferences = true;
+        }
+        else {
+            std::fprintf(stderr, "Unknown option: %s\n", Argument.c_str());
+            return false;
+        }
+    }
+    if (!HasExplicitFormat && ToLower(mOutputPath.extension().string()) == ".json") {
+        mOutputFormat = BenchmarkOutputFormat::Json;
+    }
+    if (mSizes.empty() || mThreadCounts.empty() || mQualities.empty() || mEncoders.empty() || (!mUseProcedural && !mUseReference)) {
+        return false;
+    }
+    return true;
+}
+
+int TextureCompressionBenchmark::Run() {
+    if (!PrepareImages()) {
+        return 1;
+    }
+    if (mVerifyKernels) {
+        return VerifyErrorMetricKernels();
+    }
+    if (mVerifyEncoders) {
+        return VerifyBlockEncoders();
+    }
+    if (mVerifyReferences) {
+        return VerifyReferenceImages();
+    }
+    std::vector<FormatOption> Formats {};
+    for (const FormatOption& Option : BuildCompressionCandidateFormats()) {
+        const std::string Name { ToLower(Option.Name) };
+        if (mFormatFilters.empty() || std::any_of(mFormatFilters.begin(), mFormatFilters.end(), [&Name](const std::string& Filter) { return Name.find(Filter) != std::string::npos; })) {
+            Formats.push_back(Option);
+        }
+    }
+    if (Formats.empty()) {
+        std::fprintf(stderr, "No formats match the filter\n");
+        return 2;
+    }
+
+    std::vector<BenchmarkCaseResult> Results {};
+    size_t FailedCount { 0 };
+    for (BenchmarkImage& Image : mImages) {
+        TextureDocument Document {};
+        if (!Document.LoadFromFile(Image.SourcePath)) {
+            std::fprintf(stderr, "FAILED to load %s\n", Image.SourcePath.string().c_str());
+            ++FailedCount;
+            continue;
+        }
+        Image.Width = Document.GetMetadata().width;
+        Image.Height = Document.GetMetadata().height;
+        for (const FormatOption& Format : Formats) {
+            for (const CompressionQualityLevel Quality : mQualities) {
+                for (const BlockEncoderBackend Encoder : mEncoders) {
+                    if (SelectBlockEncoder(Encoder, Format.Format).Backend != Encoder) {
+                        continue;
+                    }
+                    for (const uint32_t ThreadCount : mThreadCounts) {
+                        const BenchmarkCaseResult Result { RunCase(Image, Document, Format, Quality, Encoder, ThreadCount) };
+                        if (!Result.Succeeded) {
+                            ++FailedCount;
+                        }
+                        std::fprintf(stderr, "%-24s %5zux%-5zu %-22s %-6s %-10s %2u threads | %s | best %.2f ms | %.2f MPix/s | peak %.1f MB\n",
+                            Result.ImageName.c_str(), Result.Width, Result.Height, Result.FormatName.c_str(), GetQualityName(Result.Quality), GetBlockEncoderBackendName(Result.Encoder),
+                            Result.ThreadCount, Result.Succeeded ? (Result.IsPassThrough ? "copy" : "ok  ") : "FAIL", Result.BestMilliseconds, Result.MegapixelsPerSecond,
+                            static_cast<double>(Result.PeakMemoryBytes) / (1024.0 * 1024.0));
+                        Results.push_back(Result);
+                    }
+                }
+            }
+        }
+    }
+    if (!WriteResults(Results)) {
+        return 1;
+    }
+    return FailedCount == 0 ? 0 : 1;
+}
+
+void TextureCompressionBenchmark::PrintUsage() {
+    std::printf(
+        "Usage: TextureCompressionBenchmark [options]\n"
+        "  -o, --output <file>     result file (default: stdout); .json selects JSON output\n"
+        "      --csv | --json      force the output format\n"
+        "  -r, --repetitions <n>   encodes per case, best and median are reported (default: 3)\n"
+        "      --sizes <list>      procedural LDR and HDR image sizes (default: 256,512,1024)\n"
+        "      --threads <list>    compression thread counts (default: 1 and hardware threads)\n"
+        "      --qualities <list>  fast,normal,best (default: all)\n"
+        "      --encoders <list>   directxtex,native block encoder backends (default: directxtex)\n"
+        "      --formats <list>    case-insensitive substrings of format names (default: all candidate formats)\n"
+        "      --reference <dir>   checked-in reference images (default: Benchmark/Reference)\n"
+        "      --no-reference      skip reference images\n"
+        "      --no-procedural     skip procedurally generated images\n"
+        "      --verify-kernels    check every supported SIMD error metric kernel against the scalar reference\n"
+        "      --verify-encoders   check native block encoder PSNR against DirectXTex and that tiled output is identical\n"
+        "                          for 1 and the largest --threads count, for every supported format\n"
+        "      --verify-references load every reference image and check its dimensions and format\n");
+}
+
+bool TextureCompressionBenchmark::PrepareImages() {
+    mImages.clear();
+    if (mUseProcedural) {
+        std::error_code Error {};
+        std::filesystem::create_directories(mWorkingDirectory, Error);
+        if (Error) {
+            std::fprintf(stderr, "Cannot create working directory %s: %s\n", mWorkingDirectory.string().c_str(), Error.message().c_str());
+            return false;
+        }
+        for (const size_t Size : mSizes) {
+            BenchmarkImage Image {};
+            if (!GenerateProceduralImage(Size, Image)) {
+                std::fprintf(stderr, "Cannot generate %zux%zu procedural image\n", Size, Size);
+                return false;
+            }
+            mImages.push_back(std::move(Image));
+            if (!GenerateProceduralHdrImage(Size, Image)) {
+                std::fprintf(stderr, "Cannot generate %zux%zu procedural HDR image\n", Size, Size);
+                return false;
+            }
+            mImages.push_back(std::move(Image));
+        }
+    }
+    if (mUseReference) {
+        std::error_code Error {};
+        std::vector<std::filesystem::path> Found {};
+        for (std::filesystem::directory_iterator Iterator { mReferenceDirectory, Error }, End {}; !Error && Iterator != End; Iterator.increment(Error)) {
+            if (Iterator->is_regular_file(Error) && IsReferenceExtension(Iterator->path())) {
+                Found.push_back(Iterator->path());
+            }
+        }
+        if (Error) {
+            std::fprintf(stderr, "Cannot scan reference directory %s: %s\n", mReferenceDirectory.string().c_str(), Error.message().c_str());
+            return false;
+        }
+        std::sort(Found.begin(), Found.end());
+        for (const std::filesystem::path& SourcePath : Found) {
+            const std::string Name { SourcePath.stem().string() };
+            mImages.push_back(BenchmarkImage { Name, SourcePath, 0, 0, false, ToLower(Name).find("normal") != std::string::npos });
+        }
+    }
+    if (mImages.empty()) {
+        std::fprintf(stderr, "No benchmark images\n");
+        return false;
+    }
+    return true;
+}
+
+bool TextureCompressionBenchmark::GenerateProceduralImage(size_t Size, BenchmarkImage& ImageOut) const {
+    ScratchImage Generated {};
+    if (FAILED(Generated.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, Size, Size, 1, 1))) {
+        return false;
+    }
+    const Image* Target { Generated.GetImage(0, 0, 0) };
+    const size_t CellSize { std::max<size_t>(Size / 16, 1) };
+    for (size_t Y { 0 }; Y < Size; ++Y) {
+        uint8_t* Row { Target->pixels + Y * Target->rowPitch };
+        for (size_t X { 0 }; X < Size; ++X) {
+            const uint8_t Noise { HashNoise(X, Y, 1) };
+            const bool IsEdgeCell { ((X / CellSize) + (Y / CellSize)) % 2 == 0 && X > Size / 2 };
+            uint8_t* Pixel { Row + X * 4 };
+            Pixel[0] = IsEdgeCell ? 230 : static_cast<uint8_t>((X * 255) / Size);
+            Pixel[1] = IsEdgeCell ? 40 : static_cast<uint8_t>(((Y * 255) / Size + Noise / 8) & 0xFF);
+            Pixel[2] = static_cast<uint8_t>(((X + Y) * 127) / Size);
+            Pixel[3] = Y < Size / 4 ? static_cast<uint8_t>((X * 255) / Size) : 255;
+        }
+    }
+    char Name[64] {};
+    std::snprintf(Name, sizeof(Name), "procedural_%zu", Size);
+    const std::filesystem::path SourcePath { mWorkingDirectory / (std::string { Name } + ".dds") };
+    if (FAILED(SaveToDDSFile(Generated.GetImages(), Generated.GetImageCount(), Generated.GetMetadata(), DDS_FLAGS_NONE, SourcePath.wstring().c_str()))) {
+        return false;
+    }
+    ImageOut = BenchmarkImage { Name, SourcePath, Size, Size, true, false };
+    return true;
+}
+
+bool TextureCompressionBenchmark::GenerateProceduralHdrImage(size_t Size, BenchmarkImage& ImageOut) const {
+    ScratchImage Generated {};
+    if (FAILED(Generated.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, Size, Size, 1, 1))) {
+        return false;
+    }
+    const Image* Target { Generated.GetImage(0, 0, 0) };
+    for (size_t Y { 0 }; Y < Size; ++Y) {
+        float* Row { reinterpret_cast<float*>(Target->pixels + Y * Target->rowPitch) };
+        const float V { static_cast<float>(Y) / static_cast<float>(Size) };
+        for (size_t X { 0 }; X < Size; ++X) {
+            const float U { static_cast<float>(X) / static_cast<float>(Size) };
+            const float SunDistance { (U - 0.7f) * (U - 0.7f) + (V - 0.3f) * (V - 0.3f) };
+            const float Sun { 2000.0f * std::exp(-SunDistance * 400.0f) };
+            const float Cloud { V < 0.5f ? static_cast<float>(HashNoise(X / 4, Y / 4, 3)) / 255.0f * 0.5f : 0.0f };
+            const bool IsGround { V > 0.8f };
+            float* Pixel { Row + X * 4 };
+            Pixel[0] = (IsGround ? 0.05f : (0.2f + 0.8f * V) * (1.0f + Cloud)) + Sun;
+            Pixel[1] = (IsGround ? 0.04f : (0.4f + 0.6f * V) * (1.0f + Cloud)) + Sun * 0.95f;
+            Pixel[2] = (IsGround ? 0.03f : 1.0f + Cloud) + Sun * 0.8f;
+            Pixel[3] = 1.0f;
+        }
+    }
+    ScratchImage Converted {};
+    if (FAILED(Convert(*Target, DXGI_FORMAT_R16G16B16A16_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Converted))) {
+        return false;
+    }
+    char Name[64] {};
+    std::snprintf(Name, sizeof(Name), "procedural_hdr_%zu", Size);
+    const std::filesystem::path SourcePath { mWorkingDirectory / (std::string { Name } + ".dds") };
+    if (FAILED(SaveToDDSFile(Converted.GetImages(), Converted.GetImageCount(), Converted.GetMetadata(), DDS_FLAGS_NONE, SourcePath.wstring().c_str()))) {
+        return false;
+    }
+    ImageOut = BenchmarkImage { Name, SourcePath, Size, Size, true, false };
+    return true;
+}
+
+BenchmarkCaseResult TextureCompressionBenchmark::RunCase(const BenchmarkImage& Image, const TextureDocument& Document, const FormatOption& Format, CompressionQualityLevel Quality, BlockEncoderBackend Encoder, uint32_t ThreadCount) const {
+    const AnalyzerSettings Settings {
+        Format.Format, TEX_FILTER_FANT, false, false, Image.IsNormalMap, false, Quality, Encoder, ChannelViewMode::Rgba, 1.0f,
+        ThreadCount > 1 ? CompressionThreadingMode::Explicit : CompressionThreadingMode::Off, ThreadCount, false, false, false, 0.0f, false, DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim
+    };
+    BenchmarkCaseResult Result { Image.Name, Image.Width, Image.Height, Format.Name, Quality, Encoder, ResolveCompressionThreadCount(Settings), mRepetitions, true,
+        Document.GetMetadata().format == Format.Format, 0.0, 0.0, 0.0, 0, 0, false, 0 };
+    const TextureImageView Source { Document.GetSourceImage() };
+    const uint64_t Pixels { CountImagePixels(Source.Images, Source.ImageCount) };
+
+    std::vector<double> Samples {};
+    Samples.reserve(mRepetitions);
+    for (uint32_t Repetition { 0 }; Repetition < mRepetitions; ++Repetition) {
+        CompressionPreviewCache Cache {};
+        Cache.SetResultCacheBudget(0);
+        ResetPeakMemory();
+        const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+        if (!Cache.Rebuild(Document, Settings, CompressionJobHandle { Repetition + 1ull })) {
+            Result.Succeeded = false;
+            break;
+        }
+        const double WallMilliseconds { ElapsedMilliseconds(Start) };
+        const CompressionTimings& Timings { Cache.GetLastTimings() };
+        Samples.push_back(Result.IsPassThrough ? WallMilliseconds : Timings.CompressMilliseconds);
+        Result.CompressedBytes = Cache.GetCompressedImage().GetPixelsSize();
+        Result.PeakMemoryBytes = std::max(Result.PeakMemoryBytes, ReadPeakMemoryBytes());
+        if (Repetition + 1 == mRepetitions) {
+            Result.HasPackagedBytes = MeasureDeflatedSize(Cache.GetCompressedImage().GetPixels(), Result.CompressedBytes, Result.PackagedBytes);
+        }
+    }
+    if (!Result.Succeeded || Samples.empty()) {
+        return Result;
+    }
+    std::sort(Samples.begin(), Samples.end());
+    Result.BestMilliseconds = Samples.front();
+    Result.MedianMilliseconds = Samples[Samples.size() / 2];
+    Result.MegapixelsPerSecond = ComputeMegapixelsPerSecond(Pixels, Result.MedianMilliseconds);
+    return Result;
+}
+
+bool TextureCompressionBenchmark::WriteResults(const std::vector<BenchmarkCaseResult>& Results) const {
+    if (mOutputPath.empty()) {
+        if (mOutputFormat == BenchmarkOutputFormat::Json) {
+            WriteJson(std::cout, Results);
+        }
+        else {
+            WriteCsv(std::cout, Results);
+        }
+        return static_cast<bool>(std::cout);
+    }
+    std::ofstream Stream { mOutputPath, std::ios::trunc };
+    if (!Stream) {
+        std::fprintf(stderr, "Cannot open output file: %s\n", mOutputPath.string().c_str());
+        return false;
+    }
+    if (mOutputFormat == BenchmarkOutputFormat::Json) {
+        WriteJson(Stream, Results);
+    }
+    else {
+        WriteCsv(Stream, Results);
+    }
+    return static_cast<bool>(Stream);
+}
+
+void TextureCompressionBenchmark::WriteCsv(std::ostream& Stream, const std::vector<BenchmarkCaseResult>& Results) const {
+    Stream << "image,width,height,format,quality,encoder,threads,repetitions,status,best_ms,median_ms,mpix_per_s,compressed_bytes,packaged_bytes,peak_memory_bytes\n";
+    char Buffer[512] {};
+    for (const BenchmarkCaseResult& Result : Results) {
+        char PackagedBytes[32] {};
+        if (Result.HasPackagedBytes) {
+            std::snprintf(PackagedBytes, sizeof(PackagedBytes), "%zu", Result.PackagedBytes);
+        }
+        std::snprintf(Buffer, sizeof(Buffer), "%s,%zu,%zu,%s,%s,%s,%u,%u,%s,%.4f,%.4f,%.4f,%zu,%s,%llu\n",
+            Result.ImageName.c_str(), Result.Width, Result.Height, Result.FormatName.c_str(), GetQualityName(Result.Quality), GetBlockEncoderBackendName(Result.Encoder), Result.ThreadCount, Result.Repetitions,
+            Result.Succeeded ? (Result.IsPassThrough ? "copy" : "ok") : "failed", Result.BestMilliseconds, Result.MedianMilliseconds, Result.MegapixelsPerSecond,
+            Result.CompressedBytes, PackagedBytes, static_cast<unsigned long long>(Result.PeakMemoryBytes));
+        Stream << Buffer;
+    }
+}
+
+void TextureCompressionBenchmark::WriteJson(std::ostream& Stream, const std::vector<BenchmarkCaseResult>& Results) const {
+    Stream << "{\"tool\":\"TextureCompressionBenchmark\",\"version\":" << BenchmarkVersion << ",\"results\":[\n";
+    char Buffer[768] {};
+    for (size_t Index { 0 }; Index < Results.size(); ++Index) {
+        const BenchmarkCaseResult& Result { Results[Index] };
+        char PackagedBytes[32] { "null" };
+        if (Result.HasPackagedBytes) {
+            std::snprintf(PackagedBytes, sizeof(PackagedBytes), "%zu", Result.PackagedBytes);
+        }
+        std::snprintf(Buffer, sizeof(Buffer),
+            "{\"image\":\"%s\",\"width\":%zu,\"height\":%zu,\"format\":\"%s\",\"quality\":\"%s\",\"encoder\":\"%s\",\"threads\":%u,\"repetitions\":%u,\"status\":\"%s\","
+            "\"best_ms\":%.4f,\"median_ms\":%.4f,\"mpix_per_s\":%.4f,\"compressed_bytes\":%zu,\"packaged_bytes\":%s,\"peak_memory_bytes\":%llu}%s\n",
+            Result.ImageName.c_str(), Result.Width, Result.Height, Result.FormatName.c_str(), GetQualityName(Result.Quality), GetBlockEncoderBackendName(Result.Encoder), Result.ThreadCount,
+            Result.Repetitions, Result.Succeeded ? (Result.IsPassThrough ? "copy" : "ok") : "failed", Result.BestMilliseconds, Result.MedianMilliseconds, Result.MegapixelsPerSecond,
+            Result.CompressedBytes, PackagedBytes, static_cast<unsigned long long>(Result.PeakMemoryBytes), Index + 1 < Results.size() ? "," : "");
+        Stream << Buffer;
+    }
+    Stream << "]}\n";
+}
+
+int TextureCompressionBenchmark::VerifyErrorMetricKernels() const {
+    size_t FailedCount { 0 };
+    for (const BenchmarkImage& Image : mImages) {
+        TextureDocument Document {};
+        ScratchImage ReferenceFloat {};
+        ScratchImage CandidateFloat {};
+        if (!Document.LoadFromFile(Image.SourcePath) || !ConvertToVerificationFloat(Document.GetSourceImage().Images[0], ReferenceFloat) ||
+            FAILED(CandidateFloat.InitializeFromImage(*ReferenceFloat.GetImage(0, 0, 0)))) {
+            std::fprintf(stderr, "FAILED to load %s\n", Image.SourcePath.string().c_str());
+            ++FailedCount;
+            continue;
+        }
+        PerturbFloatImage(*CandidateFloat.GetImage(0, 0, 0));
+        for (const ErrorMetricPixelFormat Format : { ErrorMetricPixelFormat::Rgba8, ErrorMetricPixelFormat::Rgba16F, ErrorMetricPixelFormat::Rgba32F }) {
+            ScratchImage ReferenceStorage {};
+            ScratchImage CandidateStorage {};
+            ErrorMetricImage Reference {};
+            ErrorMetricImage Candidate {};
+            ErrorMetricResult Expected {};
+            if (!BuildVerificationImage(ReferenceFloat, Format, ReferenceStorage, Reference) || !BuildVerificationImage(CandidateFloat, Format, CandidateStorage, Candidate) ||
+                !ComputeErrorMetricsReference(Reference, Candidate, Expected)) {
+                std::fprintf(stderr, "FAILED to prepare %s %s\n", Image.Name.c_str(), GetMetricPixelFormatName(Format));
+                ++FailedCount;
+                continue;
+            }
+            for (const SimdInstructionSet InstructionSet : { SimdInstructionSet::Scalar, SimdInstructionSet::Sse41, SimdInstructionSet::Avx2, SimdInstructionSet::Avx512 }) {
+                if (!IsInstructionSetSupported(InstructionSet)) {
+                    continue;
+                }
+                ErrorMetricResult Result {};
+                double BestMilliseconds { 0.0 };
+                bool Succeeded { true };
+                for (uint32_t Repetition { 0 }; Repetition < mRepetitions && Succeeded; ++Repetition) {
+                    const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+                    Succeeded = ComputeErrorMetrics(Reference, Candidate, InstructionSet, Result);
+                    const double Milliseconds { ElapsedMilliseconds(Start) };
+                    BestMilliseconds = Repetition == 0 ? Milliseconds : std::min(BestMilliseconds, Milliseconds);
+                }
+                const bool Matches { Succeeded && MatchesReferenceMetrics(Result, Expected) };
+                if (!Matches) {
+                    ++FailedCount;
+                }
+                std::fprintf(stderr, "%-24s %5zux%-5zu %-8s %-7s | %s | best %.3f ms | %.1f MPix/s | PSNR %.2f / %.2f / %.2f / %.2f\n",
+                    Image.Name.c_str(), Reference.Width, Reference.Height, GetMetricPixelFormatName(Format), GetSimdInstructionSetName(InstructionSet),
+                    Matches ? "ok  " : "FAIL", BestMilliseconds, ComputeMegapixelsPerSecond(Result.PixelCount, BestMilliseconds),
+                    Result.Psnr[0], Result.Psnr[1], Result.Psnr[2], Result.Psnr[3]);
+            }
+        }
+    }
+    return FailedCount == 0 ? 0 : 1;
+}
+
+int TextureCompressionBenchmark::VerifyBlockEncoders() const {
+    size_t FailedCount { 0 };
+    for (const BenchmarkImage& Image : mImages) {
+        TextureDocument Document {};
+        if (!Document.LoadFromFile(Image.SourcePath)) {
+            std::fprintf(stderr, "FAILED to load %s\n", Image.SourcePath.string().c_str());
+            ++FailedCount;
+            continue;
+        }
+        const DirectX::Image& Source { Document.GetSourceImage().Images[0] };
+        for (const FormatOption& Format : BuildCompressionCandidateFormats()) {
+            const std::string Name { ToLower(Format.Name) };
+            if (SelectBlockEncoder(BlockEncoderBackend::Native, Format.Format).Backend != BlockEncoderBackend::Native || Document.GetMetadata().format == Format.Format) {
+                continue;
+            }
+            if (!mFormatFilters.empty() && std::none_of(mFormatFilters.begin(), mFormatFilters.end(), [&Name](const std::string& Filter) { return Name.find(Filter) != std::string::npos; })) {
+                continue;
+            }
+            for (const CompressionQualityLevel Quality : mQualities) {
+                MipQualityMetrics Metrics[2] {};
+                double Milliseconds[2] {};
+                bool Succeeded { true };
+                for (size_t Index { 0 }; Index < 2 && Succeeded; ++Index) {
+                    const BlockEncoderBackend Encoder { Index == 0 ? BlockEncoderBackend::DirectXTex : BlockEncoderBackend::Native };
+                    const AnalyzerSettings Settings {
+                        Format.Format, TEX_FILTER_FANT, false, false, Image.IsNormalMap, false, Quality, Encoder, ChannelViewMode::Rgba, 1.0f,
+                        CompressionThreadingMode::Off, 1, false, false, false, 0.0f, false, DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim
+                    };
+                    CompressionPreviewCache Cache {};
+                    Cache.SetResultCacheBudget(0);
+                    Succeeded = Cache.Rebuild(Document, Settings, CompressionJobHandle { Index + 1ull });
+                    const DirectX::Image* Compressed { Succeeded ? Cache.GetCompressedImage().GetImage(0, 0, 0) : nullptr };
+                    Succeeded = Compressed != nullptr && ComputeMipQualityMetrics(Source, *Compressed, Metrics[Index]);
+                    Milliseconds[Index] = Cache.GetLastTimings().CompressMilliseconds;
+                }
+                if (!Succeeded) {
+                    std::fprintf(stderr, "%-24s %-16s %-6s | FAIL | encode error\n", Image.Name.c_str(), Format.Name.c_str(), GetQualityName(Quality));
+                    ++FailedCount;
+                    continue;
+                }
+                for (const EncoderParityCheck& Check : BuildEncoderParityChecks(Format.Format)) {
+                    const double ReferencePsnr { ComputeParityPsnr(Metrics[0], Check) };
+                    const double NativePsnr { ComputeParityPsnr(Metrics[1], Check) };
+                    const bool Matches { NativePsnr >= ReferencePsnr - Check.ToleranceDb };
+                    if (!Matches) {
+                        ++FailedCount;
+                    }
+                    std::fprintf(stderr, "%-24s %-16s %-6s %-3s | %s | PSNR directxtex %.2f dB native %.2f dB | %.2f ms / %.2f ms\n",
+                        Image.Name.c_str(), Format.Name.c_str(), GetQualityName(Quality), Check.Name, Matches ? "ok  " : "FAIL", ReferencePsnr, NativePsnr, Milliseconds[0], Milliseconds[1]);
+                }
+                if (!VerifyThreadDeterminism(Image, Document, Format, Quality)) {
+                    ++FailedCount;
+                }
+            }
+        }
+    }
+    return FailedCount == 0 ? 0 : 1;
+}
+
+bool TextureCompressionBenchmark::VerifyThreadDeterminism(const BenchmarkImage& Image, const TextureDocument& Document, const FormatOption& Format, CompressionQualityLevel Quality) const {
+    const uint32_t ThreadCount { *std::max_element(mThreadCounts.begin(), mThreadCounts.end()) };
+    if (ThreadCount <= 1) {
+        return true;
+    }
+    bool AllMatch { true };
+    for (const BlockEncoderBackend Encoder : { BlockEncoderBackend::DirectXTex, BlockEncoderBackend::Native }) {
+        std::shared_ptr<const ScratchImage> Encoded[2] {};
+        for (size_t Index { 0 }; Index < 2; ++Index) {
+            const AnalyzerSettings Settings {
+                Format.Format, TEX_FILTER_FANT, false, false, Image.IsNormalMap, false, Quality, Encoder, ChannelViewMode::Rgba, 1.0f,
+                Index == 0 ? CompressionThreadingMode::Off : CompressionThreadingMode::Explicit, Index == 0 ? 1u : ThreadCount, true, false, false, 0.0f, false,
+                DefaultAutoFormatMinimumPsnr, DefaultAutoFormatMinimumSsim
+            };
+            CompressionPreviewCache Cache {};
+            Cache.SetResultCacheBudget(0);
+            if (Cache.Rebuild(Document, Settings, CompressionJobHandle { Index + 1ull })) {
+                Encoded[Index] = Cache.GetCompressedSnapshot();
+            }
+        }
+        const bool Matches { Encoded[0] != nullptr && Encoded[1] != nullptr && Encoded[0]->GetPixelsSize() == Encoded[1]->GetPixelsSize() &&
+            memcmp(Encoded[0]->GetPixels(), Encoded[1]->GetPixels(), Encoded[0]->GetPixelsSize()) == 0 };
+        AllMatch = AllMatch && Matches;
+        std::fprintf(stderr, "%-24s %-16s %-6s %-10s | %s | tiled output 1 thread vs %u threads %s\n",
+            Image.Name.c_str(), Format.Name.c_str(), GetQualityName(Quality), GetBlockEncoderBackendName(Encoder), Matches ? "ok  " : "FAIL", ThreadCount, Matches ? "identical" : "differs");
+    }
+    return AllMatch;
+}
+
+int TextureCompressionBenchmark::VerifyReferenceImages() const {
+    size_t FailedCount { 0 };
+    size_t VerifiedCount { 0 };
+    for (const BenchmarkImage& Image : mImages) {
+        if (Image.IsProcedural) {
+            continue;
+        }
+        const std::string FileName { Image.SourcePath.filename().string() };
+        const ReferenceImageExpectation* Expected { nullptr };
+        for (const ReferenceImageExpectation& Expectation : ReferenceImageExpectations) {
+            if (ToLower(FileName) == Expectation.FileName) {
+                Expected = &Expectation;
+            }
+        }
+        if (Expected == nullptr) {
+            std::fprintf(stderr, "%-24s | FAIL | no expected dimensions and format for this reference image\n", FileName.c_str());
+            ++FailedCount;
+            continue;
+        }
+        ++VerifiedCount;
+        TextureDocument Document {};
+        if (!Document.LoadFromFile(Image.SourcePath) || Document.GetSourceImage().Images == nullptr) {
+            std::fprintf(stderr, "%-24s | FAIL | cannot load\n", FileName.c_str());
+            ++FailedCount;
+            continue;
+        }
+        const TexMetadata& Metadata { Document.GetMetadata() };
+        const bool Matches { Metadata.width == Expected->Width && Metadata.height == Expected->Height && Metadata.format == Expected->Format &&
+            Metadata.depth == 1 && Metadata.arraySize == 1 && Metadata.mipLevels == 1 };
+        if (!Matches) {
+            ++FailedCount;
+        }
+        std::fprintf(stderr, "%-24s | %s | %zux%zu format %d, expected %zux%zu format %d\n", FileName.c_str(), Matches ? "ok  " : "FAIL",
+            Metadata.width, Metadata.height, static_cast<int>(Metadata.format), Expected->Width, Expected->Height, static_cast<int>(Expected->Format));
+    }
+    if (VerifiedCount != std::size(ReferenceImageExpectations)) {
+        std::fprintf(stderr, "Found %zu of %zu expected reference images in %s\n", VerifiedCount, std::size(ReferenceImageExpectations), mReferenceDirectory.string().c_str());
+        ++FailedCount;
+    }
+    return FailedCount == 0 ? 0 : 1;
+}
+
+int main(int ArgumentCount, char** Arguments) {
+    TextureCompressionBenchmark Benchmark {};
+    if (!Benchmark.ParseCommandLine(ArgumentCount, Arguments)) {
+        TextureCompressionBenchmark::PrintUsage();
+        return 2;
+    }
+    return Benchmark.Run();
+}
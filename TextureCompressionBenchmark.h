@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "TextureCompressionCore.h"
+
+enum class BenchmarkOutputFormat {
+    Csv,
+    Json
+};
+
+struct BenchmarkImage {
+    std::string Name;
+    std::filesystem::path SourcePath;
+    size_t Width;
+    size_t Height;
+    bool IsProcedural;
+    bool IsNormalMap;
+};
+
+struct BenchmarkCaseResult {
+    std::string ImageName;
+    size_t Width;
+    size_t Height;
+    std::string FormatName;
+    CompressionQualityLevel Quality;
+    BlockEncoderBackend Encoder;
+    uint32_t ThreadCount;
+    uint32_t Repetitions;
+    bool Succeeded;
+    bool IsPassThrough;
+    double BestMilliseconds;
+    double MedianMilliseconds;
+    double MegapixelsPerSecond;
+    size_t CompressedBytes;
+    size_t PackagedBytes;
+    bool HasPackagedBytes;
+    uint64_t PeakMemoryBytes;
+};
+
+class TextureCompressionBenchmark {
+public:
+    TextureCompressionBenchmark();
+    ~TextureCompressionBenchmark();
+    TextureCompressionBenchmark(const TextureCompressionBenchmark& Other);
+    TextureCompressionBenchmark& operator=(const TextureCompressionBenchmark& Other);
+    TextureCompressionBenchmark(TextureCompressionBenchmark&& Other) noexcept;
+    TextureCompressionBenchmark& operator=(TextureCompressionBenchmark&& Other) noexcept;
+
+public:
+    bool ParseCommandLine(int ArgumentCount, char** Arguments);
+    int Run();
+    static void PrintUsage();
+
+private:
+    bool PrepareImages();
+    bool GenerateProceduralImage(size_t Size, BenchmarkImage& ImageOut) const;
+    bool GenerateProceduralHdrImage(size_t Size, BenchmarkImage& ImageOut) const;
+    BenchmarkCaseResult RunCase(const BenchmarkImage& Image, const TextureDocument& Document, const FormatOption& Format, CompressionQualityLevel Quality, BlockEncoderBackend Encoder, uint32_t ThreadCount) const;
+    bool WriteResults(const std::vector<BenchmarkCaseResult>& Results) const;
+    void WriteCsv(std::ostream& Stream, const std::vector<BenchmarkCaseResult>& Results) const;
+    void WriteJson(std::ostream& Stream, const std::vector<BenchmarkCaseResult>& Results) const;
+    int VerifyErrorMetricKernels() const;
+    int VerifyBlockEncoders() const;
+    int VerifyReferenceImages() const;
+    bool VerifyThreadDeterminism(const BenchmarkImage& Image, const TextureDocument& Document, const FormatOption& Format, CompressionQualityLevel Quality) const;
+
+private:
+    std::filesystem::path mReferenceDirectory;
+    std::filesystem::path mWorkingDirectory;
+    std::filesystem::path mOutputPath;
+    BenchmarkOutputFormat mOutputFormat;
+    std::vector<size_t> mSizes;
+    std::vector<uint32_t> mThreadCounts;
+    std::vector<CompressionQualityLevel> mQualities;
+    std::vector<BlockEncoderBackend> mEncoders;
+    std::vector<std::string> mFormatFilters;
+    uint32_t mRepetitions;
+    bool mUseProcedural;
+    bool mUseReference;
+    bool mVerifyKernels;
+    bool mVerifyEncoders;
+    bool mVerifyReferences;
+    std::vector<BenchmarkImage> mImages;
+};
@@ -0,0 +1,1750 @@
+#include "TextureCompressionCore.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(TEXTURE_COMPRESSION_HAS_ZLIB)
+#include <zlib.h>
+#elif defined(_WIN32)
+#include <compressapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Cabinet.lib")
+#endif
+#endif
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint64_t HashOffsetBasis { 14695981039346656037ull };
+    constexpr uint64_t HashPrime { 1099511628211ull };
+    constexpr size_t DefaultResultCacheBudget { 512ull * 1024ull * 1024ull };
+    constexpr size_t DefaultDiskCacheBudget { 2048ull * 1024ull * 1024ull };
+    constexpr size_t DefaultPageBudget { 256ull * 1024ull * 1024ull };
+    constexpr uintmax_t LazyOpenThresholdBytes { 256ull * 1024ull * 1024ull };
+    constexpr size_t DdsHeaderOffset { 4 + 124 };
+    constexpr size_t DdsFourCcOffset { 4 + 80 };
+    constexpr size_t DdsDx10HeaderSize { 20 };
+    constexpr size_t DeflateChunkBytes { 64ull * 1024ull };
+    constexpr std::chrono::minutes StaleTemporaryAge { 10 };
+    constexpr uint32_t DiskCacheFormatVersion { 1 };
+
+    std::atomic<uint64_t> NextDocumentIdentity { 1 };
+    std::atomic<uint64_t> NextDiskCacheTemporaryIndex { 1 };
+
+    uint64_t HashBytes(uint64_t Seed, const void* Data, size_t Size) {
+        const uint8_t* Bytes { static_cast<const uint8_t*>(Data) };
+        uint64_t Hash { Seed };
+        for (size_t Index { 0 }; Index < Size; ++Index) {
+            Hash ^= Bytes[Index];
+            Hash *= HashPrime;
+        }
+        return Hash;
+    }
+
+    template <typename T>
+    uint64_t HashValue(uint64_t Seed, const T& Value) {
+        return HashBytes(Seed, &Value, sizeof(T));
+    }
+
+    double ElapsedMilliseconds(std::chrono::steady_clock::time_point Start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    void ApplyCompressionThreadCount(const AnalyzerSettings& Settings) {
+#ifdef _OPENMP
+        if (Settings.Threading != CompressionThreadingMode::Off) {
+            omp_set_num_threads(static_cast<int>(ResolveCompressionThreadCount(Settings)));
+        }
+#else
+        (void)Settings;
+#endif
+    }
+
+    const ScratchImage& GetEmptyScratchImage() {
+        static const ScratchImage EmptyImage {};
+        return EmptyImage;
+    }
+
+    TextureImageView MakeImageView(const ScratchImage& Source) {
+        return TextureImageView { Source.GetImages(), Source.GetImageCount(), Source.GetMetadata() };
+    }
+
+    bool CopyImageView(const TextureImageView& Source, ScratchImage& Destination) {
+        Destination.Release();
+        if (Source.Images == nullptr || Source.ImageCount == 0) {
+            return false;
+        }
+        const HRESULT InitHr { Destination.Initialize(Source.Metadata) };
+        if (FAILED(InitHr) || Destination.GetImageCount() != Source.ImageCount) {
+            Destination.Release();
+            return false;
+        }
+        const Image* DestinationImages { Destination.GetImages() };
+        for (size_t Index { 0 }; Index < Source.ImageCount; ++Index) {
+            if (DestinationImages[Index].slicePitch != Source.Images[Index].slicePitch) {
+                Destination.Release();
+                return false;
+            }
+            memcpy(DestinationImages[Index].pixels, Source.Images[Index].pixels, Source.Images[Index].slicePitch);
+        }
+        return true;
+    }
+
+    MipStageKey BuildMipStageKey(const TextureDocument& Document, const AnalyzerSettings& Settings) {
+        return MipStageKey { Document.GetIdentity(), Settings.MipFilter, Settings.GenerateMipmaps, Settings.IsSrgb };
+    }
+
+    CompressStageKey BuildRegionStageKey(uint64_t SourceIdentity, const AnalyzerSettings& Settings, DXGI_FORMAT TargetFormat, BlockEncoderBackend EncoderBackend, float RdoLambda) {
+        return CompressStageKey { MipStageKey { SourceIdentity, TEX_FILTER_DEFAULT, false, Settings.IsSrgb }, TargetFormat, BuildCompressFlags(Settings) & ~TEX_COMPRESS_PARALLEL, Settings.AlphaWeight, EncoderBackend, RdoLambda };
+    }
+
+    size_t CountFullMipChain(size_t Width, size_t Height) {
+        size_t Levels { 1 };
+        while (Width > 1 || Height > 1) {
+            Width = std::max<size_t>(1, Width >> 1);
+            Height = std::max<size_t>(1, Height >> 1);
+            ++Levels;
+        }
+        return Levels;
+    }
+
+    TexMetadata BuildExpectedResultMetadata(const TexMetadata& SourceMetadata, const AnalyzerSettings& Settings) {
+        TexMetadata Expected { SourceMetadata };
+        Expected.format = ResolveSrgbVariant(Settings.Format, Settings.IsSrgb);
+        if (Settings.GenerateMipmaps) {
+            Expected.mipLevels = CountFullMipChain(SourceMetadata.width, SourceMetadata.height);
+        }
+        return Expected;
+    }
+
+    uint64_t ComputeDiskCacheKey(uint64_t ContentHash, const AnalyzerSettings& Settings) {
+        return HashValue(ComputePreviewCacheKey(ContentHash, Settings), DiskCacheFormatVersion);
+    }
+
+    bool HasSameLayout(const TexMetadata& Left, const TexMetadata& Right) {
+        return Left.format == Right.format && Left.width == Right.width && Left.height == Right.height && Left.depth == Right.depth && Left.mipLevels == Right.mipLevels &&
+            Left.arraySize == Right.arraySize && Left.dimension == Right.dimension;
+    }
+
+    uintmax_t GetFileSizeOrZero(const std::filesystem::path& FilePath) {
+        std::error_code Error {};
+        const uintmax_t Bytes { std::filesystem::file_size(FilePath, Error) };
+        return Error ? 0 : Bytes;
+    }
+
+    bool HasSameBaseImage(const TextureImageView& Left, const TextureImageView& Right) {
+        if (Left.Images == nullptr || Right.Images == nullptr || Left.ImageCount == 0 || Right.ImageCount == 0) {
+            return false;
+        }
+        const Image& LeftBase { Left.Images[0] };
+        const Image& RightBase { Right.Images[0] };
+        if (LeftBase.pixels == RightBase.pixels) {
+            return true;
+        }
+        return LeftBase.format == RightBase.format && LeftBase.width == RightBase.width && LeftBase.height == RightBase.height && LeftBase.slicePitch == RightBase.slicePitch &&
+            memcmp(LeftBase.pixels, RightBase.pixels, LeftBase.slicePitch) == 0;
+    }
+
+    PreviewResultKey MakeIndexOnlyKey(uint64_t Key) {
+        PreviewResultKey Result {};
+        Result.Hash = Key;
+        return Result;
+    }
+}
+
+
+TextureDocument::TextureDocument() :
+    mSourceImage {},
+    mMappedFile {},
+    mMappedImages {},
+    mPager {},
+    mMetadata {},
+    mFileMetadata {},
+    mPath {},
+    mIdentity { 0 },
+    mSelectedMip { 0 },
+    mSelectedItem { 0 },
+    mIsLazy { false } {
+}
+
+TextureDocument::~TextureDocument() {
+}
+
+TextureDocument::TextureDocument(const TextureDocument& Other) :
+    mSourceImage {},
+    mMappedFile {},
+    mMappedImages {},
+    mPager { Other.mPager },
+    mMetadata { Other.mMetadata },
+    mFileMetadata { Other.mFileMetadata },
+    mPath { Other.mPath },
+    mIdentity { Other.mIdentity },
+    mSelectedMip { Other.mSelectedMip },
+    mSelectedItem { Other.mSelectedItem },
+    mIsLazy { Other.mIsLazy } {
+    if (!CopyImagesFrom(Other)) {
+        mIdentity = 0;
+    }
+}
+
+TextureDocument& TextureDocument::operator=(const TextureDocument& Other) {
+    if (this != &Other) {
+        mPager = Other.mPager;
+        mPath = Other.mPath;
+        mIdentity = Other.mIdentity;
+        mSelectedMip = Other.mSelectedMip;
+        mSelectedItem = Other.mSelectedItem;
+        mIsLazy = Other.mIsLazy;
+        if (!CopyImagesFrom(Other)) {
+            mIdentity = 0;
+        }
+    }
+    return *this;
+}
+
+TextureDocument::TextureDocument(TextureDocument&& Other) noexcept :
+    mSourceImage { std::move(Other.mSourceImage) },
+    mMappedFile { std::move(Other.mMappedFile) },
+    mMappedImages { std::move(Other.mMappedImages) },
+    mPager { std::move(Other.mPager) },
+    mMetadata { Other.mMetadata },
+    mFileMetadata { Other.mFileMetadata },
+    mPath { std::move(Other.mPath) },
+    mIdentity { Other.mIdentity },
+    mSelectedMip { Other.mSelectedMip },
+    mSelectedItem { Other.mSelectedItem },
+    mIsLazy { Other.mIsLazy } {
+    Other.mMappedImages.clear();
+    Other.mIdentity = 0;
+    Other.mIsLazy = false;
+}
+
+TextureDocument& TextureDocument::operator=(TextureDocument&& Other) noexcept {
+    if (this != &Other) {
+        mSourceImage = std::move(Other.mSourceImage);
+        mMappedFile = std::move(Other.mMappedFile);
+        mMappedImages = std::move(Other.mMappedImages);
+        mPager = std::move(Other.mPager);
+        mMetadata = Other.mMetadata;
+        mFileMetadata = Other.mFileMetadata;
+        mPath = std::move(Other.mPath);
+        mIdentity = Other.mIdentity;
+        mSelectedMip = Other.mSelectedMip;
+        mSelectedItem = Other.mSelectedItem;
+        mIsLazy = Other.mIsLazy;
+        Other.mMappedImages.clear();
+        Other.mIdentity = 0;
+        Other.mIsLazy = false;
+    }
+    return *this;
+}
+
+bool TextureDocument::LoadFromFile(const std::filesystem::path& FilePath) {
+    ScopedStageTimer Timer { PipelineStage::Load };
+    mPath = FilePath;
+    mSourceImage.Release();
+    mMappedImages.clear();
+    mMappedFile.reset();
+    mPager.reset();
+    mMetadata = {};
+    mFileMetadata = {};
+    mIdentity = 0;
+    mSelectedMip = 0;
+    mSelectedItem = 0;
+    mIsLazy = false;
+    const std::wstring WidePath { FilePath.wstring() };
+    HRESULT Hr { E_FAIL };
+    switch (DetectTextureFileKind(FilePath)) {
+    case TextureFileKind::Dds:
+        Hr = LoadMappedDds(FilePath) ? S_OK : LoadFromDDSFile(WidePath.c_str(), DDS_FLAGS_NONE, &mMetadata, mSourceImage);
+        break;
+    case TextureFileKind::Tga:
+        Hr = LoadFromTGAFile(WidePath.c_str(), TGA_FLAGS_NONE, &mMetadata, mSourceImage);
+        break;
+    case TextureFileKind::Hdr:
+        Hr = LoadFromHDRFile(WidePath.c_str(), &mMetadata, mSourceImage);
+        break;
+    case TextureFileKind::Wic:
+#ifdef _WIN32
+        Hr = LoadFromWICFile(WidePath.c_str(), WIC_FLAGS_FORCE_RGB, &mMetadata, mSourceImage);
+#endif
+        break;
+    default:
+        break;
+    }
+    if (FAILED(Hr) || mMetadata.dimension == TEX_DIMENSION_TEXTURE3D) {
+        mSourceImage.Release();
+        mMappedImages.clear();
+        mMappedFile.reset();
+        mMetadata = {};
+        return false;
+    }
+    mFileMetadata = mMetadata;
+    mIdentity = NextDocumentIdentity.fetch_add(1);
+    const TextureImageView Source { GetSourceImage() };
+    Timer.MarkCompleted(CountImagePixels(Source.Images, Source.ImageCount), CountImageBytes(Source.Images, Source.ImageCount));
+    return true;
+}
+
+bool TextureDocument::OpenLazy(const std::filesystem::path& FilePath) {
+    mPath = FilePath;
+    mSourceImage.Release();
+    mMappedImages.clear();
+    mMappedFile.reset();
+    mPager.reset();
+    mMetadata = {};
+    mFileMetadata = {};
+    mIdentity = 0;
+    mIsLazy = false;
+    TexMetadata FileMetadata {};
+    const HRESULT MetadataHr { GetMetadataFromDDSFile(FilePath.wstring().c_str(), DDS_FLAGS_NONE, FileMetadata) };
+    if (FAILED(MetadataHr) || FileMetadata.dimension == TEX_DIMENSION_TEXTURE3D) {
+        return false;
+    }
+    if (!LoadMappedDds(FilePath) || mMappedImages.empty()) {
+        mSourceImage.Release();
+        mMappedImages.clear();
+        mMappedFile.reset();
+        mMetadata = {};
+        mFileMetadata = {};
+        return false;
+    }
+    mPager = std::make_shared<SubresourcePager>();
+    mIsLazy = true;
+    return SelectSubresource(0, 0);
+}
+
+bool TextureDocument::SelectSubresource(size_t Mip, size_t Item) {
+    if (!mIsLazy || Mip >= mFileMetadata.mipLevels || Item >= mFileMetadata.arraySize) {
+        return false;
+    }
+    mSelectedMip = Mip;
+    mSelectedItem = Item;
+    mMetadata = mFileMetadata;
+    mMetadata.width = std::max<size_t>(1, mFileMetadata.width >> Mip);
+    mMetadata.height = std::max<size_t>(1, mFileMetadata.height >> Mip);
+    mMetadata.depth = 1;
+    mMetadata.arraySize = 1;
+    mMetadata.mipLevels = 1;
+    mMetadata.miscFlags &= ~static_cast<uint32_t>(TEX_MISC_TEXTURECUBE);
+    mMetadata.dimension = TEX_DIMENSION_TEXTURE2D;
+    mIdentity = NextDocumentIdentity.fetch_add(1);
+    return true;
+}
+
+std::shared_ptr<const ScratchImage> TextureDocument::AcquireSubresource(size_t Mip, size_t Item, size_t Slice) const {
+    if (mPager == nullptr || Mip >= mFileMetadata.mipLevels || Item >= mFileMetadata.arraySize || Slice >= mFileMetadata.depth) {
+        return nullptr;
+    }
+    const size_t PageIndex { mFileMetadata.ComputeIndex(Mip, Item, Slice) };
+    if (PageIndex >= mMappedImages.size() || mMappedFile == nullptr || !mMappedFile->IsIntact()) {
+        return nullptr;
+    }
+    return mPager->Acquire(PageIndex, mMappedImages[PageIndex]);
+}
+
+bool TextureDocument::LoadMappedDds(const std::filesystem::path& FilePath) {
+    mSourceImage.Release();
+    mMappedImages.clear();
+    mMappedFile = std::make_shared<MappedFile>();
+    if (!mMappedFile->Open(FilePath)) {
+        mMappedFile.reset();
+        return false;
+    }
+    const uint8_t* Data { mMappedFile->GetData() };
+    const size_t Size { mMappedFile->GetSize() };
+    TexMetadata Metadata {};
+    if (Size < DdsHeaderOffset || FAILED(GetMetadataFromDDSMemory(Data, Size, DDS_FLAGS_NONE, Metadata)) || Metadata.dimension == TEX_DIMENSION_TEXTURE3D) {
+        mMappedFile.reset();
+        return false;
+    }
+
+    const bool HasDx10Header { memcmp(Data + DdsFourCcOffset, "DX10", 4) == 0 };
+    if (!HasDx10Header && !IsCompressed(Metadata.format)) {
+        const HRESULT CopyHr { LoadFromDDSMemory(Data, Size, DDS_FLAGS_NONE, &mMetadata, mSourceImage) };
+        mMappedFile.reset();
+        mFileMetadata = mMetadata;
+        return SUCCEEDED(CopyHr);
+    }
+
+    size_t Offset { HasDx10Header ? DdsHeaderOffset + DdsDx10HeaderSize : DdsHeaderOffset };
+    for (size_t Item { 0 }; Item < Metadata.arraySize; ++Item) {
+        for (size_t Mip { 0 }; Mip < Metadata.mipLevels; ++Mip) {
+            const size_t Width { std::max<size_t>(1, Metadata.width >> Mip) };
+            const size_t Height { std::max<size_t>(1, Metadata.height >> Mip) };
+            size_t RowPitch { 0 };
+            size_t SlicePitch { 0 };
+            if (FAILED(ComputePitch(Metadata.format, Width, Height, RowPitch, SlicePitch)) || Offset + SlicePitch > Size) {
+                mMappedImages.clear();
+                mMappedFile.reset();
+                return false;
+            }
+            mMappedImages.push_back(Image { Width, Height, Metadata.format, RowPitch, SlicePitch, const_cast<uint8_t*>(Data + Offset) });
+            Offset += SlicePitch;
+        }
+    }
+    mMetadata = Metadata;
+    mFileMetadata = Metadata;
+    return true;
+}
+
+bool TextureDocument::CopyImagesFrom(const TextureDocument& Other) {
+    mSourceImage.Release();
+    mMappedImages.clear();
+    mMappedFile.reset();
+    mMetadata = Other.mMetadata;
+    mFileMetadata = Other.mFileMetadata;
+    if (!Other.IsMemoryMapped()) {
+        return CopyImageView(Other.GetSourceImage(), mSourceImage);
+    }
+    if (Other.mMappedFile == nullptr || !Other.mMappedFile->IsIntact()) {
+        return false;
+    }
+    mMappedFile = Other.mMappedFile;
+    mMappedImages = Other.mMappedImages;
+    return true;
+}
+
+TextureImageView TextureDocument::GetSourceImage() const {
+    if (mIsLazy) {
+        const size_t ImageIndex { mFileMetadata.ComputeIndex(mSelectedMip, mSelectedItem, 0) };
+        if (ImageIndex >= mMappedImages.size()) {
+            return TextureImageView { nullptr, 0, mMetadata };
+        }
+        return TextureImageView { &mMappedImages[ImageIndex], 1, mMetadata };
+    }
+    if (!mMappedImages.empty()) {
+        return TextureImageView { mMappedImages.data(), mMappedImages.size(), mMetadata };
+    }
+    return MakeImageView(mSourceImage);
+}
+
+bool TextureDocument::IsMemoryMapped() const {
+    return !mMappedImages.empty();
+}
+
+bool TextureDocument::IsLazy() const {
+    return mIsLazy;
+}
+
+size_t TextureDocument::GetSelectedMip() const {
+    return mSelectedMip;
+}
+
+size_t TextureDocument::GetSelectedItem() const {
+    return mSelectedItem;
+}
+
+ResultCacheStatistics TextureDocument::GetPageStatistics() const {
+    if (mPager == nullptr) {
+        return ResultCacheStatistics { 0, 0, 0, 0, 0, 0 };
+    }
+    return mPager->GetStatistics();
+}
+
+const TexMetadata& TextureDocument::GetMetadata() const {
+    return mMetadata;
+}
+
+const TexMetadata& TextureDocument::GetFileMetadata() const {
+    return mFileMetadata;
+}
+
+const std::filesystem::path& TextureDocument::GetPath() const {
+    return mPath;
+}
+
+uint64_t TextureDocument::GetIdentity() const {
+    return mIdentity;
+}
+
+CompressionJobHandle::CompressionJobHandle() :
+    mCancelFlag {},
+    mJobId { 0 } {
+}
+
+CompressionJobHandle::CompressionJobHandle(uint64_t JobId) :
+    mCancelFlag { std::make_shared<std::atomic<bool>>(false) },
+    mJobId { JobId } {
+}
+
+CompressionJobHandle::~CompressionJobHandle() {
+}
+
+CompressionJobHandle::CompressionJobHandle(const CompressionJobHandle& Other) :
+    mCancelFlag { Other.mCancelFlag },
+    mJobId { Other.mJobId } {
+}
+
+CompressionJobHandle& CompressionJobHandle::operator=(const CompressionJobHandle& Other) {
+    if (this != &Other) {
+        mCancelFlag = Other.mCancelFlag;
+        mJobId = Other.mJobId;
+    }
+    return *this;
+}
+
+CompressionJobHandle::CompressionJobHandle(CompressionJobHandle&& Other) noexcept :
+    mCancelFlag { std::move(Other.mCancelFlag) },
+    mJobId { Other.mJobId } {
+    Other.mJobId = 0;
+}
+
+CompressionJobHandle& CompressionJobHandle::operator=(CompressionJobHandle&& Other) noexcept {
+    if (this != &Other) {
+        mCancelFlag = std::move(Other.mCancelFlag);
+        mJobId = Other.mJobId;
+        Other.mJobId = 0;
+    }
+    return *this;
+}
+
+void CompressionJobHandle::Cancel() const {
+    if (mCancelFlag != nullptr) {
+        mCancelFlag->store(true, std::memory_order_release);
+    }
+}
+
+bool CompressionJobHandle::IsCancelled() const {
+    return mCancelFlag != nullptr && mCancelFlag->load(std::memory_order_acquire);
+}
+
+bool CompressionJobHandle::IsValid() const {
+    return mCancelFlag != nullptr;
+}
+
+uint64_t CompressionJobHandle::GetJobId() const {
+    return mJobId;
+}
+
+CompressedResultCache::CompressedResultCache() :
+    mEntries {},
+    mIndex {},
+    mBudgetBytes { DefaultResultCacheBudget },
+    mResidentBytes { 0 },
+    mHits { 0 },
+    mMisses { 0 },
+    mEvictions { 0 } {
+}
+
+CompressedResultCache::~CompressedResultCache() {
+}
+
+CompressedResultCache::CompressedResultCache(const CompressedResultCache& Other) :
+    mEntries { Other.mEntries },
+    mIndex {},
+    mBudgetBytes { Other.mBudgetBytes },
+    mResidentBytes { Other.mResidentBytes },
+    mHits { Other.mHits },
+    mMisses { Other.mMisses },
+    mEvictions { Other.mEvictions } {
+    RebuildIndex();
+}
+
+CompressedResultCache& CompressedResultCache::operator=(const CompressedResultCache& Other) {
+    if (this != &Other) {
+        mEntries = Other.mEntries;
+        mBudgetBytes = Other.mBudgetBytes;
+        mResidentBytes = Other.mResidentBytes;
+        mHits = Other.mHits;
+        mMisses = Other.mMisses;
+        mEvictions = Other.mEvictions;
+        RebuildIndex();
+    }
+    return *this;
+}
+
+CompressedResultCache::CompressedResultCache(CompressedResultCache&& Other) noexcept :
+    mEntries { std::move(Other.mEntries) },
+    mIndex { std::move(Other.mIndex) },
+    mBudgetBytes { Other.mBudgetBytes },
+    mResidentBytes { Other.mResidentBytes },
+    mHits { Other.mHits },
+    mMisses { Other.mMisses },
+    mEvictions { Other.mEvictions } {
+    Other.mEntries.clear();
+    Other.mIndex.clear();
+    Other.mResidentBytes = 0;
+}
+
+CompressedResultCache& CompressedResultCache::operator=(CompressedResultCache&& Other) noexcept {
+    if (this != &Other) {
+        mEntries = std::move(Other.mEntries);
+        mIndex = std::move(Other.mIndex);
+        mBudgetBytes = Other.mBudgetBytes;
+        mResidentBytes = Other.mResidentBytes;
+        mHits = Other.mHits;
+        mMisses = Other.mMisses;
+        mEvictions = Other.mEvictions;
+        Other.mEntries.clear();
+        Other.mIndex.clear();
+        Other.mResidentBytes = 0;
+    }
+    return *this;
+}
+
+bool CompressedResultCache::TryGet(uint64_t Key, std::shared_ptr<const ScratchImage>& ImageOut) {
+    return TryGet(MakeIndexOnlyKey(Key), ImageOut);
+}
+
+bool CompressedResultCache::TryGet(const PreviewResultKey& Key, std::shared_ptr<const ScratchImage>& ImageOut) {
+    const auto Found { mIndex.find(Key.Hash) };
+    if (Found == mIndex.end() || !(Found->second->Identity == Key)) {
+        ++mMisses;
+        return false;
+    }
+    mEntries.splice(mEntries.begin(), mEntries, Found->second);
+    ImageOut = Found->second->Image;
+    ++mHits;
+    return true;
+}
+
+bool CompressedResultCache::Contains(uint64_t Key) const {
+    return Contains(MakeIndexOnlyKey(Key));
+}
+
+bool CompressedResultCache::Contains(const PreviewResultKey& Key) const {
+    const auto Found { mIndex.find(Key.Hash) };
+    return Found != mIndex.end() && Found->second->Identity == Key;
+}
+
+void CompressedResultCache::Insert(uint64_t Key, std::shared_ptr<const ScratchImage> Image) {
+    Insert(MakeIndexOnlyKey(Key), std::move(Image));
+}
+
+void CompressedResultCache::Insert(const PreviewResultKey& Key, std::shared_ptr<const ScratchImage> Image) {
+    if (Image == nullptr) {
+        return;
+    }
+    const size_t Bytes { Image->GetPixelsSize() };
+    if (Bytes > mBudgetBytes) {
+        return;
+    }
+    const auto Found { mIndex.find(Key.Hash) };
+    if (Found != mIndex.end()) {
+        mResidentBytes -= Found->second->Bytes;
+        mEntries.erase(Found->second);
+        mIndex.erase(Found);
+    }
+    mEntries.push_front(Entry { Key.Hash, Key, std::move(Image), Bytes });
+    mIndex[Key.Hash] = mEntries.begin();
+    mResidentBytes += Bytes;
+    EvictToBudget();
+}
+
+void CompressedResultCache::SetBudget(size_t BudgetBytes) {
+    mBudgetBytes = BudgetBytes;
+    EvictToBudget();
+}
+
+void CompressedResultCache::Clear() {
+    mEntries.clear();
+    mIndex.clear();
+    mResidentBytes = 0;
+}
+
+ResultCacheStatistics CompressedResultCache::GetStatistics() const {
+    return ResultCacheStatistics { mHits, mMisses, mEvictions, mEntries.size(), mResidentBytes, mBudgetBytes };
+}
+
+void CompressedResultCache::RebuildIndex() {
+    mIndex.clear();
+    for (auto Iterator { mEntries.begin() }; Iterator != mEntries.end(); ++Iterator) {
+        mIndex[Iterator->Key] = Iterator;
+    }
+}
+
+void CompressedResultCache::EvictToBudget() {
+    while (mResidentBytes > mBudgetBytes && !mEntries.empty()) {
+        const Entry& Oldest { mEntries.back() };
+        mResidentBytes -= Oldest.Bytes;
+        mIndex.erase(Oldest.Key);
+        mEntries.pop_back();
+        ++mEvictions;
+    }
+}
+
+SubresourcePager::SubresourcePager() :
+    mMutex {},
+    mPages {} {
+    mPages.SetBudget(DefaultPageBudget);
+}
+
+SubresourcePager::~SubresourcePager() {
+}
+
+SubresourcePager::SubresourcePager(const SubresourcePager& Other) :
+    mMutex {},
+    mPages {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mPages = Other.mPages;
+}
+
+SubresourcePager& SubresourcePager::operator=(const SubresourcePager& Other) {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mPages = Other.mPages;
+    }
+    return *this;
+}
+
+SubresourcePager::SubresourcePager(SubresourcePager&& Other) noexcept :
+    mMutex {},
+    mPages {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mPages = std::move(Other.mPages);
+}
+
+SubresourcePager& SubresourcePager::operator=(SubresourcePager&& Other) noexcept {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mPages = std::move(Other.mPages);
+    }
+    return *this;
+}
+
+std::shared_ptr<const ScratchImage> SubresourcePager::Acquire(uint64_t PageIndex, const Image& Source) {
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        std::shared_ptr<const ScratchImage> Cached {};
+        if (mPages.TryGet(PageIndex, Cached)) {
+            return Cached;
+        }
+    }
+
+    std::shared_ptr<ScratchImage> Page { std::make_shared<ScratchImage>() };
+    const HRESULT PageHr { IsCompressed(Source.format) ? Decompress(Source, DXGI_FORMAT_UNKNOWN, *Page) : Page->InitializeFromImage(Source) };
+    if (FAILED(PageHr)) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mPages.Insert(PageIndex, Page);
+    return Page;
+}
+
+void SubresourcePager::SetBudget(size_t BudgetBytes) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mPages.SetBudget(BudgetBytes);
+}
+
+ResultCacheStatistics SubresourcePager::GetStatistics() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return mPages.GetStatistics();
+}
+
+DiskResultCache::DiskResultCache() :
+    mMutex {},
+    mDirectory {},
+    mBudgetBytes { DefaultDiskCacheBudget },
+    mResidentBytes { 0 },
+    mEntryCount { 0 },
+    mHits { 0 },
+    mMisses { 0 },
+    mEvictions { 0 } {
+}
+
+DiskResultCache::~DiskResultCache() {
+}
+
+DiskResultCache::DiskResultCache(const DiskResultCache& Other) :
+    DiskResultCache {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mDirectory = Other.mDirectory;
+    mBudgetBytes = Other.mBudgetBytes;
+    mResidentBytes = Other.mResidentBytes;
+    mEntryCount = Other.mEntryCount;
+}
+
+DiskResultCache& DiskResultCache::operator=(const DiskResultCache& Other) {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mDirectory = Other.mDirectory;
+        mBudgetBytes = Other.mBudgetBytes;
+        mResidentBytes = Other.mResidentBytes;
+        mEntryCount = Other.mEntryCount;
+        mHits = 0;
+        mMisses = 0;
+        mEvictions = 0;
+    }
+    return *this;
+}
+
+DiskResultCache::DiskResultCache(DiskResultCache&& Other) noexcept :
+    DiskResultCache {} {
+    std::lock_guard<std::mutex> Lock { Other.mMutex };
+    mDirectory = std::move(Other.mDirectory);
+    mBudgetBytes = Other.mBudgetBytes;
+    mResidentBytes = Other.mResidentBytes;
+    mEntryCount = Other.mEntryCount;
+    mHits = Other.mHits;
+    mMisses = Other.mMisses;
+    mEvictions = Other.mEvictions;
+    Other.mDirectory.clear();
+}
+
+DiskResultCache& DiskResultCache::operator=(DiskResultCache&& Other) noexcept {
+    if (this != &Other) {
+        std::scoped_lock Lock { mMutex, Other.mMutex };
+        mDirectory = std::move(Other.mDirectory);
+        mBudgetBytes = Other.mBudgetBytes;
+        mResidentBytes = Other.mResidentBytes;
+        mEntryCount = Other.mEntryCount;
+        mHits = Other.mHits;
+        mMisses = Other.mMisses;
+        mEvictions = Other.mEvictions;
+        Other.mDirectory.clear();
+    }
+    return *this;
+}
+
+bool DiskResultCache::Open(const std::filesystem::path& Directory, size_t BudgetBytes) {
+    std::error_code Error {};
+    std::filesystem::create_directories(Directory, Error);
+    if (Error || !std::filesystem::is_directory(Directory, Error)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mDirectory = Directory;
+    mBudgetBytes = BudgetBytes;
+    ScanDirectory();
+    EvictToBudget();
+    return true;
+}
+
+bool DiskResultCache::IsOpen() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return !mDirectory.empty();
+}
+
+bool DiskResultCache::Contains(uint64_t Key) const {
+    std::error_code Error {};
+    const std::filesystem::path EntryPath { MakeEntryPath(Key) };
+    return !EntryPath.empty() && std::filesystem::is_regular_file(EntryPath, Error);
+}
+
+bool DiskResultCache::TryLoad(uint64_t Key, const TexMetadata& Expected, std::shared_ptr<const ScratchImage>& ImageOut) {
+    const std::filesystem::path EntryPath { MakeEntryPath(Key) };
+    if (EntryPath.empty()) {
+        return false;
+    }
+    MappedFile File {};
+    TexMetadata Metadata {};
+    std::shared_ptr<ScratchImage> Loaded { std::make_shared<ScratchImage>() };
+    if (!File.Open(EntryPath) || FAILED(LoadFromDDSMemory(File.GetData(), File.GetSize(), DDS_FLAGS_NONE, &Metadata, *Loaded)) || !HasSameLayout(Metadata, Expected)) {
+        File.Close();
+        const uintmax_t RemovedBytes { GetFileSizeOrZero(EntryPath) };
+        std::error_code Error {};
+        const bool Removed { std::filesystem::remove(EntryPath, Error) };
+        std::lock_guard<std::mutex> Lock { mMutex };
+        if (Removed) {
+            mResidentBytes -= std::min(mResidentBytes, static_cast<size_t>(RemovedBytes));
+            mEntryCount -= std::min<size_t>(mEntryCount, 1);
+        }
+        ++mMisses;
+        return false;
+    }
+    File.Close();
+    std::error_code Error {};
+    std::filesystem::last_write_time(EntryPath, std::filesystem::file_time_type::clock::now(), Error);
+    ImageOut = std::move(Loaded);
+    std::lock_guard<std::mutex> Lock { mMutex };
+    ++mHits;
+    return true;
+}
+
+bool DiskResultCache::Store(uint64_t Key, const ScratchImage& Image) {
+    const std::filesystem::path EntryPath { MakeEntryPath(Key) };
+    if (EntryPath.empty() || Image.GetImageCount() == 0 || Image.GetPixelsSize() > GetStatistics().BudgetBytes) {
+        return false;
+    }
+    std::filesystem::path TemporaryPath { EntryPath };
+    TemporaryPath += "." + std::to_string(NextDiskCacheTemporaryIndex.fetch_add(1)) + ".tmp";
+    std::error_code Error {};
+    if (FAILED(SaveToDDSFile(Image.GetImages(), Image.GetImageCount(), Image.GetMetadata(), DDS_FLAGS_NONE, TemporaryPath.wstring().c_str()))) {
+        std::filesystem::remove(TemporaryPath, Error);
+        return false;
+    }
+    const uintmax_t StoredBytes { GetFileSizeOrZero(TemporaryPath) };
+    const bool Replaces { std::filesystem::is_regular_file(EntryPath, Error) };
+    const uintmax_t ReplacedBytes { Replaces ? GetFileSizeOrZero(EntryPath) : 0 };
+    std::filesystem::rename(TemporaryPath, EntryPath, Error);
+    if (Error) {
+        std::filesystem::remove(TemporaryPath, Error);
+        return false;
+    }
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mResidentBytes = mResidentBytes - std::min(mResidentBytes, static_cast<size_t>(ReplacedBytes)) + static_cast<size_t>(StoredBytes);
+    mEntryCount += Replaces ? 0 : 1;
+    EvictToBudget();
+    return true;
+}
+
+void DiskResultCache::SetBudget(size_t BudgetBytes) {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    mBudgetBytes = BudgetBytes;
+    EvictToBudget();
+}
+
+ResultCacheStatistics DiskResultCache::GetStatistics() const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    return ResultCacheStatistics { mHits, mMisses, mEvictions, mEntryCount, mResidentBytes, mBudgetBytes };
+}
+
+std::filesystem::path DiskResultCache::MakeEntryPath(uint64_t Key) const {
+    std::lock_guard<std::mutex> Lock { mMutex };
+    if (mDirectory.empty()) {
+        return {};
+    }
+    char Name[32] {};
+    std::snprintf(Name, sizeof(Name), "%016llx.dds", static_cast<unsigned long long>(Key));
+    return mDirectory / Name;
+}
+
+void DiskResultCache::ScanDirectory() {
+    mResidentBytes = 0;
+    mEntryCount = 0;
+    if (mDirectory.empty()) {
+        return;
+    }
+    const std::filesystem::file_time_type StaleTime { std::filesystem::file_time_type::clock::now() - StaleTemporaryAge };
+    std::error_code Error {};
+    for (std::filesystem::directory_iterator Iterator { mDirectory, Error }, End {}; !Error && Iterator != End; Iterator.increment(Error)) {
+        std::error_code EntryError {};
+        if (!Iterator->is_regular_file(EntryError)) {
+            continue;
+        }
+        const std::filesystem::path Extension { Iterator->path().extension() };
+        if (Extension == ".tmp") {
+            const std::filesystem::file_time_type WriteTime { Iterator->last_write_time(EntryError) };
+            if (!EntryError && WriteTime < StaleTime) {
+                std::filesystem::remove(Iterator->path(), EntryError);
+            }
+            continue;
+        }
+        if (Extension != ".dds") {
+            continue;
+        }
+        const uintmax_t Bytes { Iterator->file_size(EntryError) };
+        if (!EntryError) {
+            mResidentBytes += static_cast<size_t>(Bytes);
+            ++mEntryCount;
+        }
+    }
+}
+
+void DiskResultCache::EvictToBudget() {
+    struct CacheFile {
+        std::filesystem::path Path;
+        std::filesystem::file_time_type AccessTime;
+        uintmax_t Bytes;
+    };
+
+    if (mDirectory.empty() || mResidentBytes <= mBudgetBytes) {
+        return;
+    }
+    mResidentBytes = 0;
+    std::vector<CacheFile> Files {};
+    std::error_code Error {};
+    for (std::filesystem::directory_iterator Iterator { mDirectory, Error }, End {}; !Error && Iterator != End; Iterator.increment(Error)) {
+        std::error_code EntryError {};
+        if (!Iterator->is_regular_file(EntryError) || Iterator->path().extension() != ".dds") {
+            continue;
+        }
+        const uintmax_t Bytes { Iterator->file_size(EntryError) };
+        const std::filesystem::file_time_type AccessTime { Iterator->last_write_time(EntryError) };
+        if (!EntryError) {
+            Files.push_back(CacheFile { Iterator->path(), AccessTime, Bytes });
+            mResidentBytes += static_cast<size_t>(Bytes);
+        }
+    }
+    std::sort(Files.begin(), Files.end(), [](const CacheFile& Left, const CacheFile& Right) { return Left.AccessTime < Right.AccessTime; });
+    size_t RemovedCount { 0 };
+    for (size_t Index { 0 }; mResidentBytes > mBudgetBytes && Index < Files.size(); ++Index) {
+        if (std::filesystem::remove(Files[Index].Path, Error)) {
+            mResidentBytes -= static_cast<size_t>(Files[Index].Bytes);
+            ++RemovedCount;
+        }
+    }
+    mEvictions += RemovedCount;
+    mEntryCount = Files.size() - RemovedCount;
+}
+
+CompressionPreviewCache::CompressionPreviewCache() :
+    mDecodedIdentity { 0 },
+    mDecodedImage {},
+    mMipKey {},
+    mMipChain {},
+    mCompressKey {},
+    mCompressedImage {},
+    mRegionKey {},
+    mRegionBlocks {},
+    mRegionImage {},
+    mResultCache {},
+    mDiskCache {},
+    mContentHashIdentity { 0 },
+    mContentHash { 0 },
+    mPackagedImage {},
+    mPackagedBytes { 0 },
+    mTileEngine {},
+    mLastTimings {} {
+}
+
+CompressionPreviewCache::~CompressionPreviewCache() {
+}
+
+CompressionPreviewCache::CompressionPreviewCache(const CompressionPreviewCache& Other) :
+    mDecodedIdentity { Other.mDecodedIdentity },
+    mDecodedImage { Other.mDecodedImage },
+    mMipKey { Other.mMipKey },
+    mMipChain { Other.mMipChain },
+    mCompressKey { Other.mCompressKey },
+    mCompressedImage { Other.mCompressedImage },
+    mRegionKey { Other.mRegionKey },
+    mRegionBlocks { Other.mRegionBlocks },
+    mRegionImage { Other.mRegionImage },
+    mResultCache { Other.mResultCache },
+    mDiskCache { Other.mDiskCache },
+    mContentHashIdentity { Other.mContentHashIdentity },
+    mContentHash { Other.mContentHash },
+    mPackagedImage { Other.mPackagedImage },
+    mPackagedBytes { Other.mPackagedBytes },
+    mTileEngine { Other.mTileEngine },
+    mLastTimings { Other.mLastTimings } {
+}
+
+CompressionPreviewCache& CompressionPreviewCache::operator=(const CompressionPreviewCache& Other) {
+    if (this != &Other) {
+        mDecodedIdentity = Other.mDecodedIdentity;
+        mDecodedImage = Other.mDecodedImage;
+        mMipKey = Other.mMipKey;
+        mMipChain = Other.mMipChain;
+        mCompressKey = Other.mCompressKey;
+        mCompressedImage = Other.mCompressedImage;
+        mRegionKey = Other.mRegionKey;
+        mRegionBlocks = Other.mRegionBlocks;
+        mRegionImage = Other.mRegionImage;
+        mResultCache = Other.mResultCache;
+        mDiskCache = Other.mDiskCache;
+        mContentHashIdentity = Other.mContentHashIdentity;
+        mContentHash = Other.mContentHash;
+        mPackagedImage = Other.mPackagedImage;
+        mPackagedBytes = Other.mPackagedBytes;
+        mTileEngine = Other.mTileEngine;
+        mLastTimings = Other.mLastTimings;
+    }
+    return *this;
+}
+
+CompressionPreviewCache::CompressionPreviewCache(CompressionPreviewCache&& Other) noexcept :
+    mDecodedIdentity { Other.mDecodedIdentity },
+    mDecodedImage { std::move(Other.mDecodedImage) },
+    mMipKey { Other.mMipKey },
+    mMipChain { std::move(Other.mMipChain) },
+    mCompressKey { Other.mCompressKey },
+    mCompressedImage { std::move(Other.mCompressedImage) },
+    mRegionKey { Other.mRegionKey },
+    mRegionBlocks { Other.mRegionBlocks },
+    mRegionImage { std::move(Other.mRegionImage) },
+    mResultCache { std::move(Other.mResultCache) },
+    mDiskCache { std::move(Other.mDiskCache) },
+    mContentHashIdentity { Other.mContentHashIdentity },
+    mContentHash { Other.mContentHash },
+    mPackagedImage { std::move(Other.mPackagedImage) },
+    mPackagedBytes { Other.mPackagedBytes },
+    mTileEngine { std::move(Other.mTileEngine) },
+    mLastTimings { Other.mLastTimings } {
+    Other.mDecodedIdentity = 0;
+    Other.mMipKey = {};
+    Other.mCompressKey = {};
+    Other.mRegionKey = {};
+    Other.mContentHashIdentity = 0;
+    Other.mPackagedBytes = 0;
+}
+
+CompressionPreviewCache& CompressionPreviewCache::operator=(CompressionPreviewCache&& Other) noexcept {
+    if (this != &Other) {
+        mDecodedIdentity = Other.mDecodedIdentity;
+        mDecodedImage = std::move(Other.mDecodedImage);
+        mMipKey = Other.mMipKey;
+        mMipChain = std::move(Other.mMipChain);
+        mCompressKey = Other.mCompressKey;
+        mCompressedImage = std::move(Other.mCompressedImage);
+        mRegionKey = Other.mRegionKey;
+        mRegionBlocks = Other.mRegionBlocks;
+        mRegionImage = std::move(Other.mRegionImage);
+        mResultCache = std::move(Other.mResultCache);
+        mDiskCache = std::move(Other.mDiskCache);
+        mContentHashIdentity = Other.mContentHashIdentity;
+        mContentHash = Other.mContentHash;
+        mPackagedImage = std::move(Other.mPackagedImage);
+        mPackagedBytes = Other.mPackagedBytes;
+        mTileEngine = std::move(Other.mTileEngine);
+        mLastTimings = Other.mLastTimings;
+        Other.mDecodedIdentity = 0;
+        Other.mMipKey = {};
+        Other.mCompressKey = {};
+        Other.mRegionKey = {};
+        Other.mContentHashIdentity = 0;
+        Other.mPackagedBytes = 0;
+    }
+    return *this;
+}
+
+bool CompressionPreviewCache::Rebuild(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job) {
+    if (Document.GetSourceImage().ImageCount == 0 || Document.GetIdentity() == 0) {
+        return false;
+    }
+    mLastTimings = CompressionTimings { 0.0, 0.0, 0.0, ResolveCompressionThreadCount(Settings), false, false, 0, 0, 0.0 };
+    const PreviewResultKey ResultKey { MakePreviewResultKey(Document.GetIdentity(), Settings) };
+    std::shared_ptr<const ScratchImage> CachedImage {};
+    if (mResultCache.TryGet(ResultKey, CachedImage)) {
+        mCompressedImage = std::move(CachedImage);
+        mLastTimings.ResultCacheHit = true;
+        return true;
+    }
+
+    const TextureImageView Source { Document.GetSourceImage() };
+    const TexMetadata& SourceMetadata { Document.GetMetadata() };
+    if (SourceMetadata.format == ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) && (!Settings.GenerateMipmaps || SourceMetadata.mipLevels > 1)) {
+        std::shared_ptr<ScratchImage> PassThrough { std::make_shared<ScratchImage>() };
+        if (!CopyImageView(Source, *PassThrough)) {
+            return false;
+        }
+        mCompressKey = {};
+        mCompressedImage = std::move(PassThrough);
+        mResultCache.Insert(ResultKey, mCompressedImage);
+        return true;
+    }
+
+    const uint64_t DiskKey { mDiskCache != nullptr ? ComputeDiskCacheKey(GetContentHash(Document), Settings) : 0 };
+    ScopedStageTimer DiskTimer { PipelineStage::DiskCacheLoad };
+    if (mDiskCache != nullptr && mDiskCache->TryLoad(DiskKey, BuildExpectedResultMetadata(SourceMetadata, Settings), CachedImage)) {
+        DiskTimer.MarkCompleted(CountImagePixels(CachedImage->GetImages(), CachedImage->GetImageCount()), CachedImage->GetPixelsSize());
+        mCompressKey = {};
+        mCompressedImage = std::move(CachedImage);
+        mResultCache.Insert(ResultKey, mCompressedImage);
+        mLastTimings.DiskCacheHit = true;
+        return true;
+    }
+
+    const std::chrono::steady_clock::time_point DecodeStart { std::chrono::steady_clock::now() };
+    if (!PrepareDecodeStage(Document) || Job.IsCancelled()) {
+        return false;
+    }
+    mLastTimings.DecodeMilliseconds = ElapsedMilliseconds(DecodeStart);
+
+    const std::chrono::steady_clock::time_point MipStart { std::chrono::steady_clock::now() };
+    if (!PrepareMipStage(Document, Settings) || Job.IsCancelled()) {
+        return false;
+    }
+    mLastTimings.MipMilliseconds = ElapsedMilliseconds(MipStart);
+
+    const std::chrono::steady_clock::time_point CompressStart { std::chrono::steady_clock::now() };
+    if (!PrepareCompressStage(Document, Settings, Job)) {
+        return false;
+    }
+    mLastTimings.CompressMilliseconds = ElapsedMilliseconds(CompressStart);
+    mResultCache.Insert(ResultKey, mCompressedImage);
+    if (mDiskCache != nullptr && !Job.IsCancelled()) {
+        mDiskCache->Store(DiskKey, *mCompressedImage);
+    }
+    return true;
+}
+
+bool CompressionPreviewCache::RebuildRegion(const TextureDocument& Document, const AnalyzerSettings& Settings, const PreviewRegion& Region, const CompressionJobHandle& Job) {
+    const TexMetadata& Metadata { Document.GetMetadata() };
+    const DXGI_FORMAT TargetFormat { ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) };
+    if (!Settings.RegionOfInterestPreview || !IsCompressed(TargetFormat) || Metadata.format == TargetFormat || Region.Right <= Region.Left || Region.Bottom <= Region.Top) {
+        return false;
+    }
+    if (Region.Right - Region.Left >= Metadata.width && Region.Bottom - Region.Top >= Metadata.height) {
+        return false;
+    }
+    mLastTimings = CompressionTimings { 0.0, 0.0, 0.0, ResolveCompressionThreadCount(Settings), false, false, 0, 0, 0.0 };
+
+    const std::chrono::steady_clock::time_point DecodeStart { std::chrono::steady_clock::now() };
+    if (!PrepareDecodeStage(Document) || Job.IsCancelled()) {
+        return false;
+    }
+    mLastTimings.DecodeMilliseconds = ElapsedMilliseconds(DecodeStart);
+    const TextureImageView Decoded { GetDecodedImage(Document) };
+    if (Decoded.Images == nullptr || Decoded.ImageCount == 0) {
+        return false;
+    }
+    const Image* BaseImage { &Decoded.Images[0] };
+
+    const std::chrono::steady_clock::time_point CompressStart { std::chrono::steady_clock::now() };
+    const size_t BlockLeft { Region.Left / 4 };
+    const size_t BlockTop { Region.Top / 4 };
+    const size_t BlockRight { std::min((Region.Right + 3) / 4, (BaseImage->width + 3) / 4) };
+    const size_t BlockBottom { std::min((Region.Bottom + 3) / 4, (BaseImage->height + 3) / 4) };
+    if (BlockRight <= BlockLeft || BlockBottom <= BlockTop) {
+        return false;
+    }
+    const CompressionTile BlockRegion { 0, BlockLeft, BlockRight - BlockLeft, BlockTop, BlockBottom - BlockTop };
+    const BlockEncoder& Encoder { ResolveBlockEncoder(Settings) };
+    const float RdoLambda { ResolveRdoLambda(Settings) };
+    const CompressOptions Options { BuildCompressFlags(Settings), TEX_THRESHOLD_DEFAULT, Settings.AlphaWeight };
+    std::shared_ptr<ScratchImage> Compressed { std::make_shared<ScratchImage>() };
+    mRegionKey = {};
+    mRegionImage.reset();
+    if (!mTileEngine.CompressRegion(*BaseImage, TargetFormat, Encoder, Options, ResolveEncoderRefinementPasses(Settings), RdoLambda, ResolveCompressionThreadCount(Settings), BlockRegion, [&Job]() { return Job.IsCancelled(); }, *Compressed)) {
+        return false;
+    }
+    if (Job.IsCancelled()) {
+        return false;
+    }
+    const TileCompressionStatistics& TileStatistics { mTileEngine.GetStatistics() };
+    mLastTimings.CompressMilliseconds = ElapsedMilliseconds(CompressStart);
+    mLastTimings.TileCount = TileStatistics.TileCount;
+    mLastTimings.StolenTileCount = TileStatistics.StolenTileCount;
+    mLastTimings.SlowestTileMilliseconds = TileStatistics.SlowestTileMilliseconds;
+    mCompressKey = {};
+    mCompressedImage = std::move(Compressed);
+    if (RdoLambda <= 0.0f) {
+        mRegionKey = BuildRegionStageKey(Document.GetIdentity(), Settings, TargetFormat, Encoder.Backend, RdoLambda);
+        mRegionBlocks = BlockRegion;
+        mRegionImage = mCompressedImage;
+    }
+    return true;
+}
+
+bool CompressionPreviewCache::HasCachedResult(const TextureDocument& Document, const AnalyzerSettings& Settings) const {
+    if (mResultCache.Contains(MakePreviewResultKey(Document.GetIdentity(), Settings))) {
+        return true;
+    }
+    return mDiskCache != nullptr && mDiskCache->Contains(ComputeDiskCacheKey(GetContentHash(Document), Settings));
+}
+
+bool CompressionPreviewCache::PrepareDecodeStage(const TextureDocument& Document) {
+    if (mDecodedIdentity == Document.GetIdentity()) {
+        return true;
+    }
+    mDecodedIdentity = 0;
+    mDecodedImage.reset();
+
+    ScopedStageTimer Timer { PipelineStage::Decode };
+    const TextureImageView Source { Document.GetSourceImage() };
+    if (IsCompressed(Source.Metadata.format) && Document.IsLazy()) {
+        mDecodedImage = Document.AcquireSubresource(Document.GetSelectedMip(), Document.GetSelectedItem(), 0);
+        if (mDecodedImage == nullptr) {
+            return false;
+        }
+    } else if (IsCompressed(Source.Metadata.format)) {
+        std::shared_ptr<ScratchImage> Decoded { std::make_shared<ScratchImage>() };
+        const HRESULT DecodeHr { Decompress(Source.Images, Source.ImageCount, Source.Metadata, DXGI_FORMAT_UNKNOWN, *Decoded) };
+        if (FAILED(DecodeHr)) {
+            return false;
+        }
+        mDecodedImage = std::move(Decoded);
+    }
+    if (mDecodedImage != nullptr) {
+        Timer.MarkCompleted(CountImagePixels(mDecodedImage->GetImages(), mDecodedImage->GetImageCount()), mDecodedImage->GetPixelsSize());
+    }
+    mDecodedIdentity = Document.GetIdentity();
+    return true;
+}
+
+bool CompressionPreviewCache::PrepareMipStage(const TextureDocument& Document, const AnalyzerSettings& Settings) {
+    const MipStageKey Key { BuildMipStageKey(Document, Settings) };
+    if (mMipKey == Key) {
+        return true;
+    }
+    mMipKey = {};
+    mMipChain.reset();
+
+    if (Settings.GenerateMipmaps) {
+        ScopedStageTimer Timer { PipelineStage::MipGeneration };
+        const TextureImageView Decoded { GetDecodedImage(Document) };
+        const TEX_FILTER_FLAGS Filter { ResolveMipFilter(Settings) };
+        std::shared_ptr<ScratchImage> MipChain { std::make_shared<ScratchImage>() };
+        const HRESULT MipHr { GenerateMipMaps(Decoded.Images, Decoded.ImageCount, Decoded.Metadata, Filter, 0, *MipChain) };
+        if (FAILED(MipHr)) {
+            return false;
+        }
+        Timer.MarkCompleted(CountImagePixels(MipChain->GetImages(), MipChain->GetImageCount()), MipChain->GetPixelsSize());
+        mMipChain = std::move(MipChain);
+    }
+    mMipKey = Key;
+    return true;
+}
+
+bool CompressionPreviewCache::PrepareCompressStage(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job) {
+    const DXGI_FORMAT TargetFormat { ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) };
+    const TEX_COMPRESS_FLAGS Flags { BuildCompressFlags(Settings) };
+    const BlockEncoder& Encoder { ResolveBlockEncoder(Settings) };
+    const float RdoLambda { ResolveRdoLambda(Settings) };
+    const CompressStageKey Key { mMipKey, TargetFormat, Flags & ~TEX_COMPRESS_PARALLEL, Settings.AlphaWeight, Encoder.Backend, RdoLambda };
+    if (mCompressKey == Key && mCompressedImage != nullptr) {
+        return true;
+    }
+    mCompressKey = {};
+
+    ScopedStageTimer Timer { PipelineStage::Compress };
+    const TextureImageView WorkingImage { GetWorkingImage(Document) };
+    const TexMetadata& WorkingMetadata { WorkingImage.Metadata };
+    std::shared_ptr<ScratchImage> Compressed { std::make_shared<ScratchImage>() };
+    if (WorkingMetadata.format == TargetFormat) {
+        if (!CopyImageView(WorkingImage, *Compressed)) {
+            return false;
+        }
+    } else if (IsCompressed(TargetFormat) && (Settings.UseTileScheduler || Encoder.Backend == BlockEncoderBackend::Native)) {
+        const CompressOptions Options { Flags, TEX_THRESHOLD_DEFAULT, Settings.AlphaWeight };
+        const bool ReuseRegion { mRegionImage != nullptr && mRegionKey == BuildRegionStageKey(Document.GetIdentity(), Settings, TargetFormat, Encoder.Backend, RdoLambda) &&
+            HasSameBaseImage(WorkingImage, GetDecodedImage(Document)) };
+        const bool Encoded { ReuseRegion ?
+            mTileEngine.CompressReusingRegion(WorkingImage.Images, WorkingImage.ImageCount, WorkingMetadata, TargetFormat, Encoder, Options, ResolveEncoderRefinementPasses(Settings), RdoLambda, ResolveCompressionThreadCount(Settings), *mRegionImage->GetImage(0, 0, 0), mRegionBlocks, [&Job]() { return Job.IsCancelled(); }, *Compressed) :
+            mTileEngine.Compress(WorkingImage.Images, WorkingImage.ImageCount, WorkingMetadata, TargetFormat, Encoder, Options, ResolveEncoderRefinementPasses(Settings), RdoLambda, ResolveCompressionThreadCount(Settings), [&Job]() { return Job.IsCancelled(); }, *Compressed) };
+        if (!Encoded) {
+            return false;
+        }
+        const TileCompressionStatistics& TileStatistics { mTileEngine.GetStatistics() };
+        mLastTimings.TileCount = TileStatistics.TileCount;
+        mLastTimings.StolenTileCount = TileStatistics.StolenTileCount;
+        mLastTimings.SlowestTileMilliseconds = TileStatistics.SlowestTileMilliseconds;
+    } else if (IsCompressed(TargetFormat)) {
+        const CompressOptions Options { Flags, TEX_THRESHOLD_DEFAULT, Settings.AlphaWeight };
+        ApplyCompressionThreadCount(Settings);
+        const HRESULT CompressHr { CompressEx(WorkingImage.Images, WorkingImage.ImageCount, WorkingMetadata, TargetFormat, Options, *Compressed, [&Job](size_t, size_t) { return !Job.IsCancelled(); }) };
+        if (FAILED(CompressHr)) {
+            return false;
+        }
+    } else {
+        const HRESULT ConvertHr { Convert(WorkingImage.Images, WorkingImage.ImageCount, WorkingMetadata, TargetFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, *Compressed) };
+        if (FAILED(ConvertHr)) {
+            return false;
+        }
+    }
+    if (Job.IsCancelled()) {
+        return false;
+    }
+
+    Timer.MarkCompleted(CountImagePixels(WorkingImage.Images, WorkingImage.ImageCount), Compressed->GetPixelsSize());
+    mCompressKey = Key;
+    mCompressedImage = std::move(Compressed);
+    mRegionKey = {};
+    mRegionImage.reset();
+    return true;
+}
+
+TextureImageView CompressionPreviewCache::GetDecodedImage(const TextureDocument& Document) const {
+    if (mDecodedImage != nullptr) {
+        return MakeImageView(*mDecodedImage);
+    }
+    return Document.GetSourceImage();
+}
+
+TextureImageView CompressionPreviewCache::GetWorkingImage(const TextureDocument& Document) const {
+    if (mMipChain != nullptr) {
+        return MakeImageView(*mMipChain);
+    }
+    return GetDecodedImage(Document);
+}
+
+bool CompressionPreviewCache::SaveAsDds(const std::filesystem::path& OutputPath) const {
+    if (mCompressedImage == nullptr || mCompressedImage->GetPixels() == nullptr) {
+        return false;
+    }
+    ScopedStageTimer Timer { PipelineStage::Save };
+    const HRESULT Hr { SaveToDDSFile(mCompressedImage->GetImages(), mCompressedImage->GetImageCount(), mCompressedImage->GetMetadata(), DDS_FLAGS_NONE, OutputPath.wstring().c_str()) };
+    if (FAILED(Hr)) {
+        return false;
+    }
+    Timer.MarkCompleted(CountImagePixels(mCompressedImage->GetImages(), mCompressedImage->GetImageCount()), mCompressedImage->GetPixelsSize());
+    return true;
+}
+
+TextureMemoryMetrics CompressionPreviewCache::BuildMetrics(const TexMetadata& SourceMetadata) const {
+    TextureMemoryMetrics Metrics { 0, 0, 0, 0.0 };
+    Metrics.SourceBytes = static_cast<size_t>(SourceMetadata.width) * static_cast<size_t>(SourceMetadata.height) * 4;
+    if (mCompressedImage == nullptr || mCompressedImage->GetPixels() == nullptr || mCompressedImage->GetImageCount() == 0) {
+        return Metrics;
+    }
+    Metrics.SourceBytes = static_cast<size_t>(CountImagePixels(mCompressedImage->GetImages(), mCompressedImage->GetImageCount())) * 4;
+    Metrics.CompressedBytes = mCompressedImage->GetPixelsSize();
+    Metrics.PackagedBytes = mPackagedImage.lock() == mCompressedImage ? mPackagedBytes : 0;
+    Metrics.CompressionRatio = Metrics.CompressedBytes == 0 ? 0.0 : static_cast<double>(Metrics.SourceBytes) / static_cast<double>(Metrics.CompressedBytes);
+    return Metrics;
+}
+
+size_t CompressionPreviewCache::MeasurePackagedBytes() const {
+    if (mCompressedImage == nullptr) {
+        return 0;
+    }
+    if (mPackagedImage.lock() == mCompressedImage) {
+        return mPackagedBytes;
+    }
+    size_t PackagedBytes { 0 };
+    if (mCompressedImage->GetImageCount() == 0 || !MeasureDeflatedSize(mCompressedImage->GetPixels(), mCompressedImage->GetPixelsSize(), PackagedBytes)) {
+        return 0;
+    }
+    mPackagedImage = mCompressedImage;
+    mPackagedBytes = PackagedBytes;
+    return PackagedBytes;
+}
+
+const ScratchImage& CompressionPreviewCache::GetCompressedImage() const {
+    if (mCompressedImage == nullptr) {
+        return GetEmptyScratchImage();
+    }
+    return *mCompressedImage;
+}
+
+std::shared_ptr<const ScratchImage> CompressionPreviewCache::GetCompressedSnapshot() const {
+    return mCompressedImage;
+}
+
+void CompressionPreviewCache::Publish(std::shared_ptr<const ScratchImage> Image, size_t PackagedBytes) {
+    mCompressedImage = std::move(Image);
+    mPackagedImage = PackagedBytes == 0 ? std::weak_ptr<const ScratchImage> {} : std::weak_ptr<const ScratchImage> { mCompressedImage };
+    mPackagedBytes = PackagedBytes;
+}
+
+void CompressionPreviewCache::SetResultCacheBudget(size_t BudgetBytes) {
+    mResultCache.SetBudget(BudgetBytes);
+}
+
+ResultCacheStatistics CompressionPreviewCache::GetResultCacheStatistics() const {
+    return mResultCache.GetStatistics();
+}
+
+void CompressionPreviewCache::SetDiskCache(std::shared_ptr<DiskResultCache> DiskCache) {
+    mDiskCache = std::move(DiskCache);
+}
+
+uint64_t CompressionPreviewCache::GetContentHash(const TextureDocument& Document) const {
+    if (mContentHashIdentity != Document.GetIdentity()) {
+        mContentHash = ComputeImageContentHash(Document.GetSourceImage());
+        mContentHashIdentity = Document.GetIdentity();
+    }
+    return mContentHash;
+}
+
+const CompressionTimings& CompressionPreviewCache::GetLastTimings() const {
+    return mLastTimings;
+}
+
+TextureFileKind DetectTextureFileKind(const std::filesystem::path& FilePath) {
+    std::ifstream Stream { FilePath, std::ios::binary };
+    if (!Stream) {
+        return TextureFileKind::Unknown;
+    }
+    std::array<char, 10> Magic {};
+    Stream.read(Magic.data(), static_cast<std::streamsize>(Magic.size()));
+    const std::string Header { Magic.data(), static_cast<size_t>(Stream.gcount()) };
+    if (Header.compare(0, 4, "DDS ") == 0) {
+        return TextureFileKind::Dds;
+    }
+    if (Header.compare(0, 10, "#?RADIANCE") == 0 || Header.compare(0, 6, "#?RGBE") == 0) {
+        return TextureFileKind::Hdr;
+    }
+
+    std::string Extension { FilePath.extension().string() };
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+    if (Extension == ".dds") {
+        return TextureFileKind::Dds;
+    }
+    if (Extension == ".tga") {
+        return TextureFileKind::Tga;
+    }
+    if (Extension == ".hdr") {
+        return TextureFileKind::Hdr;
+    }
+    return TextureFileKind::Wic;
+}
+
+std::vector<FormatOption> BuildCompressionCandidateFormats() {
+    std::vector<FormatOption> Formats {
+        { DXGI_FORMAT_R8_UNORM, "R8_UNORM" },
+        { DXGI_FORMAT_R8_SNORM, "R8_SNORM" },
+        { DXGI_FORMAT_R8G8_UNORM, "R8G8_UNORM" },
+        { DXGI_FORMAT_R8G8_SNORM, "R8G8_SNORM" },
+        { DXGI_FORMAT_R8G8B8A8_UNORM, "R8G8B8A8_UNORM" },
+        { DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, "R8G8B8A8_UNORM_SRGB" },
+        { DXGI_FORMAT_B8G8R8A8_UNORM, "B8G8R8A8_UNORM" },
+        { DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, "B8G8R8A8_UNORM_SRGB" },
+        { DXGI_FORMAT_R10G10B10A2_UNORM, "R10G10B10A2_UNORM" },
+        { DXGI_FORMAT_R11G11B10_FLOAT, "R11G11B10_FLOAT" },
+        { DXGI_FORMAT_R16_FLOAT, "R16_FLOAT" },
+        { DXGI_FORMAT_R16G16_FLOAT, "R16G16_FLOAT" },
+        { DXGI_FORMAT_R16G16B16A16_FLOAT, "R16G16B16A16_FLOAT" },
+        { DXGI_FORMAT_R32_FLOAT, "R32_FLOAT" },
+        { DXGI_FORMAT_R32G32_FLOAT, "R32G32_FLOAT" },
+        { DXGI_FORMAT_R32G32B32A32_FLOAT, "R32G32B32A32_FLOAT" },
+        { DXGI_FORMAT_BC1_UNORM, "BC1_UNORM" },
+        { DXGI_FORMAT_BC1_UNORM_SRGB, "BC1_UNORM_SRGB" },
+        { DXGI_FORMAT_BC2_UNORM, "BC2_UNORM" },
+        { DXGI_FORMAT_BC2_UNORM_SRGB, "BC2_UNORM_SRGB" },
+        { DXGI_FORMAT_BC3_UNORM, "BC3_UNORM" },
+        { DXGI_FORMAT_BC3_UNORM_SRGB, "BC3_UNORM_SRGB" },
+        { DXGI_FORMAT_BC4_UNORM, "BC4_UNORM" },
+        { DXGI_FORMAT_BC4_SNORM, "BC4_SNORM" },
+        { DXGI_FORMAT_BC5_UNORM, "BC5_UNORM" },
+        { DXGI_FORMAT_BC5_SNORM, "BC5_SNORM" },
+        { DXGI_FORMAT_BC6H_UF16, "BC6H_UF16" },
+        { DXGI_FORMAT_BC6H_SF16, "BC6H_SF16" },
+        { DXGI_FORMAT_BC7_UNORM, "BC7_UNORM" },
+        { DXGI_FORMAT_BC7_UNORM_SRGB, "BC7_UNORM_SRGB" }
+    };
+    return Formats;
+}
+
+DXGI_FORMAT ResolveSrgbVariant(DXGI_FORMAT Format, bool IsSrgb) {
+    if (!IsSrgb) {
+        return Format;
+    }
+    if (Format == DXGI_FORMAT_BC1_UNORM) {
+        return DXGI_FORMAT_BC1_UNORM_SRGB;
+    }
+    if (Format == DXGI_FORMAT_BC2_UNORM) {
+        return DXGI_FORMAT_BC2_UNORM_SRGB;
+    }
+    if (Format == DXGI_FORMAT_BC3_UNORM) {
+        return DXGI_FORMAT_BC3_UNORM_SRGB;
+    }
+    if (Format == DXGI_FORMAT_BC7_UNORM) {
+        return DXGI_FORMAT_BC7_UNORM_SRGB;
+    }
+    if (Format == DXGI_FORMAT_R8G8B8A8_UNORM) {
+        return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    }
+    if (Format == DXGI_FORMAT_B8G8R8A8_UNORM) {
+        return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+    }
+    return Format;
+}
+
+TEX_COMPRESS_FLAGS BuildCompressFlags(const AnalyzerSettings& Settings) {
+    TEX_COMPRESS_FLAGS Flags { TEX_COMPRESS_DEFAULT };
+    if (Settings.CompressionQuality == CompressionQualityLevel::Fast) {
+        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_BC7_QUICK);
+    }
+    if (Settings.CompressionQuality == CompressionQualityLevel::Best) {
+        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_BC7_USE_3SUBSETS);
+    }
+    if (Settings.IsNormalMap) {
+        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_UNIFORM);
+    }
+    if (Settings.Threading != CompressionThreadingMode::Off) {
+        Flags = static_cast<TEX_COMPRESS_FLAGS>(Flags | TEX_COMPRESS_PARALLEL);
+    }
+    return Flags;
+}
+
+TEX_FILTER_FLAGS ResolveMipFilter(const AnalyzerSettings& Settings) {
+    return Settings.IsSrgb ? static_cast<TEX_FILTER_FLAGS>(Settings.MipFilter | TEX_FILTER_SRGB) : Settings.MipFilter;
+}
+
+const BlockEncoder& ResolveBlockEncoder(const AnalyzerSettings& Settings) {
+    return SelectBlockEncoder(Settings.EncoderBackend, ResolveSrgbVariant(Settings.Format, Settings.IsSrgb));
+}
+
+uint32_t ResolveEncoderRefinementPasses(const AnalyzerSettings& Settings) {
+    switch (Settings.CompressionQuality) {
+    case CompressionQualityLevel::Fast:
+        return 0;
+    case CompressionQualityLevel::Best:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+float ResolveRdoLambda(const AnalyzerSettings& Settings) {
+    if (ResolveBlockEncoder(Settings).Backend != BlockEncoderBackend::Native) {
+        return 0.0f;
+    }
+    return std::max(Settings.RdoLambda, 0.0f);
+}
+
+bool ResolvePreliminarySettings(const AnalyzerSettings& Settings, AnalyzerSettings& PreliminaryOut) {
+    if (!Settings.ProgressivePreview || Settings.CompressionQuality == CompressionQualityLevel::Fast) {
+        return false;
+    }
+    const DXGI_FORMAT TargetFormat { ResolveSrgbVariant(Settings.Format, Settings.IsSrgb) };
+    if (TargetFormat != DXGI_FORMAT_BC7_UNORM && TargetFormat != DXGI_FORMAT_BC7_UNORM_SRGB && TargetFormat != DXGI_FORMAT_BC7_TYPELESS) {
+        return false;
+    }
+    PreliminaryOut = Settings;
+    PreliminaryOut.CompressionQuality = CompressionQualityLevel::Fast;
+    return true;
+}
+
+uint32_t ResolveCompressionThreadCount(const AnalyzerSettings& Settings) {
+    const uint32_t HardwareThreads { std::max(1u, std::thread::hardware_concurrency()) };
+    if (Settings.Threading == CompressionThreadingMode::Off) {
+        return 1;
+    }
+    if (Settings.Threading == CompressionThreadingMode::Explicit) {
+        return std::clamp(Settings.ThreadCount, 1u, HardwareThreads);
+    }
+    return HardwareThreads;
+}
+
+uint64_t ComputeSettingsHash(const AnalyzerSettings& Settings) {
+    uint64_t Hash { HashOffsetBasis };
+    Hash = HashValue(Hash, Settings.AutoFormat ? DXGI_FORMAT_UNKNOWN : Settings.Format);
+    Hash = HashValue(Hash, Settings.MipFilter);
+    Hash = HashValue(Hash, Settings.GenerateMipmaps);
+    Hash = HashValue(Hash, Settings.IsSrgb);
+    Hash = HashValue(Hash, Settings.IsNormalMap);
+    Hash = HashValue(Hash, Settings.ReconstructZ);
+    Hash = HashValue(Hash, Settings.CompressionQuality);
+    Hash = HashValue(Hash, Settings.AlphaWeight);
+    if (ResolveBlockEncoder(Settings).Backend != BlockEncoderBackend::DirectXTex) {
+        Hash = HashValue(Hash, ResolveBlockEncoder(Settings).Backend);
+    }
+    if (ResolveRdoLambda(Settings) > 0.0f) {
+        Hash = HashValue(Hash, ResolveRdoLambda(Settings));
+    }
+    if (Settings.AutoFormat) {
+        Hash = HashValue(Hash, Settings.AutoFormat);
+        Hash = HashValue(Hash, Settings.AutoFormatMinimumPsnr);
+        Hash = HashValue(Hash, Settings.AutoFormatMinimumSsim);
+    }
+    return Hash;
+}
+
+uint64_t ComputePreviewCacheKey(uint64_t SourceIdentity, const AnalyzerSettings& Settings) {
+    const uint64_t SettingsHash { ComputeSettingsHash(Settings) };
+    uint64_t Hash { HashValue(HashOffsetBasis, SourceIdentity) };
+    Hash = HashValue(Hash, SettingsHash);
+    return Hash;
+}
+
+PreviewResultKey MakePreviewResultKey(uint64_t SourceIdentity, const AnalyzerSettings& Settings) {
+    const float RdoLambda { ResolveRdoLambda(Settings) };
+    return PreviewResultKey {
+        ComputePreviewCacheKey(SourceIdentity, Settings),
+        SourceIdentity,
+        Settings.AutoFormat ? DXGI_FORMAT_UNKNOWN : Settings.Format,
+        Settings.MipFilter,
+        Settings.GenerateMipmaps,
+        Settings.IsSrgb,
+        Settings.IsNormalMap,
+        Settings.ReconstructZ,
+        Settings.CompressionQuality,
+        Settings.AlphaWeight,
+        ResolveBlockEncoder(Settings).Backend,
+        RdoLambda > 0.0f ? RdoLambda : 0.0f,
+        Settings.AutoFormat,
+        Settings.AutoFormat ? Settings.AutoFormatMinimumPsnr : 0.0f,
+        Settings.AutoFormat ? Settings.AutoFormatMinimumSsim : 0.0f
+    };
+}
+
+bool ShouldOpenLazily(const std::filesystem::path& FilePath) {
+    std::error_code SizeError {};
+    const uintmax_t FileSize { std::filesystem::file_size(FilePath, SizeError) };
+    return !SizeError && FileSize >= LazyOpenThresholdBytes && DetectTextureFileKind(FilePath) == TextureFileKind::Dds;
+}
+
+bool ComputeFileContentHash(const std::filesystem::path& FilePath, uint64_t& HashOut) {
+    MappedFile File {};
+    if (!File.Open(FilePath)) {
+        return false;
+    }
+    HashOut = HashBytes(HashOffsetBasis, File.GetData(), File.GetSize());
+    return true;
+}
+
+uint64_t ComputeImageContentHash(const TextureImageView& View) {
+    uint64_t Hash { HashOffsetBasis };
+    Hash = HashValue(Hash, View.Metadata.width);
+    Hash = HashValue(Hash, View.Metadata.height);
+    Hash = HashValue(Hash, View.Metadata.depth);
+    Hash = HashValue(Hash, View.Metadata.arraySize);
+    Hash = HashValue(Hash, View.Metadata.mipLevels);
+    Hash = HashValue(Hash, View.Metadata.miscFlags);
+    Hash = HashValue(Hash, View.Metadata.format);
+    Hash = HashValue(Hash, View.Metadata.dimension);
+    for (size_t Index { 0 }; Index < View.ImageCount; ++Index) {
+        Hash = HashBytes(Hash, View.Images[Index].pixels, View.Images[Index].slicePitch);
+    }
+    return Hash;
+}
+
+uint64_t CountImagePixels(const Image* Images, size_t ImageCount) {
+    uint64_t Pixels { 0 };
+    for (size_t Index { 0 }; Images != nullptr && Index < ImageCount; ++Index) {
+        Pixels += static_cast<uint64_t>(Images[Index].width) * static_cast<uint64_t>(Images[Index].height);
+    }
+    return Pixels;
+}
+
+size_t CountImageBytes(const Image* Images, size_t ImageCount) {
+    size_t Bytes { 0 };
+    for (size_t Index { 0 }; Images != nullptr && Index < ImageCount; ++Index) {
+        Bytes += Images[Index].slicePitch;
+    }
+    return Bytes;
+}
+
+bool MeasureDeflatedSize(const void* Data, size_t Size, size_t& SizeOut) {
+    SizeOut = 0;
+    if (Size == 0) {
+        return true;
+    }
+    if (Data == nullptr) {
+        return false;
+    }
+#if defined(TEXTURE_COMPRESSION_HAS_ZLIB)
+    z_stream Stream {};
+    if (deflateInit(&Stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    std::vector<Bytef> Output(DeflateChunkBytes);
+    const Bytef* Input { static_cast<const Bytef*>(Data) };
+    size_t Remaining { Size };
+    int Status { Z_OK };
+    while (Status != Z_STREAM_END) {
+        if (Stream.avail_in == 0 && Remaining > 0) {
+            const size_t InputBytes { std::min(Remaining, DeflateChunkBytes) };
+            Stream.next_in = const_cast<Bytef*>(Input);
+            Stream.avail_in = static_cast<uInt>(InputBytes);
+            Input += InputBytes;
+            Remaining -= InputBytes;
+        }
+        Stream.next_out = Output.data();
+        Stream.avail_out = static_cast<uInt>(Output.size());
+        Status = deflate(&Stream, Remaining == 0 ? Z_FINISH : Z_NO_FLUSH);
+        if (Status != Z_OK && Status != Z_STREAM_END && Status != Z_BUF_ERROR) {
+            deflateEnd(&Stream);
+            return false;
+        }
+        SizeOut += Output.size() - Stream.avail_out;
+    }
+    deflateEnd(&Stream);
+    return true;
+#elif defined(_WIN32)
+    COMPRESSOR_HANDLE Compressor { nullptr };
+    if (!CreateCompressor(COMPRESS_ALGORITHM_MSZIP, nullptr, &Compressor)) {
+        return false;
+    }
+    SIZE_T RequiredBytes { 0 };
+    if (!::Compress(Compressor, Data, Size, nullptr, 0, &RequiredBytes) && GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+        CloseCompressor(Compressor);
+        return false;
+    }
+    std::vector<uint8_t> Output(RequiredBytes);
+    SIZE_T CompressedBytes { 0 };
+    const bool Succeeded { ::Compress(Compressor, Data, Size, Output.data(), Output.size(), &CompressedBytes) != FALSE };
+    CloseCompressor(Compressor);
+    if (!Succeeded) {
+        return false;
+    }
+    SizeOut = CompressedBytes;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,394 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <DirectXTex.h>
+
+#include "MappedFile.h"
+#include "PipelineProfiler.h"
+#include "TileCompressionEngine.h"
+
+#ifdef _MSC_VER
+#pragma comment(lib, "DirectXTex.lib")
+#endif
+
+using namespace DirectX;
+
+constexpr float DefaultAutoFormatMinimumPsnr { 40.0f };
+constexpr float DefaultAutoFormatMinimumSsim { 0.97f };
+
+enum class CompressionQualityLevel {
+    Fast,
+    Normal,
+    Best
+};
+
+enum class CompressionThreadingMode {
+    Off,
+    Auto,
+    Explicit
+};
+
+enum class TextureFileKind {
+    Unknown,
+    Dds,
+    Tga,
+    Hdr,
+    Wic
+};
+
+enum class ChannelViewMode {
+    Rgba,
+    Red,
+    Green,
+    Blue,
+    Alpha,
+    Diff
+};
+
+struct AnalyzerSettings {
+    DXGI_FORMAT Format;
+    TEX_FILTER_FLAGS MipFilter;
+    bool GenerateMipmaps;
+    bool IsSrgb;
+    bool IsNormalMap;
+    bool ReconstructZ;
+    CompressionQualityLevel CompressionQuality;
+    BlockEncoderBackend EncoderBackend;
+    ChannelViewMode ChannelView;
+    float AlphaWeight;
+    CompressionThreadingMode Threading;
+    uint32_t ThreadCount;
+    bool UseTileScheduler;
+    bool ProgressivePreview;
+    bool RegionOfInterestPreview;
+    float RdoLambda;
+    bool AutoFormat;
+    float AutoFormatMinimumPsnr;
+    float AutoFormatMinimumSsim;
+};
+
+struct TextureMemoryMetrics {
+    size_t SourceBytes;
+    size_t CompressedBytes;
+    size_t PackagedBytes;
+    double CompressionRatio;
+};
+
+struct CompressionTimings {
+    double DecodeMilliseconds;
+    double MipMilliseconds;
+    double CompressMilliseconds;
+    uint32_t ThreadCount;
+    bool ResultCacheHit;
+    bool DiskCacheHit;
+    size_t TileCount;
+    size_t StolenTileCount;
+    double SlowestTileMilliseconds;
+};
+
+struct ResultCacheStatistics {
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+    size_t EntryCount;
+    size_t ResidentBytes;
+    size_t BudgetBytes;
+};
+
+struct TextureImageView {
+    const DirectX::Image* Images;
+    size_t ImageCount;
+    DirectX::TexMetadata Metadata;
+};
+
+struct PreviewRegion {
+    size_t Left;
+    size_t Top;
+    size_t Right;
+    size_t Bottom;
+};
+
+struct FormatOption {
+    DXGI_FORMAT Format;
+    std::string Name;
+};
+
+class SubresourcePager;
+
+class TextureDocument {
+public:
+    TextureDocument();
+    ~TextureDocument();
+    TextureDocument(const TextureDocument& Other);
+    TextureDocument& operator=(const TextureDocument& Other);
+    TextureDocument(TextureDocument&& Other) noexcept;
+    TextureDocument& operator=(TextureDocument&& Other) noexcept;
+
+public:
+    bool LoadFromFile(const std::filesystem::path& FilePath);
+    bool OpenLazy(const std::filesystem::path& FilePath);
+    bool SelectSubresource(size_t Mip, size_t Item);
+    std::shared_ptr<const DirectX::ScratchImage> AcquireSubresource(size_t Mip, size_t Item, size_t Slice) const;
+    TextureImageView GetSourceImage() const;
+    bool IsMemoryMapped() const;
+    bool IsLazy() const;
+    size_t GetSelectedMip() const;
+    size_t GetSelectedItem() const;
+    ResultCacheStatistics GetPageStatistics() const;
+    const DirectX::TexMetadata& GetMetadata() const;
+    const DirectX::TexMetadata& GetFileMetadata() const;
+    const std::filesystem::path& GetPath() const;
+    uint64_t GetIdentity() const;
+
+private:
+    bool LoadMappedDds(const std::filesystem::path& FilePath);
+    bool CopyImagesFrom(const TextureDocument& Other);
+
+private:
+    DirectX::ScratchImage mSourceImage;
+    std::shared_ptr<MappedFile> mMappedFile;
+    std::vector<DirectX::Image> mMappedImages;
+    std::shared_ptr<SubresourcePager> mPager;
+    DirectX::TexMetadata mMetadata;
+    DirectX::TexMetadata mFileMetadata;
+    std::filesystem::path mPath;
+    uint64_t mIdentity;
+    size_t mSelectedMip;
+    size_t mSelectedItem;
+    bool mIsLazy;
+};
+
+struct MipStageKey {
+    uint64_t SourceIdentity;
+    TEX_FILTER_FLAGS MipFilter;
+    bool GenerateMipmaps;
+    bool IsSrgb;
+
+    bool operator==(const MipStageKey& Other) const = default;
+};
+
+struct CompressStageKey {
+    MipStageKey Input;
+    DXGI_FORMAT Format;
+    TEX_COMPRESS_FLAGS Flags;
+    float AlphaWeight;
+    BlockEncoderBackend EncoderBackend;
+    float RdoLambda;
+
+    bool operator==(const CompressStageKey& Other) const = default;
+};
+
+struct PreviewResultKey {
+    uint64_t Hash;
+    uint64_t SourceIdentity;
+    DXGI_FORMAT Format;
+    TEX_FILTER_FLAGS MipFilter;
+    bool GenerateMipmaps;
+    bool IsSrgb;
+    bool IsNormalMap;
+    bool ReconstructZ;
+    CompressionQualityLevel CompressionQuality;
+    float AlphaWeight;
+    BlockEncoderBackend EncoderBackend;
+    float RdoLambda;
+    bool AutoFormat;
+    float AutoFormatMinimumPsnr;
+    float AutoFormatMinimumSsim;
+
+    bool operator==(const PreviewResultKey& Other) const = default;
+};
+
+class CompressionJobHandle {
+public:
+    CompressionJobHandle();
+    explicit CompressionJobHandle(uint64_t JobId);
+    ~CompressionJobHandle();
+    CompressionJobHandle(const CompressionJobHandle& Other);
+    CompressionJobHandle& operator=(const CompressionJobHandle& Other);
+    CompressionJobHandle(CompressionJobHandle&& Other) noexcept;
+    CompressionJobHandle& operator=(CompressionJobHandle&& Other) noexcept;
+
+public:
+    void Cancel() const;
+    bool IsCancelled() const;
+    bool IsValid() const;
+    uint64_t GetJobId() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> mCancelFlag;
+    uint64_t mJobId;
+};
+
+class CompressedResultCache {
+public:
+    CompressedResultCache();
+    ~CompressedResultCache();
+    CompressedResultCache(const CompressedResultCache& Other);
+    CompressedResultCache& operator=(const CompressedResultCache& Other);
+    CompressedResultCache(CompressedResultCache&& Other) noexcept;
+    CompressedResultCache& operator=(CompressedResultCache&& Other) noexcept;
+
+public:
+    bool TryGet(uint64_t Key, std::shared_ptr<const DirectX::ScratchImage>& ImageOut);
+    bool TryGet(const PreviewResultKey& Key, std::shared_ptr<const DirectX::ScratchImage>& ImageOut);
+    bool Contains(uint64_t Key) const;
+    bool Contains(const PreviewResultKey& Key) const;
+    void Insert(uint64_t Key, std::shared_ptr<const DirectX::ScratchImage> Image);
+    void Insert(const PreviewResultKey& Key, std::shared_ptr<const DirectX::ScratchImage> Image);
+    void SetBudget(size_t BudgetBytes);
+    void Clear();
+    ResultCacheStatistics GetStatistics() const;
+
+private:
+    struct Entry {
+        uint64_t Key;
+        PreviewResultKey Identity;
+        std::shared_ptr<const DirectX::ScratchImage> Image;
+        size_t Bytes;
+    };
+
+    void RebuildIndex();
+    void EvictToBudget();
+
+private:
+    std::list<Entry> mEntries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> mIndex;
+    size_t mBudgetBytes;
+    size_t mResidentBytes;
+    uint64_t mHits;
+    uint64_t mMisses;
+    uint64_t mEvictions;
+};
+
+class SubresourcePager {
+public:
+    SubresourcePager();
+    ~SubresourcePager();
+    SubresourcePager(const SubresourcePager& Other);
+    SubresourcePager& operator=(const SubresourcePager& Other);
+    SubresourcePager(SubresourcePager&& Other) noexcept;
+    SubresourcePager& operator=(SubresourcePager&& Other) noexcept;
+
+public:
+    std::shared_ptr<const DirectX::ScratchImage> Acquire(uint64_t PageIndex, const DirectX::Image& Source);
+    void SetBudget(size_t BudgetBytes);
+    ResultCacheStatistics GetStatistics() const;
+
+private:
+    mutable std::mutex mMutex;
+    CompressedResultCache mPages;
+};
+
+class DiskResultCache {
+public:
+    DiskResultCache();
+    ~DiskResultCache();
+    DiskResultCache(const DiskResultCache& Other);
+    DiskResultCache& operator=(const DiskResultCache& Other);
+    DiskResultCache(DiskResultCache&& Other) noexcept;
+    DiskResultCache& operator=(DiskResultCache&& Other) noexcept;
+
+public:
+    bool Open(const std::filesystem::path& Directory, size_t BudgetBytes);
+    bool IsOpen() const;
+    bool Contains(uint64_t Key) const;
+    bool TryLoad(uint64_t Key, const DirectX::TexMetadata& Expected, std::shared_ptr<const DirectX::ScratchImage>& ImageOut);
+    bool Store(uint64_t Key, const DirectX::ScratchImage& Image);
+    void SetBudget(size_t BudgetBytes);
+    ResultCacheStatistics GetStatistics() const;
+
+private:
+    std::filesystem::path MakeEntryPath(uint64_t Key) const;
+    void ScanDirectory();
+    void EvictToBudget();
+
+private:
+    mutable std::mutex mMutex;
+    std::filesystem::path mDirectory;
+    size_t mBudgetBytes;
+    size_t mResidentBytes;
+    size_t mEntryCount;
+    uint64_t mHits;
+    uint64_t mMisses;
+    uint64_t mEvictions;
+};
+
+class CompressionPreviewCache {
+public:
+    CompressionPreviewCache();
+    ~CompressionPreviewCache();
+    CompressionPreviewCache(const CompressionPreviewCache& Other);
+    CompressionPreviewCache& operator=(const CompressionPreviewCache& Other);
+    CompressionPreviewCache(CompressionPreviewCache&& Other) noexcept;
+    CompressionPreviewCache& operator=(CompressionPreviewCache&& Other) noexcept;
+
+public:
+    bool Rebuild(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job);
+    bool RebuildRegion(const TextureDocument& Document, const AnalyzerSettings& Settings, const PreviewRegion& Region, const CompressionJobHandle& Job);
+    bool HasCachedResult(const TextureDocument& Document, const AnalyzerSettings& Settings) const;
+    bool SaveAsDds(const std::filesystem::path& OutputPath) const;
+    TextureMemoryMetrics BuildMetrics(const DirectX::TexMetadata& SourceMetadata) const;
+    size_t MeasurePackagedBytes() const;
+    const DirectX::ScratchImage& GetCompressedImage() const;
+    std::shared_ptr<const DirectX::ScratchImage> GetCompressedSnapshot() const;
+    void Publish(std::shared_ptr<const DirectX::ScratchImage> Image, size_t PackagedBytes);
+    void SetResultCacheBudget(size_t BudgetBytes);
+    void SetDiskCache(std::shared_ptr<DiskResultCache> DiskCache);
+    ResultCacheStatistics GetResultCacheStatistics() const;
+    const CompressionTimings& GetLastTimings() const;
+
+private:
+    bool PrepareDecodeStage(const TextureDocument& Document);
+    bool PrepareMipStage(const TextureDocument& Document, const AnalyzerSettings& Settings);
+    bool PrepareCompressStage(const TextureDocument& Document, const AnalyzerSettings& Settings, const CompressionJobHandle& Job);
+    TextureImageView GetDecodedImage(const TextureDocument& Document) const;
+    TextureImageView GetWorkingImage(const TextureDocument& Document) const;
+    uint64_t GetContentHash(const TextureDocument& Document) const;
+
+private:
+    uint64_t mDecodedIdentity;
+    std::shared_ptr<const DirectX::ScratchImage> mDecodedImage;
+    MipStageKey mMipKey;
+    std::shared_ptr<const DirectX::ScratchImage> mMipChain;
+    CompressStageKey mCompressKey;
+    std::shared_ptr<const DirectX::ScratchImage> mCompressedImage;
+    CompressStageKey mRegionKey;
+    CompressionTile mRegionBlocks;
+    std::shared_ptr<const DirectX::ScratchImage> mRegionImage;
+    CompressedResultCache mResultCache;
+    std::shared_ptr<DiskResultCache> mDiskCache;
+    mutable uint64_t mContentHashIdentity;
+    mutable uint64_t mContentHash;
+    mutable std::weak_ptr<const DirectX::ScratchImage> mPackagedImage;
+    mutable size_t mPackagedBytes;
+    TileCompressionEngine mTileEngine;
+    CompressionTimings mLastTimings;
+};
+
+std::vector<FormatOption> BuildCompressionCandidateFormats();
+TextureFileKind DetectTextureFileKind(const std::filesystem::path& FilePath);
+DXGI_FORMAT ResolveSrgbVariant(DXGI_FORMAT Format, bool IsSrgb);
+TEX_COMPRESS_FLAGS BuildCompressFlags(const AnalyzerSettings& Settings);
+TEX_FILTER_FLAGS ResolveMipFilter(const AnalyzerSettings& Settings);
+const BlockEncoder& ResolveBlockEncoder(const AnalyzerSettings& Settings);
+uint32_t ResolveEncoderRefinementPasses(const AnalyzerSettings& Settings);
+float ResolveRdoLambda(const AnalyzerSettings& Settings);
+bool ResolvePreliminarySettings(const AnalyzerSettings& Settings, AnalyzerSettings& PreliminaryOut);
+uint32_t ResolveCompressionThreadCount(const AnalyzerSettings& Settings);
+uint64_t ComputeSettingsHash(const AnalyzerSettings& Settings);
+uint64_t ComputePreviewCacheKey(uint64_t SourceIdentity, const AnalyzerSettings& Settings);
+PreviewResultKey MakePreviewResultKey(uint64_t SourceIdentity, const AnalyzerSettings& Settings);
+bool ShouldOpenLazily(const std::filesystem::path& FilePath);
+bool ComputeFileContentHash(const std::filesystem::path& FilePath, uint64_t& HashOut);
+uint64_t ComputeImageContentHash(const TextureImageView& View);
+uint64_t CountImagePixels(const DirectX::Image* Images, size_t ImageCount);
+size_t CountImageBytes(const DirectX::Image* Images, size_t ImageCount);
+bool MeasureDeflatedSize(const void* Data, size_t Size, size_t& SizeOut);
@@ -0,0 +1,196 @@
+#include "TextureQualityMetrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+    constexpr double MaxPsnrDecibels { 100.0 };
+
+    bool ConvertToFloatImage(const Image& Source, ScratchImage& Destination) {
+        Image Linear { Source };
+        Linear.format = MakeLinear(Source.format);
+        if (IsCompressed(Linear.format)) {
+            return SUCCEEDED(Decompress(Linear, DXGI_FORMAT_R32G32B32A32_FLOAT, Destination));
+        }
+        if (Linear.format == DXGI_FORMAT_R32G32B32A32_FLOAT) {
+            return SUCCEEDED(Destination.InitializeFromImage(Linear));
+        }
+        return SUCCEEDED(Convert(Linear, DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Destination));
+    }
+
+    ErrorMetricPixelFormat SelectMetricPixelFormat(DXGI_FORMAT Format) {
+        const FORMAT_TYPE Type { FormatDataType(Format) };
+        const size_t Bits { BitsPerColor(Format) };
+        if (Type == FORMAT_TYPE_UNORM && Bits > 0 && Bits <= 8) {
+            return ErrorMetricPixelFormat::Rgba8;
+        }
+        if (Type == FORMAT_TYPE_FLOAT && Bits > 0 && Bits <= 16) {
+            return ErrorMetricPixelFormat::Rgba16F;
+        }
+        return ErrorMetricPixelFormat::Rgba32F;
+    }
+
+    DXGI_FORMAT GetMetricDxgiFormat(ErrorMetricPixelFormat Format) {
+        switch (Format) {
+        case ErrorMetricPixelFormat::Rgba8:
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case ErrorMetricPixelFormat::Rgba16F:
+            return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        default:
+            return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        }
+    }
+
+    bool PrepareMetricImage(const Image& Source, ErrorMetricPixelFormat Format, ScratchImage& Storage, ErrorMetricImage& ImageOut) {
+        Image Linear { Source };
+        Linear.format = MakeLinear(Source.format);
+        const DXGI_FORMAT TargetFormat { GetMetricDxgiFormat(Format) };
+        const Image* Prepared { &Linear };
+        if (Linear.format != TargetFormat) {
+            const HRESULT Result { IsCompressed(Linear.format) ? Decompress(Linear, TargetFormat, Storage) : Convert(Linear, TargetFormat, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, Storage) };
+            if (FAILED(Result)) {
+                return false;
+            }
+            Prepared = Storage.GetImage(0, 0, 0);
+        }
+        ImageOut = ErrorMetricImage { Prepared->pixels, Prepared->rowPitch, Prepared->width, Prepared->height, Format };
+        return true;
+    }
+
+    bool ComputeChannelPeaks(const Image& Source, std::array<double, 4>& PeaksOut) {
+        ScratchImage Converted {};
+        if (!ConvertToFloatImage(Source, Converted) || Converted.GetImage(0, 0, 0) == nullptr) {
+            return false;
+        }
+        const Image& Values { *Converted.GetImage(0, 0, 0) };
+        PeaksOut = {};
+        for (size_t Row { 0 }; Row < Values.height; ++Row) {
+            const float* Pixels { reinterpret_cast<const float*>(Values.pixels + Row * Values.rowPitch) };
+            for (size_t Index { 0 }; Index < Values.width * 4; ++Index) {
+                PeaksOut[Index % 4] = std::max(PeaksOut[Index % 4], static_cast<double>(std::fabs(Pixels[Index])));
+            }
+        }
+        return true;
+    }
+}
+
+bool ComputeMipQualityMetrics(const Image& Reference, const Image& Candidate, MipQualityMetrics& MetricsOut) {
+    if (Reference.width != Candidate.width || Reference.height != Candidate.height || Reference.width == 0 || Reference.height == 0) {
+        return false;
+    }
+    const ErrorMetricPixelFormat Format { std::max(SelectMetricPixelFormat(MakeLinear(Reference.format)), SelectMetricPixelFormat(MakeLinear(Candidate.format))) };
+    ScratchImage ReferenceStorage {};
+    ScratchImage CandidateStorage {};
+    ErrorMetricImage ReferenceImage {};
+    ErrorMetricImage CandidateImage {};
+    if (!PrepareMetricImage(Reference, Format, ReferenceStorage, ReferenceImage) || !PrepareMetricImage(Candidate, Format, CandidateStorage, CandidateImage)) {
+        return false;
+    }
+    ErrorMetricResult Result {};
+    if (!ComputeErrorMetrics(ReferenceImage, CandidateImage, ResolveErrorMetricInstructionSet(), Result)) {
+        return false;
+    }
+    MetricsOut.Width = Reference.width;
+    MetricsOut.Height = Reference.height;
+    MetricsOut.Mse = Result.Mse;
+    MetricsOut.Psnr = Result.Psnr;
+    std::array<double, 4> Peaks {};
+    if (Format != ErrorMetricPixelFormat::Rgba8 && ComputeChannelPeaks(Reference, Peaks)) {
+        for (size_t Channel { 0 }; Channel < 4; ++Channel) {
+            MetricsOut.Psnr[Channel] = ComputePsnrFromMse(Result.Mse[Channel], std::max(1.0, Peaks[Channel]));
+        }
+    }
+    MetricsOut.Ssim = Result.Ssim;
+    MetricsOut.ErrorHistogram = Result.Histograms;
+    return true;
+}
+
+bool ComputeTextureQualityReport(const TextureImageView& Source, const TextureImageView& Compressed, TEX_FILTER_FLAGS MipFilter, const CompressionJobHandle& Job, TextureQualityReport& ReportOut) {
+    ReportOut = TextureQualityReport {};
+    if (Source.Images == nullptr || Source.ImageCount == 0 || Compressed.Images == nullptr || Compressed.ImageCount == 0) {
+        return false;
+    }
+    if (Source.Metadata.width != Compressed.Metadata.width || Source.Metadata.height != Compressed.Metadata.height) {
+        return false;
+    }
+    ScopedStageTimer Timer { PipelineStage::QualityMetrics };
+    const size_t SourceMipCount { std::min(Source.Metadata.mipLevels, Source.ImageCount) };
+    const size_t CompressedMipCount { std::min(Compressed.Metadata.mipLevels, Compressed.ImageCount) };
+    ScratchImage GeneratedMips {};
+    if (CompressedMipCount > SourceMipCount && SourceMipCount == 1) {
+        ScratchImage BaseFloat {};
+        const TEX_FILTER_FLAGS Filter { IsSRGB(Source.Metadata.format) ? static_cast<TEX_FILTER_FLAGS>(MipFilter | TEX_FILTER_SRGB) : MipFilter };
+        if (!ConvertToFloatImage(Source.Images[0], BaseFloat) || FAILED(GenerateMipMaps(*BaseFloat.GetImage(0, 0, 0), Filter, CompressedMipCount, GeneratedMips))) {
+            return false;
+        }
+    }
+    const size_t MipCount { GeneratedMips.GetImageCount() > 0 ? std::min(CompressedMipCount, GeneratedMips.GetImageCount()) : std::min(CompressedMipCount, SourceMipCount) };
+
+    uint64_t Pixels { 0 };
+    ReportOut.Mips.reserve(MipCount);
+    for (size_t Mip { 0 }; Mip < MipCount; ++Mip) {
+        if (Job.IsCancelled()) {
+            ReportOut = TextureQualityReport {};
+            return false;
+        }
+        const Image& Reference { GeneratedMips.GetImageCount() > 0 ? *GeneratedMips.GetImage(Mip, 0, 0) : Source.Images[Mip] };
+        MipQualityMetrics Metrics {};
+        if (!ComputeMipQualityMetrics(Reference, Compressed.Images[Mip], Metrics)) {
+            ReportOut = TextureQualityReport {};
+            return false;
+        }
+        Metrics.MipLevel = Mip;
+        Pixels += static_cast<uint64_t>(Metrics.Width) * static_cast<uint64_t>(Metrics.Height);
+        ReportOut.Mips.push_back(Metrics);
+    }
+    ReportOut.ComputeMilliseconds = Timer.GetElapsedMilliseconds();
+    ReportOut.InstructionSet = ResolveErrorMetricInstructionSet();
+    Timer.MarkCompleted(Pixels, 0);
+    return !ReportOut.Mips.empty();
+}
+
+bool PrepareDifferenceImages(const Image& Reference, const Image& Candidate, DifferenceMetricImages& ImagesOut) {
+    if (Reference.width != Candidate.width || Reference.height != Candidate.height || Reference.width == 0 || Reference.height == 0) {
+        return false;
+    }
+    const ErrorMetricPixelFormat Format { std::max(SelectMetricPixelFormat(MakeLinear(Reference.format)), SelectMetricPixelFormat(MakeLinear(Candidate.format))) };
+    return PrepareMetricImage(Reference, Format, ImagesOut.ReferenceStorage, ImagesOut.Reference) && PrepareMetricImage(Candidate, Format, ImagesOut.CandidateStorage, ImagesOut.Candidate);
+}
+
+bool ComputeDifferenceHeatmap(const DifferenceMetricImages& Images, float Gain, const PreviewRegion& Region, ScratchImage& HeatmapOut) {
+    const ErrorMetricImage& Reference { Images.Reference };
+    const ErrorMetricImage& Candidate { Images.Candidate };
+    if (Reference.Pixels == nullptr || Candidate.Pixels == nullptr || Reference.Width != Candidate.Width || Reference.Height != Candidate.Height || Reference.Format != Candidate.Format) {
+        return false;
+    }
+    const size_t Right { std::min(Region.Right, Reference.Width) };
+    const size_t Bottom { std::min(Region.Bottom, Reference.Height) };
+    if (Region.Left >= Right || Region.Top >= Bottom) {
+        return false;
+    }
+    if (FAILED(HeatmapOut.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, Reference.Width, Reference.Height, 1, 1))) {
+        return false;
+    }
+    memset(HeatmapOut.GetPixels(), 0, HeatmapOut.GetPixelsSize());
+    const Image& Target { *HeatmapOut.GetImage(0, 0, 0) };
+    const size_t MetricPixelBytes { GetErrorMetricBytesPerPixel(Reference.Format) };
+    const size_t Width { Right - Region.Left };
+    const size_t Height { Bottom - Region.Top };
+    const ErrorMetricImage ReferenceRegion { Reference.Pixels + Region.Top * Reference.RowPitch + Region.Left * MetricPixelBytes, Reference.RowPitch, Width, Height, Reference.Format };
+    const ErrorMetricImage CandidateRegion { Candidate.Pixels + Region.Top * Candidate.RowPitch + Region.Left * MetricPixelBytes, Candidate.RowPitch, Width, Height, Candidate.Format };
+    return ComputeDifferenceImage(ReferenceRegion, CandidateRegion, Gain, ResolveErrorMetricInstructionSet(), Target.pixels + Region.Top * Target.rowPitch + Region.Left * 4, Target.rowPitch);
+}
+
+double ComputePsnrFromMse(double Mse) {
+    return ComputePsnrFromMse(Mse, 1.0);
+}
+
+double ComputePsnrFromMse(double Mse, double Peak) {
+    if (Mse <= 0.0) {
+        return MaxPsnrDecibels;
+    }
+    return std::min(MaxPsnrDecibels, 10.0 * std::log10(Peak * Peak / Mse));
+}
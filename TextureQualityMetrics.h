@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <DirectXTex.h>
+
+#include "ErrorMetricKernels.h"
+#include "TextureCompressionCore.h"
+
+struct MipQualityMetrics {
+    size_t MipLevel;
+    size_t Width;
+    size_t Height;
+    std::array<double, 4> Mse;
+    std::array<double, 4> Psnr;
+    std::array<double, 4> Ssim;
+    std::array<uint32_t, ErrorHistogramBinCount * 4> ErrorHistogram;
+};
+
+struct DifferenceMetricImages {
+    DirectX::ScratchImage ReferenceStorage;
+    DirectX::ScratchImage CandidateStorage;
+    ErrorMetricImage Reference;
+    ErrorMetricImage Candidate;
+};
+
+struct TextureQualityReport {
+    std::vector<MipQualityMetrics> Mips;
+    double ComputeMilliseconds;
+    SimdInstructionSet InstructionSet;
+};
+
+bool ComputeMipQualityMetrics(const DirectX::Image& Reference, const DirectX::Image& Candidate, MipQualityMetrics& MetricsOut);
+bool ComputeTextureQualityReport(const TextureImageView& Source, const TextureImageView& Compressed, TEX_FILTER_FLAGS MipFilter, const CompressionJobHandle& Job, TextureQualityReport& ReportOut);
+bool PrepareDifferenceImages(const DirectX::Image& Reference, const DirectX::Image& Candidate, DifferenceMetricImages& ImagesOut);
+bool ComputeDifferenceHeatmap(const DifferenceMetricImages& Images, float Gain, const PreviewRegion& Region, DirectX::ScratchImage& HeatmapOut);
+double ComputePsnrFromMse(double Mse);
+double ComputePsnrFromMse(double Mse, double Peak);
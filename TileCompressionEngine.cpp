@@ -0,0 +1,426 @@
+#include "TileCompressionEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace {
+    constexpr size_t DefaultBlocksPerTile { 4096 };
+    constexpr size_t BlockDimension { 4 };
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool() :
+    mThreads {},
+    mQueues {},
+    mMutex {},
+    mWakeCondition {},
+    mDoneCondition {},
+    mTask { nullptr },
+    mRemainingTasks { 0 },
+    mStolenTasks { 0 },
+    mFailed { false },
+    mBatchGeneration { 0 },
+    mActiveWorkers { 0 },
+    mStopRequested { false } {
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    StopWorkers();
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const WorkStealingThreadPool& Other) :
+    WorkStealingThreadPool {} {
+    (void)Other;
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::operator=(const WorkStealingThreadPool& Other) {
+    (void)Other;
+    return *this;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(WorkStealingThreadPool&& Other) noexcept :
+    WorkStealingThreadPool {} {
+    (void)Other;
+}
+
+WorkStealingThreadPool& WorkStealingThreadPool::operator=(WorkStealingThreadPool&& Other) noexcept {
+    (void)Other;
+    return *this;
+}
+
+void WorkStealingThreadPool::Resize(uint32_t WorkerCount) {
+    const uint32_t ClampedCount { std::max(1u, WorkerCount) };
+    if (ClampedCount == mQueues.size()) {
+        return;
+    }
+    StopWorkers();
+    StartWorkers(ClampedCount);
+}
+
+uint32_t WorkStealingThreadPool::GetWorkerCount() const {
+    return static_cast<uint32_t>(mQueues.size());
+}
+
+bool WorkStealingThreadPool::Run(size_t TaskCount, const Task& Function, size_t& StolenCountOut) {
+    StolenCountOut = 0;
+    if (TaskCount == 0) {
+        return true;
+    }
+    if (mQueues.empty()) {
+        StartWorkers(1);
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        mTask = &Function;
+        mFailed.store(false);
+        mStolenTasks.store(0);
+        mRemainingTasks.store(TaskCount);
+        const size_t QueueCount { mQueues.size() };
+        for (size_t TaskIndex { 0 }; TaskIndex < TaskCount; ++TaskIndex) {
+            WorkerQueue& Queue { *mQueues[TaskIndex % QueueCount] };
+            std::lock_guard<std::mutex> QueueLock { Queue.Mutex };
+            Queue.Tasks.push_back(TaskIndex);
+        }
+        ++mBatchGeneration;
+    }
+    mWakeCondition.notify_all();
+
+    ExecuteBatch(0);
+
+    {
+        std::unique_lock<std::mutex> Lock { mMutex };
+        mDoneCondition.wait(Lock, [this] { return mRemainingTasks.load() == 0 && mActiveWorkers == 0; });
+        mTask = nullptr;
+    }
+    StolenCountOut = mStolenTasks.load();
+    return !mFailed.load();
+}
+
+void WorkStealingThreadPool::StartWorkers(uint32_t WorkerCount) {
+    mStopRequested = false;
+    mQueues.clear();
+    for (uint32_t Index { 0 }; Index < WorkerCount; ++Index) {
+        mQueues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (uint32_t Index { 1 }; Index < WorkerCount; ++Index) {
+        mThreads.emplace_back(&WorkStealingThreadPool::WorkerLoop, this, Index);
+    }
+}
+
+void WorkStealingThreadPool::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> Lock { mMutex };
+        mStopRequested = true;
+    }
+    mWakeCondition.notify_all();
+    for (std::thread& Thread : mThreads) {
+        if (Thread.joinable()) {
+            Thread.join();
+        }
+    }
+    mThreads.clear();
+    mQueues.clear();
+}
+
+void WorkStealingThreadPool::WorkerLoop(uint32_t WorkerIndex) {
+    std::unique_lock<std::mutex> Lock { mMutex };
+    uint64_t SeenGeneration { mBatchGeneration };
+    while (true) {
+        mWakeCondition.wait(Lock, [this, &SeenGeneration] { return mStopRequested || mBatchGeneration != SeenGeneration; });
+        if (mStopRequested) {
+            return;
+        }
+        SeenGeneration = mBatchGeneration;
+        ++mActiveWorkers;
+        Lock.unlock();
+
+        ExecuteBatch(WorkerIndex);
+
+        Lock.lock();
+        --mActiveWorkers;
+        mDoneCondition.notify_all();
+    }
+}
+
+void WorkStealingThreadPool::ExecuteBatch(uint32_t WorkerIndex) {
+    size_t TaskIndex { 0 };
+    while (PopLocal(WorkerIndex, TaskIndex) || Steal(WorkerIndex, TaskIndex)) {
+        if (!mFailed.load(std::memory_order_relaxed)) {
+            if (!(*mTask)(TaskIndex, WorkerIndex)) {
+                mFailed.store(true);
+            }
+        }
+        if (mRemainingTasks.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> Lock { mMutex };
+            mDoneCondition.notify_all();
+        }
+    }
+}
+
+bool WorkStealingThreadPool::PopLocal(uint32_t WorkerIndex, size_t& TaskOut) {
+    WorkerQueue& Queue { *mQueues[WorkerIndex] };
+    std::lock_guard<std::mutex> Lock { Queue.Mutex };
+    if (Queue.Tasks.empty()) {
+        return false;
+    }
+    TaskOut = Queue.Tasks.front();
+    Queue.Tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingThreadPool::Steal(uint32_t WorkerIndex, size_t& TaskOut) {
+    const size_t QueueCount { mQueues.size() };
+    for (size_t Offset { 1 }; Offset < QueueCount; ++Offset) {
+        WorkerQueue& Victim { *mQueues[(WorkerIndex + Offset) % QueueCount] };
+        std::lock_guard<std::mutex> Lock { Victim.Mutex };
+        if (Victim.Tasks.empty()) {
+            continue;
+        }
+        TaskOut = Victim.Tasks.back();
+        Victim.Tasks.pop_back();
+        mStolenTasks.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+TileCompressionEngine::TileCompressionEngine() :
+    mPool {},
+    mTileTimings {},
+    mStatistics {} {
+}
+
+TileCompressionEngine::~TileCompressionEngine() {
+}
+
+TileCompressionEngine::TileCompressionEngine(const TileCompressionEngine& Other) :
+    mPool {},
+    mTileTimings { Other.mTileTimings },
+    mStatistics { Other.mStatistics } {
+}
+
+TileCompressionEngine& TileCompressionEngine::operator=(const TileCompressionEngine& Other) {
+    if (this != &Other) {
+        mTileTimings = Other.mTileTimings;
+        mStatistics = Other.mStatistics;
+    }
+    return *this;
+}
+
+TileCompressionEngine::TileCompressionEngine(TileCompressionEngine&& Other) noexcept :
+    mPool {},
+    mTileTimings { std::move(Other.mTileTimings) },
+    mStatistics { Other.mStatistics } {
+}
+
+TileCompressionEngine& TileCompressionEngine::operator=(TileCompressionEngine&& Other) noexcept {
+    if (this != &Other) {
+        mTileTimings = std::move(Other.mTileTimings);
+        mStatistics = Other.mStatistics;
+    }
+    return *this;
+}
+
+bool TileCompressionEngine::Compress(const Image* Images, size_t ImageCount, const TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const std::function<bool()>& IsCancelled, ScratchImage& Output) {
+    return CompressTiles(Images, ImageCount, Metadata, Format, Encoder, Options, RefinementPasses, RdoLambda, ThreadCount, nullptr, CompressionTile {}, IsCancelled, Output);
+}
+
+bool TileCompressionEngine::CompressReusingRegion(const Image* Images, size_t ImageCount, const TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const Image& EncodedRegion, const CompressionTile& Region, const std::function<bool()>& IsCancelled, ScratchImage& Output) {
+    return CompressTiles(Images, ImageCount, Metadata, Format, Encoder, Options, RefinementPasses, RdoLambda, ThreadCount, &EncodedRegion, Region, IsCancelled, Output);
+}
+
+bool TileCompressionEngine::CompressRegion(const Image& Source, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const CompressionTile& Region, const std::function<bool()>& IsCancelled, ScratchImage& Output) {
+    mTileTimings.clear();
+    mStatistics = TileCompressionStatistics { 0, 0, 0, 0.0, 0.0 };
+    if (Source.pixels == nullptr || !Encoder.SupportsFormat(Format) || IsCompressed(Source.format) || Region.BlockColumnCount == 0 || Region.BlockRowCount == 0) {
+        return false;
+    }
+
+    ScratchImage Result {};
+    const HRESULT InitHr { Result.Initialize2D(Format, Source.width, Source.height, 1, 1) };
+    if (FAILED(InitHr)) {
+        return false;
+    }
+    memset(Result.GetPixels(), 0, Result.GetPixelsSize());
+
+    const size_t BlockColumns { (Source.width + BlockDimension - 1) / BlockDimension };
+    const size_t BlockRows { (Source.height + BlockDimension - 1) / BlockDimension };
+    if (Region.BlockColumnBegin >= BlockColumns || Region.BlockRowBegin >= BlockRows) {
+        return false;
+    }
+    const CompressionTile ClampedRegion { 0, Region.BlockColumnBegin, std::min(Region.BlockColumnCount, BlockColumns - Region.BlockColumnBegin), Region.BlockRowBegin, std::min(Region.BlockRowCount, BlockRows - Region.BlockRowBegin) };
+    const std::vector<CompressionTile> Tiles { BuildRegionTiles(ClampedRegion, DefaultBlocksPerTile / 4) };
+    if (!EncodeTiles(&Source, Result.GetImages(), Tiles, Format, Encoder, Options, RefinementPasses, RdoLambda, ThreadCount, IsCancelled)) {
+        return false;
+    }
+    Output = std::move(Result);
+    return true;
+}
+
+bool TileCompressionEngine::CompressTiles(const Image* Images, size_t ImageCount, const TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const Image* EncodedRegion, const CompressionTile& Region, const std::function<bool()>& IsCancelled, ScratchImage& Output) {
+    mTileTimings.clear();
+    mStatistics = TileCompressionStatistics { 0, 0, 0, 0.0, 0.0 };
+    if (Images == nullptr || ImageCount == 0 || !Encoder.SupportsFormat(Format) || IsCompressed(Metadata.format)) {
+        return false;
+    }
+
+    TexMetadata OutputMetadata { Metadata };
+    OutputMetadata.format = Format;
+    ScratchImage Result {};
+    const HRESULT InitHr { Result.Initialize(OutputMetadata) };
+    if (FAILED(InitHr) || Result.GetImageCount() != ImageCount) {
+        return false;
+    }
+
+    std::vector<CompressionTile> Tiles { BuildTiles(Images, ImageCount, DefaultBlocksPerTile) };
+    const Image* Target { EncodedRegion != nullptr && Region.ImageIndex < ImageCount ? &Result.GetImages()[Region.ImageIndex] : nullptr };
+    const size_t BlockColumns { Target != nullptr ? (Target->width + BlockDimension - 1) / BlockDimension : 0 };
+    const size_t BlockRows { Target != nullptr ? (Target->height + BlockDimension - 1) / BlockDimension : 0 };
+    if (Target != nullptr && EncodedRegion->format == Format && EncodedRegion->width == Target->width && EncodedRegion->height == Target->height && EncodedRegion->rowPitch == Target->rowPitch &&
+        Region.BlockColumnBegin + Region.BlockColumnCount <= BlockColumns && Region.BlockRowBegin + Region.BlockRowCount <= BlockRows) {
+        const size_t BlockBytes { Target->rowPitch / BlockColumns };
+        for (size_t BlockRow { Region.BlockRowBegin }; BlockRow < Region.BlockRowBegin + Region.BlockRowCount; ++BlockRow) {
+            const size_t Offset { BlockRow * Target->rowPitch + Region.BlockColumnBegin * BlockBytes };
+            memcpy(Target->pixels + Offset, EncodedRegion->pixels + Offset, Region.BlockColumnCount * BlockBytes);
+        }
+        Tiles = ExcludeRegion(Tiles, Region);
+    }
+    if (!EncodeTiles(Images, Result.GetImages(), Tiles, Format, Encoder, Options, RefinementPasses, RdoLambda, ThreadCount, IsCancelled)) {
+        return false;
+    }
+    Output = std::move(Result);
+    return true;
+}
+
+bool TileCompressionEngine::EncodeTiles(const Image* Images, const Image* OutputImages, const std::vector<CompressionTile>& Tiles, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const std::function<bool()>& IsCancelled) {
+    CompressOptions TileOptions { Options };
+    TileOptions.flags = TileOptions.flags & ~TEX_COMPRESS_PARALLEL;
+    mTileTimings.assign(Tiles.size(), TileTiming {});
+    mPool.Resize(ThreadCount);
+
+    const std::chrono::steady_clock::time_point Start { std::chrono::steady_clock::now() };
+    size_t StolenCount { 0 };
+    const bool Encoded { mPool.Run(Tiles.size(), [&](size_t TileIndex, uint32_t WorkerIndex) {
+        if (IsCancelled && IsCancelled()) {
+            return false;
+        }
+        const CompressionTile& Tile { Tiles[TileIndex] };
+        const std::chrono::steady_clock::time_point TileStart { std::chrono::steady_clock::now() };
+        const bool Succeeded { EncodeTile(Images[Tile.ImageIndex], OutputImages[Tile.ImageIndex], Tile, Format, Encoder, TileOptions, RefinementPasses, RdoLambda) };
+        const double Microseconds { std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - TileStart).count() };
+        mTileTimings[TileIndex] = TileTiming { Tile, WorkerIndex, Microseconds };
+        return Succeeded;
+    }, StolenCount) };
+
+    mStatistics.TileCount = Tiles.size();
+    mStatistics.StolenTileCount = StolenCount;
+    mStatistics.WorkerCount = mPool.GetWorkerCount();
+    mStatistics.WallMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    for (const TileTiming& Timing : mTileTimings) {
+        mStatistics.SlowestTileMilliseconds = std::max(mStatistics.SlowestTileMilliseconds, Timing.Microseconds / 1000.0);
+    }
+    return Encoded;
+}
+
+const std::vector<TileTiming>& TileCompressionEngine::GetTileTimings() const {
+    return mTileTimings;
+}
+
+const TileCompressionStatistics& TileCompressionEngine::GetStatistics() const {
+    return mStatistics;
+}
+
+std::vector<CompressionTile> TileCompressionEngine::BuildTiles(const Image* Images, size_t ImageCount, size_t TargetBlocksPerTile) {
+    std::vector<CompressionTile> Tiles {};
+    for (size_t ImageIndex { 0 }; ImageIndex < ImageCount; ++ImageIndex) {
+        const Image& Source { Images[ImageIndex] };
+        if (Source.width == 0 || Source.height == 0) {
+            continue;
+        }
+        const size_t BlockColumns { (Source.width + BlockDimension - 1) / BlockDimension };
+        const size_t BlockRows { (Source.height + BlockDimension - 1) / BlockDimension };
+        const size_t RowsPerTile { std::max<size_t>(1, TargetBlocksPerTile / BlockColumns) };
+        for (size_t BlockRow { 0 }; BlockRow < BlockRows; BlockRow += RowsPerTile) {
+            Tiles.push_back(CompressionTile { ImageIndex, 0, BlockColumns, BlockRow, std::min(RowsPerTile, BlockRows - BlockRow) });
+        }
+    }
+    std::stable_sort(Tiles.begin(), Tiles.end(), [](const CompressionTile& Left, const CompressionTile& Right) {
+        return Left.BlockColumnCount * Left.BlockRowCount > Right.BlockColumnCount * Right.BlockRowCount;
+    });
+    return Tiles;
+}
+
+std::vector<CompressionTile> TileCompressionEngine::BuildRegionTiles(const CompressionTile& Region, size_t TargetBlocksPerTile) {
+    std::vector<CompressionTile> Tiles {};
+    if (Region.BlockColumnCount == 0 || Region.BlockRowCount == 0) {
+        return Tiles;
+    }
+    const size_t RowsPerTile { std::max<size_t>(1, TargetBlocksPerTile / Region.BlockColumnCount) };
+    for (size_t BlockRow { 0 }; BlockRow < Region.BlockRowCount; BlockRow += RowsPerTile) {
+        Tiles.push_back(CompressionTile { Region.ImageIndex, Region.BlockColumnBegin, Region.BlockColumnCount, Region.BlockRowBegin + BlockRow, std::min(RowsPerTile, Region.BlockRowCount - BlockRow) });
+    }
+    return Tiles;
+}
+
+std::vector<CompressionTile> TileCompressionEngine::ExcludeRegion(const std::vector<CompressionTile>& Tiles, const CompressionTile& Region) {
+    std::vector<CompressionTile> Remaining {};
+    const size_t RegionColumnEnd { Region.BlockColumnBegin + Region.BlockColumnCount };
+    const size_t RegionRowEnd { Region.BlockRowBegin + Region.BlockRowCount };
+    for (const CompressionTile& Tile : Tiles) {
+        const size_t TileColumnEnd { Tile.BlockColumnBegin + Tile.BlockColumnCount };
+        const size_t TileRowEnd { Tile.BlockRowBegin + Tile.BlockRowCount };
+        const size_t OverlapColumnBegin { std::max(Tile.BlockColumnBegin, Region.BlockColumnBegin) };
+        const size_t OverlapColumnEnd { std::min(TileColumnEnd, RegionColumnEnd) };
+        const size_t OverlapRowBegin { std::max(Tile.BlockRowBegin, Region.BlockRowBegin) };
+        const size_t OverlapRowEnd { std::min(TileRowEnd, RegionRowEnd) };
+        if (Tile.ImageIndex != Region.ImageIndex || OverlapColumnBegin >= OverlapColumnEnd || OverlapRowBegin >= OverlapRowEnd) {
+            Remaining.push_back(Tile);
+            continue;
+        }
+        if (Tile.BlockRowBegin < OverlapRowBegin) {
+            Remaining.push_back(CompressionTile { Tile.ImageIndex, Tile.BlockColumnBegin, Tile.BlockColumnCount, Tile.BlockRowBegin, OverlapRowBegin - Tile.BlockRowBegin });
+        }
+        if (Tile.BlockColumnBegin < OverlapColumnBegin) {
+            Remaining.push_back(CompressionTile { Tile.ImageIndex, Tile.BlockColumnBegin, OverlapColumnBegin - Tile.BlockColumnBegin, OverlapRowBegin, OverlapRowEnd - OverlapRowBegin });
+        }
+        if (OverlapColumnEnd < TileColumnEnd) {
+            Remaining.push_back(CompressionTile { Tile.ImageIndex, OverlapColumnEnd, TileColumnEnd - OverlapColumnEnd, OverlapRowBegin, OverlapRowEnd - OverlapRowBegin });
+        }
+        if (OverlapRowEnd < TileRowEnd) {
+            Remaining.push_back(CompressionTile { Tile.ImageIndex, Tile.BlockColumnBegin, Tile.BlockColumnCount, OverlapRowEnd, TileRowEnd - OverlapRowEnd });
+        }
+    }
+    std::stable_sort(Remaining.begin(), Remaining.end(), [](const CompressionTile& Left, const CompressionTile& Right) {
+        return Left.BlockColumnCount * Left.BlockRowCount > Right.BlockColumnCount * Right.BlockRowCount;
+    });
+    return Remaining;
+}
+
+bool TileCompressionEngine::EncodeTile(const Image& Source, const Image& Destination, const CompressionTile& Tile, DXGI_FORMAT Format, const BlockEncoder& Encoder, const CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda) {
+    const size_t PixelX { Tile.BlockColumnBegin * BlockDimension };
+    const size_t PixelY { Tile.BlockRowBegin * BlockDimension };
+    const size_t BytesPerPixel { BitsPerPixel(Source.format) / 8 };
+    if (PixelX >= Source.width || PixelY >= Source.height || BytesPerPixel == 0) {
+        return false;
+    }
+
+    size_t BlockBytes { 0 };
+    size_t BlockSliceBytes { 0 };
+    if (FAILED(ComputePitch(Format, BlockDimension, BlockDimension, BlockBytes, BlockSliceBytes))) {
+        return false;
+    }
+    const size_t DestinationOffset { Tile.BlockColumnBegin * BlockBytes };
+    if (DestinationOffset >= Destination.rowPitch) {
+        return false;
+    }
+
+    const size_t Width { std::min(Tile.BlockColumnCount * BlockDimension, Source.width - PixelX) };
+    const size_t Height { std::min(Tile.BlockRowCount * BlockDimension, Source.height - PixelY) };
+    const size_t BlockRows { (Height + BlockDimension - 1) / BlockDimension };
+    const Image Region { Width, Height, Source.format, Source.rowPitch, Source.rowPitch * Height, Source.pixels + PixelY * Source.rowPitch + PixelX * BytesPerPixel };
+    const Image Target { Width, Height, Format, Destination.rowPitch, Destination.rowPitch * BlockRows, Destination.pixels + Tile.BlockRowBegin * Destination.rowPitch + DestinationOffset };
+    return Encoder.EncodeImage(Region, Target, Options, RefinementPasses, RdoLambda);
+}
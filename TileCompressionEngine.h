@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <DirectXTex.h>
+
+#include "BlockCompressionEncoder.h"
+
+struct CompressionTile {
+    size_t ImageIndex;
+    size_t BlockColumnBegin;
+    size_t BlockColumnCount;
+    size_t BlockRowBegin;
+    size_t BlockRowCount;
+};
+
+struct TileTiming {
+    CompressionTile Tile;
+    uint32_t WorkerIndex;
+    double Microseconds;
+};
+
+struct TileCompressionStatistics {
+    size_t TileCount;
+    size_t StolenTileCount;
+    uint32_t WorkerCount;
+    double WallMilliseconds;
+    double SlowestTileMilliseconds;
+};
+
+class WorkStealingThreadPool {
+public:
+    using Task = std::function<bool(size_t TaskIndex, uint32_t WorkerIndex)>;
+
+public:
+    WorkStealingThreadPool();
+    ~WorkStealingThreadPool();
+    WorkStealingThreadPool(const WorkStealingThreadPool& Other);
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool& Other);
+    WorkStealingThreadPool(WorkStealingThreadPool&& Other) noexcept;
+    WorkStealingThreadPool& operator=(WorkStealingThreadPool&& Other) noexcept;
+
+public:
+    void Resize(uint32_t WorkerCount);
+    uint32_t GetWorkerCount() const;
+    bool Run(size_t TaskCount, const Task& Function, size_t& StolenCountOut);
+
+private:
+    struct WorkerQueue {
+        std::mutex Mutex;
+        std::deque<size_t> Tasks;
+    };
+
+    void StartWorkers(uint32_t WorkerCount);
+    void StopWorkers();
+    void WorkerLoop(uint32_t WorkerIndex);
+    void ExecuteBatch(uint32_t WorkerIndex);
+    bool PopLocal(uint32_t WorkerIndex, size_t& TaskOut);
+    bool Steal(uint32_t WorkerIndex, size_t& TaskOut);
+
+private:
+    std::vector<std::thread> mThreads;
+    std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+    std::mutex mMutex;
+    std::condition_variable mWakeCondition;
+    std::condition_variable mDoneCondition;
+    const Task* mTask;
+    std::atomic<size_t> mRemainingTasks;
+    std::atomic<size_t> mStolenTasks;
+    std::atomic<bool> mFailed;
+    uint64_t mBatchGeneration;
+    uint32_t mActiveWorkers;
+    bool mStopRequested;
+};
+
+class TileCompressionEngine {
+public:
+    TileCompressionEngine();
+    ~TileCompressionEngine();
+    TileCompressionEngine(const TileCompressionEngine& Other);
+    TileCompressionEngine& operator=(const TileCompressionEngine& Other);
+    TileCompressionEngine(TileCompressionEngine&& Other) noexcept;
+    TileCompressionEngine& operator=(TileCompressionEngine&& Other) noexcept;
+
+public:
+    bool Compress(const DirectX::Image* Images, size_t ImageCount, const DirectX::TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const std::function<bool()>& IsCancelled, DirectX::ScratchImage& Output);
+    bool CompressReusingRegion(const DirectX::Image* Images, size_t ImageCount, const DirectX::TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const DirectX::Image& EncodedRegion, const CompressionTile& Region, const std::function<bool()>& IsCancelled, DirectX::ScratchImage& Output);
+    bool CompressRegion(const DirectX::Image& Source, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const CompressionTile& Region, const std::function<bool()>& IsCancelled, DirectX::ScratchImage& Output);
+    const std::vector<TileTiming>& GetTileTimings() const;
+    const TileCompressionStatistics& GetStatistics() const;
+
+    static std::vector<CompressionTile> BuildTiles(const DirectX::Image* Images, size_t ImageCount, size_t TargetBlocksPerTile);
+    static std::vector<CompressionTile> BuildRegionTiles(const CompressionTile& Region, size_t TargetBlocksPerTile);
+    static std::vector<CompressionTile> ExcludeRegion(const std::vector<CompressionTile>& Tiles, const CompressionTile& Region);
+
+private:
+    bool CompressTiles(const DirectX::Image* Images, size_t ImageCount, const DirectX::TexMetadata& Metadata, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const DirectX::Image* EncodedRegion, const CompressionTile& Region, const std::function<bool()>& IsCancelled, DirectX::ScratchImage& Output);
+    bool EncodeTiles(const DirectX::Image* Images, const DirectX::Image* OutputImages, const std::vector<CompressionTile>& Tiles, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda, uint32_t ThreadCount, const std::function<bool()>& IsCancelled);
+    static bool EncodeTile(const DirectX::Image& Source, const DirectX::Image& Destination, const CompressionTile& Tile, DXGI_FORMAT Format, const BlockEncoder& Encoder, const DirectX::CompressOptions& Options, uint32_t RefinementPasses, float RdoLambda);
+
+private:
+    WorkStealingThreadPool mPool;
+    std::vector<TileTiming> mTileTimings;
+    TileCompressionStatistics mStatistics;
+};